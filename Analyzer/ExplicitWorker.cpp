@@ -0,0 +1,282 @@
+// explicit_worker: runs one engine of reachable_marking_BFS_DFS on a net
+// read from stdin (the text form written by JobPool) and prints
+// "Key: value" lines. Started by petri_analyze; the explicit engine has its
+// own PetriNet class, so it cannot share a binary with the PNML parser.
+#include "PetriNet.h"
+#include "BFS.h"
+#include "DFS.h"
+#include "Bounded.h"
+#include "Checkpoint.h"
+#include "Coverability.h"
+#include "Distributed.h"
+#include "ExternalBFS.h"
+#include "KernelBench.h"
+#include "Liveness.h"
+#include "ReachabilityGraph.h"
+#include "Simulation.h"
+#include "StateStore.h"
+#include "Swarm.h"
+#include "Sweepline.h"
+#include "Symmetry.h"
+#include "Unfolding.h"
+#include "../PNML_Parser/Progress.h"
+#include "../PNML_Parser/Trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+static bool read_net(std::istream& in, PetriNet& pn) {
+    int P, T;
+    if (!(in >> P >> T) || P < 0 || T < 0) return false;
+    Marking M0(P);
+    for (int& v : M0) if (!(in >> v)) return false;
+    // places x transitions, the orientation compile_net prefers
+    std::vector<std::vector<int>> I(P, std::vector<int>(T, 0)), O = I;
+    for (int t = 0; t < T; ++t) {
+        int n, p;
+        if (!(in >> n)) return false;
+        for (int k = 0; k < n; ++k) { if (!(in >> p) || p < 0 || p >= P) return false; I[p][t]++; }
+        if (!(in >> n)) return false;
+        for (int k = 0; k < n; ++k) { if (!(in >> p) || p < 0 || p >= P) return false; O[p][t]++; }
+    }
+    pn = PetriNet(M0, I, O);
+    return true;
+}
+
+static void print_exploration(const ExplorationStats& s) {
+    std::cout << "States: " << s.states << "\n"
+              << "Edges: " << s.edges << "\n"
+              << "Deadlocks: " << s.deadlocks << "\n"
+              << "Omission probability: " << s.omission_probability << "\n";
+}
+
+static int run_engine(const std::string& engine, const PetriNet& pn, int argc, char* argv[]) {
+    int bound = 1;
+    size_t memory_bytes = size_t(64) << 20;
+    std::string work_dir = ".", output, checkpoint, weights;
+    double checkpoint_seconds = 60;
+    bool resume = false;
+    int processes = 4;
+    for (int i = 2; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--resume") == 0) resume = true;
+        else if (!has_value) break;
+        else if (std::strcmp(argv[i], "--bound") == 0) bound = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--store-mb") == 0) memory_bytes = (size_t)std::atol(argv[++i]) << 20;
+        else if (std::strcmp(argv[i], "--work-dir") == 0) work_dir = argv[++i];
+        else if (std::strcmp(argv[i], "--output") == 0) output = argv[++i];
+        else if (std::strcmp(argv[i], "--checkpoint") == 0) checkpoint = argv[++i];
+        else if (std::strcmp(argv[i], "--checkpoint-every") == 0) checkpoint_seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--weights") == 0) weights = argv[++i];
+        else if (std::strcmp(argv[i], "--processes") == 0) processes = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--trace") == 0 || std::strcmp(argv[i], "--progress") == 0) ++i; // main
+    }
+
+    if (engine == "bfs") {
+        ExactStore store;
+        print_exploration(bfs_reachable(pn, store));
+    }
+    else if (engine == "dfs") {
+        ExactStore store;
+        print_exploration(dfs_reachable(pn, store));
+    }
+    else if (engine == "hashcompact" || engine == "bitstate" || engine == "tree") {
+        StoreMode mode = engine == "hashcompact" ? StoreMode::HashCompaction
+                       : engine == "bitstate" ? StoreMode::Bitstate : StoreMode::Tree;
+        auto store = make_state_store(mode, memory_bytes, (int)pn.M0.size());
+        print_exploration(bfs_reachable(pn, *store));
+    }
+    else if (engine == "bounded") {
+        BoundedStats s = bounded_reachable(pn, bound);
+        std::cout << "States: " << s.states << "\n"
+                  << "Edges: " << s.edges << "\n"
+                  << "Deadlocks: " << s.deadlocks << "\n"
+                  << "Bits per place: " << s.bits_per_place << "\n"
+                  << "Overflow firings: " << s.overflow_firings << "\n";
+    }
+    else if (engine == "coverability") {
+        CoverabilityResult r = minimal_coverability_set(pn);
+        std::cout << "Basis: " << r.basis.size() << "\n"
+                  << "Unbounded places: " << r.unbounded_places.size() << "\n"
+                  << "Bounded: " << (r.bounded ? 1 : 0) << "\n";
+    }
+    else if (engine == "unfold") {
+        UnfoldingPrefix pf = unfold(pn);
+        UnfoldingDeadlock d = find_deadlock(pn, pf);
+        std::cout << "Events: " << pf.events.size() << "\n"
+                  << "Conditions: " << pf.conditions.size() << "\n"
+                  << "Cutoffs: " << pf.cutoffs << "\n"
+                  << "Deadlock: " << (d.found ? 1 : 0) << "\n";
+    }
+    else if (engine == "swarm") {
+        SwarmOptions opt;
+        opt.memory_bytes = memory_bytes;
+        SwarmResult r = swarm_deadlock_search(pn, opt);
+        std::cout << "Deadlock: " << (r.found ? 1 : 0) << "\n"
+                  << "Trace length: " << r.trace.size() << "\n"
+                  << "States: " << r.states << "\n";
+    }
+    else if (engine == "simulate") {
+        SimulationStats s = simulate(pn);
+        std::cout << "Runs: " << s.runs << "\n"
+                  << "Steps: " << s.steps << "\n"
+                  << "Deadlock probability: " << s.deadlock_probability << "\n";
+    }
+    else if (engine == "symmetry") {
+        SymmetryGroup g = find_symmetries(pn);
+        ExactStore inner;
+        SymmetricStore store(g, inner);
+        ExplorationStats s = bfs_reachable(pn, store);
+        std::cout << "Group order: " << g.order << "\n"
+                  << "Orbits: " << s.states << "\n"
+                  << "Deadlocks: " << s.deadlocks << "\n";
+    }
+    else if (engine == "liveness") {
+        ReachabilityGraph g = build_reachability_graph(pn);
+        LivenessResult r = analyze_liveness(g.view(), g.n_trans);
+        size_t live = 0;
+        for (bool b : r.live) live += b;
+        std::cout << "States: " << g.states.size() << "\n"
+                  << "Edges: " << g.targets.size() << "\n"
+                  << "Deadlocks: " << r.deadlocks << "\n"
+                  << "SCCs: " << r.n_sccs << "\n"
+                  << "Live transitions: " << live << "\n"
+                  << "Reversible: " << (r.reversible ? 1 : 0) << "\n";
+    }
+    else if (engine == "external") {
+        ExternalBfsOptions opt;
+        opt.work_dir = work_dir;
+        opt.file_prefix = "ebfs_" + std::to_string(getpid()); // concurrent jobs share the directory
+        opt.memory_bytes = memory_bytes;
+        opt.output_path = output;
+        ExternalBfsStats s = external_bfs(pn, opt);
+        std::cout << "States: " << s.states << "\n"
+                  << "Levels: " << s.levels << "\n"
+                  << "Runs written: " << s.runs_written << "\n"
+                  << "Bytes written: " << s.bytes_written << "\n"
+                  << "Bytes read: " << s.bytes_read << "\n";
+    }
+    else if (engine == "sweepline") {
+        ProgressMeasure pm;
+        if (weights.empty()) pm = derive_progress_measure(pn);
+        else {
+            std::stringstream ss(weights);
+            std::string w;
+            while (std::getline(ss, w, ',')) pm.weight.push_back(std::atoll(w.c_str()));
+            if (pm.weight.size() != pn.M0.size()) {
+                std::cerr << "--weights needs one weight per place (" << pn.M0.size() << ")" << std::endl;
+                return 1;
+            }
+        }
+        SweepStats s = sweep_line(pn, pm);
+        std::cout << "States explored: " << s.states_explored << "\n"
+                  << "Peak stored: " << s.peak_stored << "\n"
+                  << "Regress edges: " << s.regress_edges << "\n"
+                  << "Persistent: " << s.persistent << "\n"
+                  << "Sweeps: " << s.sweeps << "\n"
+                  << "Deadlocks: " << s.deadlocks << "\n"
+                  << "Exact: " << (s.exact ? 1 : 0) << "\n";
+    }
+    else if (engine == "checkpoint") {
+        CheckpointOptions opt;
+        opt.path = checkpoint.empty() ? work_dir + "/bfs_" + std::to_string(getpid()) : checkpoint;
+        opt.interval_seconds = checkpoint_seconds;
+        opt.resume = resume;
+        CheckpointedStats s = bfs_checkpointed(pn, opt);
+        std::cout << "States: " << s.states << "\n"
+                  << "Edges: " << s.edges << "\n"
+                  << "Deadlocks: " << s.deadlocks << "\n"
+                  << "Checkpoints: " << s.checkpoints << "\n"
+                  << "Resumed: " << (s.resumed ? 1 : 0) << "\n";
+        if (checkpoint.empty()) { // nobody can resume from it
+            std::remove((opt.path + ".states").c_str());
+            std::remove((opt.path + ".ckpt").c_str());
+        }
+    }
+    else if (engine == "distributed") {
+        DistributedOptions opt;
+        opt.workers = processes;
+        DistributedStats s = distributed_reachable(pn, opt);
+        std::cout << "States: " << s.states << "\n"
+                  << "Edges: " << s.edges << "\n"
+                  << "Deadlocks: " << s.deadlocks << "\n"
+                  << "Processes: " << opt.workers << "\n"
+                  << "Batches sent: " << s.batches_sent << "\n"
+                  << "Bytes sent: " << s.bytes_sent << "\n";
+    }
+    else if (engine == "graph") {
+        ReachabilityGraph g = build_reachability_graph(pn);
+        if (!output.empty() && !write_reachability_graph(g, output)) {
+            std::cerr << "Cannot write " << output << std::endl;
+            return 1;
+        }
+        std::cout << "States: " << g.states.size() << "\n"
+                  << "Edges: " << g.targets.size() << "\n"
+                  << "Deadlocks: " << deadlock_states(g.view()).size() << "\n";
+    }
+    else if (engine == "kernels") {
+        KernelBenchResult r = benchmark_kernels(pn);
+        std::cout << "Places: " << r.places << "\n"
+                  << "Transitions: " << r.transitions << "\n"
+                  << "Sample states: " << r.sample << "\n"
+                  << "Enabled pairs: " << r.enabled_pairs << "\n";
+        for (const auto& k : r.kernels) std::cout << k.kernel << " ns/op: " << k.ns_per_op << "\n";
+        std::cout << "Marking bytes: " << r.marking_bytes << "\n"
+                  << "Exact bytes per state: " << r.exact_bytes_per_state << "\n"
+                  << "Hashcompact bytes per state: " << r.hashcompact_bytes_per_state << "\n"
+                  << "Tree bytes per state: " << r.tree_bytes_per_state << "\n";
+    }
+    else {
+        std::cerr << "Unknown engine: " << engine << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: explicit_worker <engine> [--bound k] [--store-mb n] [--work-dir dir] [--output file]\n"
+                  << "           [--checkpoint path] [--checkpoint-every seconds] [--resume] [--weights w1,w2,...]\n"
+                  << "           [--processes n] [--trace file.json] [--progress seconds] < net.txt" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<ProgressReporter> reporter; // heartbeat on stderr
+    for (int i = 2; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") == 0 && !traceStart(argv[i + 1], std::string("explicit_worker ") + argv[1])) {
+            std::cerr << "Cannot write trace " << argv[i + 1] << std::endl;
+            return 1;
+        }
+        if (std::strcmp(argv[i], "--progress") == 0 && std::atof(argv[i + 1]) > 0) {
+            reporter.reset(new ProgressReporter(std::atof(argv[i + 1])));
+        }
+    }
+    try {
+        PetriNet pn;
+        TraceSpan read_span("read net", "parse");
+        if (!read_net(std::cin, pn)) {
+            std::cerr << "Malformed net on stdin" << std::endl;
+            return 2; // EXIT_PARSE_ERROR
+        }
+        read_span.end();
+        return run_engine(argv[1], pn, argc, argv);
+    }
+    catch (const std::bad_alloc&) {
+        std::cout << "Out of memory" << std::endl;
+        return 3; // EXIT_OUT_OF_MEMORY
+    }
+    catch (const UnsupportedNet& e) {
+        std::cout << "Unsupported: " << e.what() << std::endl;
+        return 4; // EXIT_UNSUPPORTED
+    }
+    catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,239 @@
+#include "JobPool.h"
+#include "../PNML_Parser/NetGenerator.h"
+#include "../PNML_Parser/PetriNet.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+// --- Nets for explicit_worker ---
+
+// Each net is parsed once, by the driver, into the text form read by
+// explicit_worker (see writeNetText); every job on it gets the file as
+// stdin. The parse is therefore not part of a job's time, rusage or memory cap.
+class NetTexts {
+public:
+    ~NetTexts() {
+        for (const auto& e : paths) if (!e.second.empty()) unlink(e.second.c_str());
+        if (!dir.empty()) rmdir(dir.c_str());
+    }
+
+    // Path of the text form of 'file', "" if it does not parse; the parser's
+    // messages go to 'log'
+    const std::string& get(const std::string& file, std::string& log) {
+        auto it = paths.find(file);
+        if (it != paths.end()) return it->second;
+        if (dir.empty()) {
+            char tmpl[] = "/tmp/petri_analyze_XXXXXX";
+            if (!mkdtemp(tmpl)) { perror("mkdtemp"); exit(1); }
+            dir = tmpl;
+        }
+        std::string path = dir + "/net" + std::to_string(paths.size()) + ".txt";
+
+        // the parser prints to cout, which may be the JSON output
+        std::ostringstream messages;
+        std::streambuf* old_out = std::cout.rdbuf(messages.rdbuf());
+        std::streambuf* old_err = std::cerr.rdbuf(messages.rdbuf());
+        PetriNet pn;
+        bool ok = pn.parsePNML(file);
+        std::cout.rdbuf(old_out);
+        std::cerr.rdbuf(old_err);
+        log = messages.str();
+
+        FILE* out = ok ? fopen(path.c_str(), "w") : nullptr;
+        ok = out && writeNetText(pn, out);
+        if (out && fclose(out) != 0) ok = false;
+        if (!ok) unlink(path.c_str());
+        return paths[file] = ok ? path : "";
+    }
+
+private:
+    std::string dir;
+    std::map<std::string, std::string> paths;
+};
+
+// --- Child side ---
+
+[[noreturn]] static void exec_job(const Job& job, const std::string& net_text, const PoolOptions& opt, int out_fd) {
+    setpgid(0, 0); // the whole job tree can be killed at once
+    dup2(out_fd, STDOUT_FILENO);
+    dup2(out_fd, STDERR_FILENO);
+    close(out_fd);
+
+    if (opt.memory_mb > 0) {
+        rlimit lim;
+        lim.rlim_cur = lim.rlim_max = (rlim_t)opt.memory_mb << 20;
+        setrlimit(RLIMIT_AS, &lim);
+    }
+
+    int in = open(net_text.empty() ? "/dev/null" : net_text.c_str(), O_RDONLY);
+    if (in < 0) _exit(EXIT_PARSE_ERROR);
+    dup2(in, STDIN_FILENO);
+
+    std::vector<char*> args;
+    for (const auto& a : job.argv) args.push_back(const_cast<char*>(a.c_str()));
+    args.push_back(nullptr);
+    execv(args[0], args.data());
+    fprintf(stderr, "cannot run %s: %s\n", args[0], strerror(errno));
+    _exit(127);
+}
+
+// --- Parent side ---
+
+struct Running {
+    size_t index;
+    pid_t pid;
+    int fd;
+    Clock::time_point start;
+    bool timed_out = false;
+    JobResult result;
+};
+
+std::map<std::string, std::string> parse_fields(const std::string& output) {
+    std::map<std::string, std::string> fields;
+    std::istringstream in(output);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || colon == 0) continue;
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        char* end = nullptr;
+        if (value.empty()) continue;
+        strtod(value.c_str(), &end);
+        if (*end != '\0') continue; // numbers only
+
+        std::string key;
+        for (char c : line.substr(0, colon)) {
+            if (std::isalnum((unsigned char)c)) key += (char)std::tolower((unsigned char)c);
+            else if (!key.empty() && key.back() != '_') key += '_';
+        }
+        while (!key.empty() && key.back() == '_') key.pop_back();
+        if (!key.empty()) fields[key] = value;
+    }
+    return fields;
+}
+
+static void finish(Running& r, int status, const rusage& ru) {
+    JobResult& res = r.result;
+    res.wall_seconds = std::chrono::duration<double>(Clock::now() - r.start).count();
+    res.cpu_seconds = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    res.peak_rss_kb = ru.ru_maxrss;
+    if (WIFEXITED(status)) {
+        res.exit_code = WEXITSTATUS(status);
+        if (res.exit_code == 0) res.status = "ok";
+        else if (res.exit_code == EXIT_PARSE_ERROR) res.status = "parse_error";
+        else if (res.exit_code == EXIT_OUT_OF_MEMORY) res.status = "memout";
+        else if (res.exit_code == EXIT_UNSUPPORTED) res.status = "unsupported";
+        else res.status = "error";
+    }
+    else {
+        res.exit_code = WTERMSIG(status);
+        res.status = r.timed_out ? "timeout" : "killed";
+    }
+    res.fields = parse_fields(res.output);
+    // the one text field: why the engine rejected the net
+    size_t why = res.output.find("Unsupported: ");
+    if (res.status == "unsupported" && why != std::string::npos) {
+        why += 13;
+        res.fields["unsupported"] = res.output.substr(why, res.output.find('\n', why) - why);
+    }
+}
+
+void run_jobs(const std::vector<Job>& jobs, const PoolOptions& opt,
+              const std::function<void(size_t, const JobResult&)>& on_done) {
+    int workers = opt.workers > 0 ? opt.workers : (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Running> running;
+    size_t next = 0;
+    char buf[1 << 14];
+    NetTexts nets;
+
+    while (next < jobs.size() || !running.empty()) {
+        // --- Start jobs while there is a free worker ---
+        while (next < jobs.size() && (int)running.size() < workers) {
+            std::string net_text;
+            if (jobs[next].feed_net) {
+                std::string log;
+                net_text = nets.get(jobs[next].file, log);
+                if (net_text.empty()) {
+                    JobResult res;
+                    res.status = "parse_error";
+                    res.exit_code = EXIT_PARSE_ERROR;
+                    res.output = log;
+                    on_done(next++, res);
+                    continue;
+                }
+            }
+            int fds[2];
+            if (pipe(fds) != 0) { perror("pipe"); exit(1); }
+            Clock::time_point start = Clock::now(); // the child may finish before fork returns here
+            pid_t pid = fork();
+            if (pid < 0) { perror("fork"); exit(1); }
+            if (pid == 0) {
+                close(fds[0]);
+                exec_job(jobs[next], net_text, opt, fds[1]);
+            }
+            close(fds[1]);
+            fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+            Running r;
+            r.index = next++;
+            r.pid = pid;
+            r.fd = fds[0];
+            r.start = start;
+            running.push_back(r);
+        }
+
+        // --- Collect output (a full pipe would block the child) ---
+        std::vector<pollfd> fds;
+        for (const auto& r : running) if (r.fd >= 0) fds.push_back({r.fd, POLLIN, 0});
+        poll(fds.data(), fds.size(), 20);
+        for (auto& r : running) {
+            if (r.fd < 0) continue;
+            ssize_t n;
+            while ((n = read(r.fd, buf, sizeof(buf))) > 0) r.result.output.append(buf, n);
+            if (n == 0) { close(r.fd); r.fd = -1; }
+        }
+
+        // --- Timeouts and finished children ---
+        for (size_t i = 0; i < running.size();) {
+            Running& r = running[i];
+            if (opt.timeout_seconds > 0 && !r.timed_out &&
+                std::chrono::duration<double>(Clock::now() - r.start).count() > opt.timeout_seconds) {
+                r.timed_out = true;
+                kill(-r.pid, SIGKILL);
+                kill(r.pid, SIGKILL);
+            }
+            int status;
+            rusage ru;
+            if (r.fd < 0 || r.timed_out) {
+                pid_t done = wait4(r.pid, &status, WNOHANG, &ru);
+                if (done == r.pid) {
+                    if (r.fd >= 0) {
+                        ssize_t n;
+                        while ((n = read(r.fd, buf, sizeof(buf))) > 0) r.result.output.append(buf, n);
+                        close(r.fd);
+                    }
+                    finish(r, status, ru);
+                    on_done(r.index, r.result);
+                    running.erase(running.begin() + i);
+                    continue;
+                }
+            }
+            ++i;
+        }
+    }
+}
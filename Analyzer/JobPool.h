@@ -0,0 +1,48 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// One engine run on one net, executed as a child process
+struct Job {
+    std::string file;               // the PNML file
+    std::string engine;             // engine name, for the results
+    std::vector<std::string> argv;  // program and arguments
+    bool feed_net = false;          // pass the parsed 'file' on stdin (explicit_worker); parsed by the driver
+};
+
+struct JobResult {
+    std::string status;             // ok, timeout, memout, parse_error, error, killed
+    int exit_code = 0;              // exit status, or the signal number when killed
+    double wall_seconds = 0;
+    double cpu_seconds = 0;         // user + system of the child
+    long peak_rss_kb = 0;
+    std::string output;             // stdout and stderr of the child
+    std::map<std::string, std::string> fields; // numeric "Key: value" lines of the output, plus
+                                               // "unsupported" (the reason) for that status
+};
+
+struct PoolOptions {
+    int workers = 0;                // concurrent jobs, 0 = one per hardware thread
+    double timeout_seconds = 0;     // per job, 0 = none
+    long memory_mb = 0;             // address-space cap per job, 0 = none
+};
+
+// Exit codes of explicit_worker and petri_solver understood by the pool
+const int EXIT_PARSE_ERROR = 2;
+const int EXIT_OUT_OF_MEMORY = 3;
+const int EXIT_UNSUPPORTED = 4; // the engine does not handle this net ("Unsupported: <reason>")
+
+// Runs every job, at most 'workers' at a time. A job over its timeout is
+// killed (SIGKILL to its process group); the memory cap is an RLIMIT_AS set
+// in the child before exec. on_done is called in completion order.
+void run_jobs(const std::vector<Job>& jobs, const PoolOptions& opt,
+              const std::function<void(size_t, const JobResult&)>& on_done);
+
+// "Total reachable markings: 11" -> fields["total_reachable_markings"] = "11"
+std::map<std::string, std::string> parse_fields(const std::string& output);
+
+#endif // JOB_POOL_H
@@ -0,0 +1,304 @@
+#include "JobPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+static const char* USAGE =
+    "Usage: petri_analyze [options] <file.pnml | directory>...\n"
+    "  --engine e1,e2,...   engines to run on every net (default: bfs)\n"
+    "                       explicit: bfs dfs hashcompact bitstate tree bounded coverability\n"
+    "                                 unfold swarm simulate symmetry liveness external sweepline\n"
+    "                                 checkpoint distributed graph\n"
+    "                       micro-benchmarks of the explicit kernels: kernels\n"
+    "                       symbolic: bdd\n"
+    "  -j <n>               nets analysed at the same time (default: hardware threads)\n"
+    "  --timeout <seconds>  per job (default: none)\n"
+    "  --memory <MB>        address-space cap per job (default: none)\n"
+    "  --bound <k>          token bound of the bounded engine (default: 1)\n"
+    "  --work-dir <dir>     files of the external, checkpoint and graph engines (default: .);\n"
+    "                       graph writes <net>.rgcsr, checkpoint <net>.states and <net>.ckpt\n"
+    "  --checkpoint-every <seconds>  checkpoint interval of the checkpoint engine (default: 60)\n"
+    "  --processes <n>      processes of the distributed engine (default: 4)\n"
+    "  --repeat <n>         run every job n times and report the median times (default: 1)\n"
+    "  --out <file>         results as CSV (.csv) or JSON lines (otherwise), may be repeated;\n"
+    "                       default: JSON lines on stdout\n"
+    "  --trace-dir <dir>    write a Chrome trace (<net>.<engine>.json) of every job into dir\n"
+    "  --worker <path>      explicit_worker binary (default: next to petri_analyze)\n"
+    "  --bdd-solver <path>  petri_solver binary (default: ../SymbolicComputationUsingBDD/petri_solver)\n";
+
+static const char* EXPLICIT_ENGINES[] = {
+    "bfs", "dfs", "hashcompact", "bitstate", "tree", "bounded", "coverability",
+    "unfold", "swarm", "simulate", "symmetry", "liveness", "kernels",
+    "external", "sweepline", "checkpoint", "distributed", "graph"
+};
+
+static std::string binary_dir() {
+    char buf[4096];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (n <= 0) return ".";
+    buf[n] = '\0';
+    return fs::path(buf).parent_path().string();
+}
+
+// Files as given, directories searched recursively for *.pnml (sorted)
+static std::vector<std::string> collect_files(const std::vector<std::string>& inputs) {
+    std::vector<std::string> files;
+    for (const auto& in : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(in, ec)) {
+            std::vector<std::string> found;
+            for (const auto& entry : fs::recursive_directory_iterator(in, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".pnml") found.push_back(entry.path().string());
+            }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        }
+        else files.push_back(in);
+    }
+    return files;
+}
+
+static std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if ((unsigned char)c < 0x20) { char b[8]; snprintf(b, sizeof(b), "\\u%04x", c); out += b; }
+        else out += c;
+    }
+    return out;
+}
+
+// A metric as a JSON value: finite numbers in JSON syntax as they are,
+// anything else ("inf", "nan", "0x1p3", ...) as a string
+static std::string json_value(const std::string& v) {
+    char* end = nullptr;
+    double d = v.empty() ? 0 : strtod(v.c_str(), &end);
+    bool number = !v.empty() && *end == '\0' && std::isfinite(d);
+    // JSON: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t i = 0, n = v.size();
+    auto digits = [&] { size_t start = i; while (i < n && std::isdigit((unsigned char)v[i])) ++i; return i > start; };
+    if (number && i < n && v[i] == '-') ++i;
+    if (number && i < n && v[i] == '0') ++i;
+    else number = number && i < n && v[i] != '0' && digits();
+    if (number && i < n && v[i] == '.') { ++i; number = digits(); }
+    if (number && i < n && (v[i] == 'e' || v[i] == 'E')) {
+        ++i;
+        if (i < n && (v[i] == '+' || v[i] == '-')) ++i;
+        number = digits();
+    }
+    return number && i == n ? v : "\"" + json_escape(v) + "\"";
+}
+
+static std::string csv_escape(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) { if (c == '"') out += '"'; out += c; }
+    return out + "\"";
+}
+
+static std::string field(const JobResult& r, const std::string& key) {
+    auto it = r.fields.find(key);
+    return it == r.fields.end() ? "" : it->second;
+}
+
+// One (net, engine) pair and its repeated runs
+struct Measurement {
+    std::string file;
+    std::string engine;
+    std::vector<JobResult> runs;
+    size_t finished = 0;
+    JobResult summary;            // medians of the runs, fields of the first run
+    double wall_min = 0, wall_max = 0;
+};
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+static void summarize(Measurement& m) {
+    std::vector<double> wall, cpu, rss;
+    for (const auto& r : m.runs) {
+        wall.push_back(r.wall_seconds);
+        cpu.push_back(r.cpu_seconds);
+        rss.push_back((double)r.peak_rss_kb);
+    }
+    // the first failure decides the status; counts come from the first run
+    m.summary = m.runs[0];
+    for (const auto& r : m.runs) if (r.status != "ok") { m.summary.status = r.status; m.summary.exit_code = r.exit_code; break; }
+    m.summary.wall_seconds = median(wall);
+    m.summary.cpu_seconds = median(cpu);
+    m.summary.peak_rss_kb = (long)median(rss);
+    m.wall_min = *std::min_element(wall.begin(), wall.end());
+    m.wall_max = *std::max_element(wall.begin(), wall.end());
+}
+
+static void write_json_line(std::ostream& out, const Measurement& m) {
+    const JobResult& r = m.summary;
+    out << "{\"file\":\"" << json_escape(m.file) << "\",\"engine\":\"" << m.engine
+        << "\",\"status\":\"" << r.status << "\",\"exit_code\":" << r.exit_code
+        << ",\"repeats\":" << m.runs.size()
+        << ",\"wall_seconds\":" << r.wall_seconds << ",\"cpu_seconds\":" << r.cpu_seconds
+        << ",\"peak_rss_kb\":" << r.peak_rss_kb;
+    if (m.runs.size() > 1) out << ",\"wall_seconds_min\":" << m.wall_min << ",\"wall_seconds_max\":" << m.wall_max;
+    for (const auto& f : r.fields) out << ",\"" << f.first << "\":" << json_value(f.second);
+    out << "}\n";
+}
+
+static const char* CSV_COLUMNS[] = {"states", "edges", "deadlocks", "iterations", "peak_nodes"};
+
+// The fixed columns, then every other field of the results in name order
+static void write_csv(std::ostream& out, const std::vector<Measurement>& all) {
+    std::vector<std::string> columns(std::begin(CSV_COLUMNS), std::end(CSV_COLUMNS));
+    std::set<std::string> extra;
+    for (const auto& m : all) for (const auto& f : m.summary.fields) extra.insert(f.first);
+    for (const auto& c : columns) extra.erase(c);
+    columns.insert(columns.end(), extra.begin(), extra.end());
+
+    out << "file,engine,status,exit_code,repeats,wall_seconds,cpu_seconds,peak_rss_kb";
+    for (const auto& c : columns) out << "," << c;
+    out << "\n";
+    for (const auto& m : all) {
+        const JobResult& r = m.summary;
+        out << csv_escape(m.file) << "," << m.engine << "," << r.status << "," << r.exit_code << ","
+            << m.runs.size() << "," << r.wall_seconds << "," << r.cpu_seconds << "," << r.peak_rss_kb;
+        for (const auto& c : columns) out << "," << field(r, c);
+        out << "\n";
+    }
+}
+
+static bool is_csv(const std::string& path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs, engines = {"bfs"};
+    PoolOptions pool;
+    std::vector<std::string> out_paths;
+    std::string bound = "1", trace_dir;
+    std::string work_dir = ".", checkpoint_every = "60", processes = "4";
+    int repeat = 1;
+    std::string dir = binary_dir();
+    std::string worker = dir + "/explicit_worker";
+    std::string bdd_solver = dir + "/../SymbolicComputationUsingBDD/petri_solver";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--engine" && has_value) {
+            engines.clear();
+            std::stringstream ss(argv[++i]);
+            std::string e;
+            while (std::getline(ss, e, ',')) if (!e.empty()) engines.push_back(e);
+        }
+        else if (a == "-j" && has_value) pool.workers = std::atoi(argv[++i]);
+        else if (a == "--timeout" && has_value) pool.timeout_seconds = std::atof(argv[++i]);
+        else if (a == "--memory" && has_value) pool.memory_mb = std::atol(argv[++i]);
+        else if (a == "--bound" && has_value) bound = argv[++i];
+        else if (a == "--work-dir" && has_value) work_dir = argv[++i];
+        else if (a == "--checkpoint-every" && has_value) checkpoint_every = argv[++i];
+        else if (a == "--processes" && has_value) processes = argv[++i];
+        else if (a == "--repeat" && has_value) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--out" && has_value) out_paths.push_back(argv[++i]);
+        else if (a == "--trace-dir" && has_value) trace_dir = argv[++i];
+        else if (a == "--worker" && has_value) worker = argv[++i];
+        else if (a == "--bdd-solver" && has_value) bdd_solver = argv[++i];
+        else if (a == "-h" || a == "--help") { std::cout << USAGE; return 0; }
+        else if (!a.empty() && a[0] == '-') { std::cerr << "Unknown option " << a << "\n" << USAGE; return 1; }
+        else inputs.push_back(a);
+    }
+    if (inputs.empty()) { std::cerr << USAGE; return 1; }
+    for (const auto& d : {trace_dir, work_dir}) {
+        std::error_code ec;
+        if (!d.empty()) fs::create_directories(d, ec);
+        if (ec) { std::cerr << "Cannot create " << d << std::endl; return 1; }
+    }
+
+    for (const auto& e : engines) {
+        bool known = e == "bdd" || std::find(std::begin(EXPLICIT_ENGINES), std::end(EXPLICIT_ENGINES), e) != std::end(EXPLICIT_ENGINES);
+        if (!known) { std::cerr << "Unknown engine " << e << "\n" << USAGE; return 1; }
+    }
+
+    // --- Jobs: every file with every engine, 'repeat' times ---
+    std::vector<Measurement> measurements;
+    std::vector<Job> jobs;
+    std::vector<size_t> job_measurement;
+    for (const auto& file : collect_files(inputs)) {
+        for (const auto& e : engines) {
+            Measurement m;
+            m.file = file;
+            m.engine = e;
+            m.runs.resize(repeat);
+            measurements.push_back(m);
+
+            for (int k = 0; k < repeat; ++k) {
+                // files of the job: nets may share a stem, and repeats may run at the same time
+                std::string name = fs::path(file).stem().string() + ".job" + std::to_string(jobs.size());
+                std::string stem = (fs::path(work_dir) / name).string();
+                Job job;
+                job.file = file;
+                job.engine = e;
+                if (e == "bdd") job.argv = {bdd_solver, file};
+                else {
+                    job.argv = {worker, e, "--bound", bound, "--work-dir", work_dir,
+                                "--checkpoint-every", checkpoint_every, "--processes", processes};
+                    if (e == "graph") job.argv.insert(job.argv.end(), {"--output", stem + ".rgcsr"});
+                    if (e == "checkpoint") job.argv.insert(job.argv.end(), {"--checkpoint", stem});
+                    job.feed_net = true;
+                }
+                if (!trace_dir.empty()) {
+                    job.argv.push_back("--trace");
+                    job.argv.push_back((fs::path(trace_dir) / (name + "." + e + ".json")).string());
+                }
+                jobs.push_back(job);
+                job_measurement.push_back(measurements.size() - 1);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<std::ofstream>> files;
+    std::vector<std::ostream*> json_outs;
+    for (const auto& path : out_paths) {
+        files.emplace_back(new std::ofstream(path));
+        if (!*files.back()) { std::cerr << "Cannot write " << path << std::endl; return 1; }
+        if (!is_csv(path)) json_outs.push_back(files.back().get());
+    }
+    if (out_paths.empty()) json_outs.push_back(&std::cout);
+
+    // --- Run; JSON lines stream out as measurements finish, CSV is written in input order ---
+    size_t done = 0;
+    run_jobs(jobs, pool, [&](size_t i, const JobResult& r) {
+        Measurement& m = measurements[job_measurement[i]];
+        JobResult& run = m.runs[m.finished++];
+        run = r;
+        // the BDD solver names its count differently
+        auto it = run.fields.find("total_reachable_markings");
+        if (it != run.fields.end()) run.fields["states"] = it->second;
+        auto why = run.fields.find("unsupported");
+        std::cerr << "[" << ++done << "/" << jobs.size() << "] " << m.file << " " << m.engine
+                  << ": " << r.status << (why != run.fields.end() ? " (" + why->second + ")" : "")
+                  << " (" << r.wall_seconds << " s)" << std::endl;
+
+        if (m.finished == m.runs.size()) {
+            summarize(m);
+            for (auto* out : json_outs) { write_json_line(*out, m); out->flush(); }
+        }
+    });
+    for (size_t k = 0; k < out_paths.size(); ++k) if (is_csv(out_paths[k])) write_csv(*files[k], measurements);
+
+    size_t failed = std::count_if(measurements.begin(), measurements.end(),
+                                  [](const Measurement& m) { return m.summary.status != "ok"; });
+    return failed == 0 ? 0 : 2;
+}
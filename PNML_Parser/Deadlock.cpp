@@ -0,0 +1,99 @@
+#include "Deadlock.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+
+static bool enabled(const PetriNet& net, const std::vector<int>& marking, int t) {
+    // pre_matrix[t] may list a place more than once: count the copies
+    std::vector<int> need = net.pre_matrix[t];
+    std::sort(need.begin(), need.end());
+    for (size_t i = 0; i < need.size();) {
+        size_t j = i;
+        while (j < need.size() && need[j] == need[i]) ++j;
+        if (marking[need[i]] < (int)(j - i)) return false;
+        i = j;
+    }
+    return true;
+}
+
+static void fire(const PetriNet& net, std::vector<int>& marking, int t) {
+    for (int p : net.pre_matrix[t]) marking[p]--;
+    for (int p : net.post_matrix[t]) marking[p]++;
+}
+
+bool isDeadlock(const PetriNet& net, const std::vector<int>& marking) {
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+        if (enabled(net, marking, t)) return false;
+    }
+    return true;
+}
+
+bool replayTrace(const PetriNet& net, const std::vector<int>& trace, std::vector<int>& marking) {
+    marking = net.initial_marking;
+    for (int t : trace) {
+        if (t < 0 || t >= (int)net.transition_ids.size() || !enabled(net, marking, t)) return false;
+        fire(net, marking, t);
+    }
+    return true;
+}
+
+DeadlockWitness findDeadlock(const PetriNet& net, size_t max_states) {
+    DeadlockWitness w;
+
+    // Each visited marking keeps the transition and marking it was reached by
+    struct Visit { int via; const std::vector<int>* parent; };
+    std::map<std::vector<int>, Visit> visited;
+    std::deque<const std::vector<int>*> queue;
+
+    auto it = visited.emplace(net.initial_marking, Visit{-1, nullptr}).first;
+    queue.push_back(&it->first);
+    while (!queue.empty()) {
+        const std::vector<int>* m = queue.front();
+        queue.pop_front();
+        w.states++;
+
+        bool dead = true;
+        for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+            if (!enabled(net, *m, t)) continue;
+            dead = false;
+            if (visited.size() >= max_states) continue;
+            std::vector<int> next = *m;
+            fire(net, next, t);
+            auto ins = visited.emplace(std::move(next), Visit{(int)t, m});
+            if (ins.second) queue.push_back(&ins.first->first);
+        }
+        if (!dead) continue;
+
+        // --- Walk the parents back to M0 ---
+        w.found = true;
+        w.marking = *m;
+        for (const std::vector<int>* at = m; at; ) {
+            const Visit& v = visited.at(*at);
+            if (v.via >= 0) w.trace.push_back(v.via);
+            at = v.parent;
+        }
+        std::reverse(w.trace.begin(), w.trace.end());
+        return w;
+    }
+    w.complete = visited.size() < max_states;
+    return w;
+}
+
+DeadlockWitness findDeadlockReduced(const PetriNet& net, const ReductionResult& reduction, size_t max_states) {
+    DeadlockWitness reduced = findDeadlock(reduction.net, max_states);
+    DeadlockWitness w;
+    w.complete = reduced.complete;
+    w.states = reduced.states;
+    if (!reduced.found) return w;
+
+    // the lifted sequence must really lead to a deadlock of the original net
+    std::vector<int> trace, lifted, replayed;
+    w.complete = false;
+    if (!reduction.liftTrace(net, reduced.trace, trace, lifted, /*deadlock=*/true)) return w;
+    if (!replayTrace(net, trace, replayed) || replayed != lifted || !isDeadlock(net, replayed)) return w;
+    w.found = true;
+    w.complete = true;
+    w.trace = trace;
+    w.marking = replayed;
+    return w;
+}
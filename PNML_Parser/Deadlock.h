@@ -0,0 +1,34 @@
+#ifndef DEADLOCK_H
+#define DEADLOCK_H
+
+#include "PetriNet.h"
+#include "Reduction.h"
+#include <cstddef>
+#include <vector>
+
+struct DeadlockWitness {
+    bool found = false;
+    bool complete = true;     // false: stopped at max_states without a deadlock
+    size_t states = 0;        // markings visited
+    std::vector<int> trace;   // transitions fired from M0 to the deadlock
+    std::vector<int> marking; // the deadlock
+};
+
+// Breadth-first search for a deadlock (shortest witness). Arcs are counted
+// as in pre_matrix/post_matrix, so repeated places weigh more than 1.
+DeadlockWitness findDeadlock(const PetriNet& net, size_t max_states = 1000000);
+
+// The same search on reduction.net (reduceNet(net) was applied). The reduced
+// witness is lifted with liftTrace and replayed on 'net'; trace and marking
+// are those of the original net. A lifted marking that is not a deadlock of
+// 'net' is not reported: found and complete are then both false.
+DeadlockWitness findDeadlockReduced(const PetriNet& net, const ReductionResult& reduction,
+                                    size_t max_states = 1000000);
+
+// Fires 'trace' from the initial marking; false if a transition is not enabled
+bool replayTrace(const PetriNet& net, const std::vector<int>& trace, std::vector<int>& marking);
+
+// No transition is enabled in 'marking'
+bool isDeadlock(const PetriNet& net, const std::vector<int>& marking);
+
+#endif
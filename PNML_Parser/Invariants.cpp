@@ -0,0 +1,253 @@
+#include "Invariants.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+using SparseVec = std::vector<std::pair<int, long long>>;
+
+// One row of the Farkas tableau [ C | I ]:
+// 'rest' is what is left of the incidence part, 'flow' is the semiflow being built.
+struct FarkasRow {
+    SparseVec rest;
+    SparseVec flow;
+    uint64_t signature = 0; // bit (i % 64) set for every i in the support of 'flow'
+};
+
+// --- Checked arithmetic ---
+static long long checkedMul(long long a, long long b) {
+    long long r;
+    if (__builtin_mul_overflow(a, b, &r)) throw std::overflow_error("semiflow coefficient overflow");
+    return r;
+}
+
+static long long checkedAdd(long long a, long long b) {
+    long long r;
+    if (__builtin_add_overflow(a, b, &r)) throw std::overflow_error("semiflow coefficient overflow");
+    return r;
+}
+
+static long long coefficientAt(const SparseVec& v, int index) {
+    auto it = std::lower_bound(v.begin(), v.end(), std::make_pair(index, LLONG_MIN));
+    return (it != v.end() && it->first == index) ? it->second : 0;
+}
+
+// fa * a + fb * b, dropping zero entries
+static SparseVec combine(const SparseVec& a, long long fa, const SparseVec& b, long long fb) {
+    SparseVec out;
+    out.reserve(a.size() + b.size());
+    size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        int ia = i < a.size() ? a[i].first : INT32_MAX;
+        int ib = j < b.size() ? b[j].first : INT32_MAX;
+        long long value;
+        int index;
+        if (ia == ib) {
+            index = ia;
+            value = checkedAdd(checkedMul(fa, a[i++].second), checkedMul(fb, b[j++].second));
+        } else if (ia < ib) {
+            index = ia;
+            value = checkedMul(fa, a[i++].second);
+        } else {
+            index = ib;
+            value = checkedMul(fb, b[j++].second);
+        }
+        if (value != 0) out.push_back({index, value});
+    }
+    return out;
+}
+
+static void divideRow(FarkasRow& row) {
+    long long g = 0;
+    for (auto& e : row.rest) g = std::gcd(g, e.second);
+    for (auto& e : row.flow) g = std::gcd(g, e.second);
+    if (g <= 1) return;
+    for (auto& e : row.rest) e.second /= g;
+    for (auto& e : row.flow) e.second /= g;
+}
+
+static void computeSignature(FarkasRow& row) {
+    row.signature = 0;
+    for (auto& e : row.flow) row.signature |= uint64_t(1) << (e.first & 63);
+}
+
+// support(a) is a subset of support(b)
+static bool supportIncluded(const FarkasRow& a, const FarkasRow& b) {
+    if (a.flow.size() > b.flow.size()) return false;
+    if ((a.signature & ~b.signature) != 0) return false;
+    if (a.flow.front().first < b.flow.front().first || a.flow.back().first > b.flow.back().first) return false;
+    auto j = b.flow.begin();
+    for (auto& e : a.flow) {
+        j = std::lower_bound(j, b.flow.end(), std::make_pair(e.first, LLONG_MIN));
+        if (j == b.flow.end() || j->first != e.first) return false;
+    }
+    return true;
+}
+
+// Generic Farkas algorithm: find minimal non-negative y with y.A = 0,
+// where A is given row by row (num_rows sparse rows over num_cols columns).
+static SemiflowResult farkas(const std::vector<SparseVec>& matrix, int num_cols, size_t max_rows) {
+    SemiflowResult result;
+
+    std::vector<FarkasRow> rows(matrix.size());
+    for (size_t r = 0; r < matrix.size(); ++r) {
+        rows[r].rest = matrix[r];
+        rows[r].flow = {{(int)r, 1}};
+        computeSignature(rows[r]);
+    }
+
+    std::vector<char> eliminated(num_cols, 0);
+    std::vector<long long> n_pos(num_cols), n_neg(num_cols);
+    for (int step = 0; step < num_cols; ++step) {
+        // 1. Pick the column that creates the fewest new rows
+        std::fill(n_pos.begin(), n_pos.end(), 0);
+        std::fill(n_neg.begin(), n_neg.end(), 0);
+        for (auto& row : rows) {
+            for (auto& e : row.rest) {
+                if (e.second > 0) n_pos[e.first]++;
+                else n_neg[e.first]++;
+            }
+        }
+        int col = -1;
+        long long best = 0;
+        for (int c = 0; c < num_cols; ++c) {
+            if (eliminated[c]) continue;
+            long long growth = n_pos[c] * n_neg[c] - n_pos[c] - n_neg[c];
+            if (col == -1 || growth < best) { col = c; best = growth; }
+        }
+        eliminated[col] = 1;
+        if (n_pos[col] == 0 && n_neg[col] == 0) continue;
+
+        // 2. Split rows on the sign of the chosen column (zero rows stay in place)
+        std::vector<FarkasRow> positive, negative;
+        size_t w = 0;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            long long c = coefficientAt(rows[r].rest, col);
+            if (c > 0) positive.push_back(std::move(rows[r]));
+            else if (c < 0) negative.push_back(std::move(rows[r]));
+            else {
+                if (w != r) rows[w] = std::move(rows[r]);
+                w++;
+            }
+        }
+        rows.resize(w);
+        std::vector<FarkasRow>& kept = rows;
+
+        // 3. Combine every (positive, negative) pair so the column cancels.
+        // Old rows were pairwise minimal, so only new rows can be redundant.
+        // Candidates are accepted by increasing support size: a row is dropped
+        // when an accepted row's support is included in its own. Accepted rows
+        // are indexed by their smallest support element, since a subset of a
+        // row must start with one of that row's elements. With only a few pairs
+        // a plain scan is cheaper than building the index.
+        bool use_index = positive.size() * negative.size() > 16;
+        std::unordered_map<int, std::vector<int>> by_first;
+        auto isRedundant = [&](const FarkasRow& row) {
+            if (!use_index) {
+                for (auto& other : kept) {
+                    if (supportIncluded(other, row)) return true;
+                }
+                return false;
+            }
+            for (auto& e : row.flow) {
+                auto it = by_first.find(e.first);
+                if (it == by_first.end()) continue;
+                for (int k : it->second) {
+                    if (supportIncluded(kept[k], row)) return true;
+                }
+            }
+            return false;
+        };
+        if (use_index) {
+            for (size_t k = 0; k < kept.size(); ++k) by_first[kept[k].flow.front().first].push_back(k);
+        }
+
+        struct Candidate { FarkasRow row; int a, b; };
+        std::vector<Candidate> candidates;
+        for (size_t i = 0; i < positive.size(); ++i) {
+            long long ca = coefficientAt(positive[i].rest, col);
+            for (size_t j = 0; j < negative.size(); ++j) {
+                long long cb = -coefficientAt(negative[j].rest, col);
+
+                Candidate cand;
+                cand.a = i;
+                cand.b = j;
+                cand.row.flow = combine(positive[i].flow, cb, negative[j].flow, ca);
+                computeSignature(cand.row);
+                if (isRedundant(cand.row)) continue;
+
+                candidates.push_back(std::move(cand));
+                if (kept.size() + candidates.size() > max_rows) {
+                    result.complete = false;
+                    return result;
+                }
+            }
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& x, const Candidate& y) {
+            return x.row.flow.size() < y.row.flow.size();
+        });
+        for (auto& cand : candidates) {
+            if (isRedundant(cand.row)) continue;
+
+            const FarkasRow& a = positive[cand.a];
+            const FarkasRow& b = negative[cand.b];
+            cand.row.rest = combine(a.rest, -coefficientAt(b.rest, col), b.rest, coefficientAt(a.rest, col));
+            divideRow(cand.row);
+
+            if (use_index) by_first[cand.row.flow.front().first].push_back(kept.size());
+            kept.push_back(std::move(cand.row));
+        }
+    }
+
+    for (auto& row : rows) result.flows.push_back({row.flow});
+    return result;
+}
+
+// C[p][t] = (#arcs t->p) - (#arcs p->t), stored per place
+static std::vector<SparseVec> incidenceByPlace(const PetriNet& net) {
+    std::vector<std::map<int, long long>> c(net.place_ids.size());
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+        for (int p : net.pre_matrix[t]) c[p][t] -= 1;
+        for (int p : net.post_matrix[t]) c[p][t] += 1;
+    }
+    std::vector<SparseVec> rows(c.size());
+    for (size_t p = 0; p < c.size(); ++p) {
+        for (auto& e : c[p]) {
+            if (e.second != 0) rows[p].push_back(e);
+        }
+    }
+    return rows;
+}
+
+SemiflowResult computePSemiflows(const PetriNet& net, size_t max_rows) {
+    return farkas(incidenceByPlace(net), net.transition_ids.size(), max_rows);
+}
+
+SemiflowResult computeTSemiflows(const PetriNet& net, size_t max_rows) {
+    // Transpose: one row per transition over the places
+    std::vector<SparseVec> by_place = incidenceByPlace(net);
+    std::vector<SparseVec> rows(net.transition_ids.size());
+    for (size_t p = 0; p < by_place.size(); ++p) {
+        for (auto& e : by_place[p]) rows[e.first].push_back({(int)p, e.second});
+    }
+    return farkas(rows, net.place_ids.size(), max_rows);
+}
+
+long long semiflowValue(const Semiflow& flow, const std::vector<int>& marking) {
+    long long sum = 0;
+    for (auto& e : flow.weights) sum = checkedAdd(sum, checkedMul(e.second, marking[e.first]));
+    return sum;
+}
+
+bool provesUnreachable(const std::vector<Semiflow>& p_flows,
+                       const std::vector<int>& m0,
+                       const std::vector<int>& m) {
+    for (const auto& flow : p_flows) {
+        if (semiflowValue(flow, m) != semiflowValue(flow, m0)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,35 @@
+#ifndef INVARIANTS_H
+#define INVARIANTS_H
+
+#include "PetriNet.h"
+#include <vector>
+#include <utility>
+
+// A semiflow is a non-negative integer vector over places (P-semiflow, y.C = 0)
+// or over transitions (T-semiflow, C.x = 0), where C = Post - Pre.
+// Only the non-zero entries are stored, sorted by index.
+struct Semiflow {
+    std::vector<std::pair<int, long long>> weights; // (index, coefficient > 0)
+};
+
+struct SemiflowResult {
+    std::vector<Semiflow> flows; // minimal-support semiflows
+    bool complete = true;        // false if max_rows was hit (flows is then empty)
+};
+
+// --- Farkas / Fourier-Motzkin elimination on the sparse incidence matrix ---
+// Coefficients are 64-bit and checked; throws std::overflow_error on overflow.
+// Rows with a non-minimal support are dropped after every eliminated column.
+SemiflowResult computePSemiflows(const PetriNet& net, size_t max_rows = 100000);
+SemiflowResult computeTSemiflows(const PetriNet& net, size_t max_rows = 100000);
+
+// Weighted token sum y.M of a P-semiflow (constant over all reachable markings)
+long long semiflowValue(const Semiflow& flow, const std::vector<int>& marking);
+
+// Fast unreachability proof: true if some P-semiflow gives M a different
+// weighted sum than M0, so M cannot be reached from M0.
+bool provesUnreachable(const std::vector<Semiflow>& p_flows,
+                       const std::vector<int>& m0,
+                       const std::vector<int>& m);
+
+#endif
@@ -0,0 +1,259 @@
+#include "NetGenerator.h"
+#include <algorithm>
+#include <charconv>
+#include <random>
+#include <stdexcept>
+
+// --- Building ---
+
+namespace {
+
+// Appends places / transitions with the testcase naming (p1.., t1..)
+struct NetBuilder {
+    PetriNet& net;
+
+    explicit NetBuilder(PetriNet& n) : net(n) {}
+
+    int place(int tokens = 0) {
+        net.place_ids.push_back("p" + std::to_string(net.place_ids.size() + 1));
+        net.initial_marking.push_back(tokens);
+        return (int)net.place_ids.size() - 1;
+    }
+
+    int transition(std::vector<int> pre, std::vector<int> post) {
+        net.transition_ids.push_back("t" + std::to_string(net.transition_ids.size() + 1));
+        net.pre_matrix.push_back(std::move(pre));
+        net.post_matrix.push_back(std::move(post));
+        return (int)net.transition_ids.size() - 1;
+    }
+
+    void reserve(long places, long transitions) {
+        net.place_ids.reserve(places);
+        net.initial_marking.reserve(places);
+        net.transition_ids.reserve(transitions);
+        net.pre_matrix.reserve(transitions);
+        net.post_matrix.reserve(transitions);
+    }
+};
+
+void buildChain(NetBuilder& b, long n, bool ring) {
+    b.reserve(n, n);
+    for (long i = 0; i < n; ++i) b.place(i == 0 ? 1 : 0);
+    for (long i = 0; i + 1 < n; ++i) b.transition({(int)i}, {(int)i + 1});
+    if (ring) b.transition({(int)n - 1}, {0});
+}
+
+// thinking, has left fork, eating, fork (to the left of philosopher i)
+void buildPhilosophers(NetBuilder& b, long n) {
+    b.reserve(4 * n, 3 * n);
+    for (long i = 0; i < n; ++i) { b.place(1); b.place(0); b.place(0); b.place(1); }
+    auto think = [](long i) { return (int)(4 * i); };
+    auto left = [](long i) { return (int)(4 * i + 1); };
+    auto eat = [](long i) { return (int)(4 * i + 2); };
+    auto fork = [n](long i) { return (int)(4 * (i % n) + 3); };
+    for (long i = 0; i < n; ++i) {
+        b.transition({think(i), fork(i)}, {left(i)});
+        b.transition({left(i), fork(i + 1)}, {eat(i)});
+        b.transition({eat(i)}, {think(i), fork(i), fork(i + 1)});
+    }
+}
+
+// idle, busy, token; the token may be used (enter/leave) or passed on
+void buildTokenRing(NetBuilder& b, long n) {
+    b.reserve(3 * n, 3 * n);
+    for (long i = 0; i < n; ++i) { b.place(1); b.place(0); b.place(i == 0 ? 1 : 0); }
+    auto idle = [](long i) { return (int)(3 * i); };
+    auto busy = [](long i) { return (int)(3 * i + 1); };
+    auto token = [n](long i) { return (int)(3 * (i % n) + 2); };
+    for (long i = 0; i < n; ++i) {
+        b.transition({idle(i), token(i)}, {busy(i)});
+        b.transition({busy(i)}, {idle(i), token(i + 1)});
+        b.transition({token(i)}, {token(i + 1)});
+    }
+}
+
+// Stage s: ready_s -fork-> branch_s,j -work-> done_s,j -join-> ready_s+1
+void buildForkJoin(NetBuilder& b, long stages, int width) {
+    b.reserve(stages * (1 + 2 * width), stages * (2 + width));
+    for (long s = 0; s < stages; ++s) {
+        b.place(s == 0 ? 1 : 0);
+        for (int j = 0; j < 2 * width; ++j) b.place(0);
+    }
+    long unit = 1 + 2 * width;
+    for (long s = 0; s < stages; ++s) {
+        int ready = (int)(s * unit), next = (int)(((s + 1) % stages) * unit);
+        std::vector<int> branches, done;
+        for (int j = 0; j < width; ++j) {
+            branches.push_back(ready + 1 + j);
+            done.push_back(ready + 1 + width + j);
+        }
+        b.transition({ready}, branches);
+        for (int j = 0; j < width; ++j) b.transition({branches[j]}, {done[j]});
+        b.transition(done, {next});
+    }
+}
+
+// 'machines' state machines of 'width' local states, one token each. Every
+// transition moves 1..density machines from one local state to another, so
+// each machine keeps exactly one token.
+void buildRandomSafe(NetBuilder& b, long machines, int width, int density, long transitions, uint64_t seed) {
+    b.reserve(machines * width, transitions);
+    for (long m = 0; m < machines; ++m) {
+        for (int s = 0; s < width; ++s) b.place(s == 0 ? 1 : 0);
+    }
+    std::mt19937_64 rng(seed);
+    int most = (int)std::min<long>(density, machines);
+    std::vector<long> picked;
+    for (long t = 0; t < transitions; ++t) {
+        int k = 1 + (int)(rng() % most);
+        picked.clear();
+        while ((int)picked.size() < k) {
+            long m = (long)(rng() % machines);
+            if (std::find(picked.begin(), picked.end(), m) == picked.end()) picked.push_back(m);
+        }
+        std::vector<int> pre, post;
+        for (long m : picked) {
+            int from = (int)(rng() % width);
+            int to = (int)((from + 1 + rng() % (width - 1)) % width);
+            pre.push_back((int)(m * width + from));
+            post.push_back((int)(m * width + to));
+        }
+        b.transition(pre, post);
+    }
+}
+
+// Transition i (1-based) reads the 'width' places from 7i + 2 and writes the
+// ones from 13i + 7 (1-based, wrapping); the first 2 * width places are
+// marked. With N = 1000 and width 5 this is test_1000_places_worst_case.
+void buildCrossLinked(NetBuilder& b, long n, int width) {
+    long transitions = n / 2;
+    b.reserve(n, transitions);
+    for (long i = 0; i < n; ++i) b.place(i < 2 * width ? 1 : 0);
+    for (long i = 1; i <= transitions; ++i) {
+        std::vector<int> pre, post;
+        for (int k = 0; k < width; ++k) {
+            pre.push_back((int)((7 * i + 1 + k) % n));
+            post.push_back((int)((13 * i + 6 + k) % n));
+        }
+        b.transition(pre, post);
+    }
+}
+
+} // namespace
+
+PetriNet generateNet(const GeneratorOptions& opt) {
+    if (opt.places < 1) throw std::invalid_argument("generateNet: places must be positive");
+    if (opt.places > (1L << 30)) throw std::invalid_argument("generateNet: too many places");
+    if (opt.width < 0 || opt.density < 1) throw std::invalid_argument("generateNet: bad width or density");
+    int width = opt.width > 0 ? opt.width : opt.family == NetFamily::CrossLinked ? 5 : 4;
+
+    PetriNet net;
+    NetBuilder b(net);
+    switch (opt.family) {
+        case NetFamily::Chain:        buildChain(b, opt.places, false); break;
+        case NetFamily::Ring:         buildChain(b, opt.places, true); break;
+        case NetFamily::Philosophers: buildPhilosophers(b, std::max(2L, opt.places / 4)); break;
+        case NetFamily::TokenRing:    buildTokenRing(b, std::max(1L, opt.places / 3)); break;
+        case NetFamily::ForkJoin:     buildForkJoin(b, std::max(1L, opt.places / (1 + 2 * width)), width); break;
+        case NetFamily::RandomSafe: {
+            if (width < 2) throw std::invalid_argument("generateNet: random nets need width >= 2");
+            long machines = std::max(1L, opt.places / width);
+            long transitions = opt.transitions > 0 ? opt.transitions : machines * width;
+            buildRandomSafe(b, machines, width, opt.density, transitions, opt.seed);
+            break;
+        }
+        case NetFamily::CrossLinked:
+            if (opt.places < 2 * width) throw std::invalid_argument("generateNet: cross-linked nets need places >= 2 * width");
+            buildCrossLinked(b, opt.places, width);
+            break;
+    }
+    net.rebuildIndex();
+    return net;
+}
+
+bool parseNetFamily(const std::string& name, NetFamily& family) {
+    static const std::pair<const char*, NetFamily> names[] = {
+        {"chain", NetFamily::Chain}, {"ring", NetFamily::Ring},
+        {"philosophers", NetFamily::Philosophers}, {"tokenring", NetFamily::TokenRing},
+        {"forkjoin", NetFamily::ForkJoin}, {"random", NetFamily::RandomSafe},
+        {"cross", NetFamily::CrossLinked}
+    };
+    for (const auto& n : names) {
+        if (name == n.first) { family = n.second; return true; }
+    }
+    return false;
+}
+
+// --- Writers ---
+
+namespace {
+
+// Output buffer flushed in large blocks; ints through to_chars
+struct OutBuffer {
+    FILE* out;
+    std::string buf;
+    bool ok = true;
+
+    explicit OutBuffer(FILE* f) : out(f) { buf.reserve(1 << 20); }
+
+    OutBuffer& operator<<(const char* s) { buf += s; return flushIfFull(); }
+    OutBuffer& operator<<(const std::string& s) { buf += s; return flushIfFull(); }
+    OutBuffer& operator<<(long v) {
+        char tmp[24];
+        auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        buf.append(tmp, r.ptr);
+        return flushIfFull();
+    }
+
+    OutBuffer& flushIfFull() { return buf.size() >= (1 << 20) ? flush() : *this; }
+    OutBuffer& flush() {
+        if (!buf.empty() && fwrite(buf.data(), 1, buf.size(), out) != buf.size()) ok = false;
+        buf.clear();
+        return *this;
+    }
+};
+
+} // namespace
+
+bool writePNML(const PetriNet& net, const std::string& filename) {
+    FILE* f = fopen(filename.c_str(), "wb");
+    if (!f) return false;
+    OutBuffer out(f);
+    out << "<pnml>\n  <net id=\"net1\" type=\"http://www.pnml.org/version-2009/grammar/ptnet\">\n"
+        << "    <page id=\"page0\">\n";
+    for (size_t p = 0; p < net.place_ids.size(); ++p) {
+        out << "      <place id=\"" << net.place_ids[p] << "\"><initialMarking> <text>"
+            << (long)net.initial_marking[p] << "</text> </initialMarking></place>\n";
+    }
+    for (const auto& t : net.transition_ids) out << "      <transition id=\"" << t << "\"/>\n";
+    long arc = 0;
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+        for (int p : net.pre_matrix[t]) {
+            out << "      <arc id=\"a" << ++arc << "\" source=\"" << net.place_ids[p]
+                << "\" target=\"" << net.transition_ids[t] << "\"/>\n";
+        }
+        for (int p : net.post_matrix[t]) {
+            out << "      <arc id=\"a" << ++arc << "\" source=\"" << net.transition_ids[t]
+                << "\" target=\"" << net.place_ids[p] << "\"/>\n";
+        }
+    }
+    out << "    </page>\n  </net>\n</pnml>\n";
+    out.flush();
+    return fclose(f) == 0 && out.ok;
+}
+
+bool writeNetText(const PetriNet& net, FILE* f) {
+    OutBuffer out(f);
+    out << (long)net.place_ids.size() << " " << (long)net.transition_ids.size() << "\n";
+    for (int v : net.initial_marking) out << (long)v << " ";
+    out << "\n";
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+        out << (long)net.pre_matrix[t].size();
+        for (int p : net.pre_matrix[t]) out << " " << (long)p;
+        out << " " << (long)net.post_matrix[t].size();
+        for (int p : net.post_matrix[t]) out << " " << (long)p;
+        out << "\n";
+    }
+    out.flush();
+    return out.ok && fflush(f) == 0;
+}
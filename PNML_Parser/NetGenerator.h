@@ -0,0 +1,51 @@
+#ifndef NET_GENERATOR_H
+#define NET_GENERATOR_H
+
+#include "PetriNet.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Parametric net families for stress tests and scaling curves. 'places' is
+// the scale; families built from fixed-size units round it down to whole
+// units (at least one). Places are named p1..pN and transitions t1..tT, like
+// the hand-made testcase files.
+enum class NetFamily {
+    Chain,         // p1 -> t1 -> p2 -> ... -> pN, one token on p1 (N states)
+    Ring,          // the chain closed back to p1 (N states, no deadlock)
+    Philosophers,  // dining philosophers taking the left fork first: 4 places each, deadlocks
+    TokenRing,     // stations (idle, busy, token) passing one token: 3 places each
+    ForkJoin,      // cyclic pipeline of stages forking into 'width' parallel branches and joining
+    RandomSafe,    // random synchronisation of state machines, 1-safe by construction
+    CrossLinked    // the dense "worst case" of testcase/: wide transitions on shifted place windows
+};
+
+struct GeneratorOptions {
+    NetFamily family = NetFamily::Chain;
+    long places = 10;
+    int width = 0;          // ForkJoin: branches per stage (default 4); RandomSafe: local states
+                            // per machine (default 4); CrossLinked: input and output places
+                            // per transition (default 5); 0 = the default
+    int density = 2;        // RandomSafe: most machines one transition synchronises
+    long transitions = 0;   // RandomSafe: transition count (0 = one per place)
+    uint64_t seed = 1;      // RandomSafe: same seed, same net
+};
+
+// Builds the net with its index (getPlaceIndex works); throws std::invalid_argument on bad options
+PetriNet generateNet(const GeneratorOptions& opt);
+
+// "chain", "ring", "philosophers", "tokenring", "forkjoin", "random", "cross"
+bool parseNetFamily(const std::string& name, NetFamily& family);
+
+// --- Writers ---
+
+// PNML in the layout of testcase/ (p/t/a ids, one arc per element). Written
+// through one buffer; with the Makefile's -O2 build, generating and writing
+// a million places takes about 1.5-3 s.
+bool writePNML(const PetriNet& net, const std::string& filename);
+
+// Compiled text form read by explicit_worker: "P T", the initial marking,
+// then per transition "n p1..pn m q1..qm" (0-based place indices)
+bool writeNetText(const PetriNet& net, FILE* out);
+
+#endif
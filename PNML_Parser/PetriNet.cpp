@@ -1,5 +1,6 @@
 #include "PetriNet.h"
 #include "tinyxml2.h"
+#include "Trace.h"
 #include <iostream>
 
 using namespace tinyxml2;
@@ -58,11 +59,14 @@ void parseElements(XMLElement* element,
 }
 
 bool PetriNet::parsePNML(const std::string& filename) {
+    TraceSpan span("parse PNML", "parse");
     XMLDocument doc;
+    TraceSpan load("load XML", "parse");
     if (doc.LoadFile(filename.c_str()) != XML_SUCCESS) {
         std::cerr << "Error: Could not load file " << filename << std::endl;
         return false;
     }
+    load.end();
 
     XMLElement* root = doc.FirstChildElement("pnml");
     if (!root) return false;
@@ -73,13 +77,16 @@ bool PetriNet::parsePNML(const std::string& filename) {
     std::vector<Arc> temp_arcs;
 
     // --- PASS 1: Recursive Parse ---
+    TraceSpan elements("read elements", "parse");
     parseElements(net, place_ids, transition_ids, initial_marking, place_map, transition_map, temp_arcs);
+    elements.end();
 
     // Resize matrices
     pre_matrix.assign(transition_ids.size(), std::vector<int>());
     post_matrix.assign(transition_ids.size(), std::vector<int>());
 
     // --- PASS 2: Process Arcs ---
+    TraceSpan arcs("build matrices", "parse");
     for (const auto& arc : temp_arcs) {
         if (place_map.count(arc.source_id) && transition_map.count(arc.target_id)) {
             // Place -> Transition
@@ -94,7 +101,11 @@ bool PetriNet::parsePNML(const std::string& filename) {
             post_matrix[t_idx].push_back(p_idx);
         }
     }
+    arcs.end();
 
+    span.arg("places", place_ids.size());
+    span.arg("transitions", transition_ids.size());
+    span.arg("arcs", temp_arcs.size());
     return verifyConsistency();
 }
 
@@ -117,4 +128,11 @@ int PetriNet::getPlaceIndex(const std::string& id) const {
 int PetriNet::getTransitionIndex(const std::string& id) const {
     if (transition_map.find(id) != transition_map.end()) return transition_map.at(id);
     return -1;
+}
+
+void PetriNet::rebuildIndex() {
+    place_map.clear();
+    transition_map.clear();
+    for (size_t i = 0; i < place_ids.size(); ++i) place_map[place_ids[i]] = i;
+    for (size_t t = 0; t < transition_ids.size(); ++t) transition_map[transition_ids[t]] = t;
 }
\ No newline at end of file
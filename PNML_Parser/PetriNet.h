@@ -40,6 +40,10 @@ public:
     int getPlaceIndex(const std::string& id) const;
     int getTransitionIndex(const std::string& id) const;
 
+    // Refill the ID lookups after place_ids/transition_ids were filled by hand
+    // (e.g. a net built by a reduction instead of parsePNML)
+    void rebuildIndex();
+
 private:
     // Fast lookups used internally during parsing
     std::unordered_map<std::string, int> place_map;
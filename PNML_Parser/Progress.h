@@ -0,0 +1,155 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+// Heartbeat for long runs. Engines publish their counters with relaxed
+// atomic stores (no locks in the hot loops); a ProgressReporter thread
+// samples them every few seconds and prints one line. Header-only, like
+// Trace.h, so the explicit engine can use it without linking the parser.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+// Counters of the running engine; -1 = not published by this engine
+struct ProgressCounters {
+    std::atomic<int64_t> states{-1};     // states stored (explicit) or counted (BDD)
+    std::atomic<int64_t> frontier{-1};   // states queued for expansion
+    std::atomic<int64_t> depth{-1};      // BFS level or fixpoint iteration
+    std::atomic<int64_t> bdd_nodes{-1};  // live nodes of the BDD manager
+    std::atomic<bool> refresh{false};    // set once per printed line: costly values are wanted
+};
+
+inline ProgressCounters& progressCounters() {
+    static ProgressCounters c;
+    return c;
+}
+
+// True at most once per reporter interval (and never without a reporter):
+// the engine may then publish a value that is costly to compute, such as
+// the state count of a BDD. The next line prints it.
+inline bool progressRefreshDue() {
+    ProgressCounters& c = progressCounters();
+    return c.refresh.load(std::memory_order_relaxed) && c.refresh.exchange(false, std::memory_order_relaxed);
+}
+
+// Resident set size of this process in kB (Linux; 0 elsewhere)
+inline long progressRssKb() {
+#ifdef _WIN32
+    return 0;
+#else
+    long pages = 0, resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+// Address-space limit (RLIMIT_AS) in kB; 0 if none is set or on Windows
+inline long progressLimitKb() {
+#ifdef _WIN32
+    return 0;
+#else
+    rlimit lim;
+    if (getrlimit(RLIMIT_AS, &lim) != 0 || lim.rlim_cur == RLIM_INFINITY) return 0;
+    return (long)(lim.rlim_cur / 1024);
+#endif
+}
+
+// Prints "[progress] 12.0 s  states 1234567 (98765/s)  frontier 4567  depth 23
+// nodes 890123  rss 512 MB  memory limit in 40 s" every interval to 'out'
+// (default stderr) until stop() or destruction. Fields the engine does not
+// publish are left out. The state count of a reachability run is not known in
+// advance, so the estimate is the time until the address-space limit
+// (RLIMIT_AS, petri_analyze --memory) at the current RSS growth, if one is set.
+class ProgressReporter {
+public:
+    explicit ProgressReporter(double interval_seconds, FILE* out = stderr)
+        : interval(interval_seconds), out(out) {
+        progressCounters().refresh.store(true, std::memory_order_relaxed);
+        start = Clock::now();
+        worker = std::thread([this] { run(); });
+    }
+    ~ProgressReporter() { stop(); }
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            if (stopping) return;
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+        progressCounters().refresh.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run() {
+        int64_t last_states = 0;
+        long last_rss = progressRssKb();
+        long limit_kb = progressLimitKb();
+        Clock::time_point last = start;
+        std::unique_lock<std::mutex> lock(mu);
+        while (!cv.wait_for(lock, std::chrono::duration<double>(interval), [this] { return stopping; })) {
+            ProgressCounters& c = progressCounters();
+            Clock::time_point now = Clock::now();
+            double elapsed = std::chrono::duration<double>(now - start).count();
+            double dt = std::chrono::duration<double>(now - last).count();
+            int64_t states = c.states.load(std::memory_order_relaxed);
+
+            std::string line = "[progress] " + fixed(elapsed, 1) + " s";
+            if (states >= 0) {
+                double rate = dt > 0 ? (states - last_states) / dt : 0;
+                line += "  states " + std::to_string(states) + " (" + fixed(rate, 0) + "/s)";
+                last_states = states;
+            }
+            append(line, "frontier", c.frontier.load(std::memory_order_relaxed));
+            append(line, "depth", c.depth.load(std::memory_order_relaxed));
+            append(line, "nodes", c.bdd_nodes.load(std::memory_order_relaxed));
+            long rss = progressRssKb();
+            line += "  rss " + std::to_string(rss / 1024) + " MB";
+            double growth = dt > 0 ? (rss - last_rss) / dt : 0; // kB/s
+            if (limit_kb > rss && growth > 0) line += "  memory limit in " + fixed((limit_kb - rss) / growth, 0) + " s";
+            last_rss = rss;
+            line += "\n";
+            fputs(line.c_str(), out);
+            fflush(out);
+            last = now;
+            c.refresh.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    static std::string fixed(double v, int decimals) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        return buf;
+    }
+
+    static void append(std::string& line, const char* name, int64_t v) {
+        if (v >= 0) line += std::string("  ") + name + " " + std::to_string(v);
+    }
+
+    double interval;
+    FILE* out;
+    Clock::time_point start;
+    std::mutex mu;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread worker;
+};
+
+#endif
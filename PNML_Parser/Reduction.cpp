@@ -0,0 +1,435 @@
+#include "Reduction.h"
+#include <algorithm>
+#include <map>
+
+// --- Working copy of the net while rules are applied ---
+// Places keep their original index; agglomerated transitions are appended.
+// Pre/post sets are sorted multisets of place indices.
+struct WorkNet {
+    std::vector<std::string> place_ids;
+    std::vector<int> m0;
+    std::vector<char> place_alive;
+
+    std::vector<std::vector<int>> pre, post;
+    std::vector<std::vector<int>> seq; // original transitions fired by this one
+    std::vector<std::string> name;
+    std::vector<char> trans_alive;
+
+    // Rebuilt by buildAdjacency(): transitions around each place (no duplicates)
+    std::vector<std::vector<int>> producers, consumers;
+
+    int addTransition(std::vector<int> in, std::vector<int> out, std::vector<int> s, const std::string& n) {
+        std::sort(in.begin(), in.end());
+        std::sort(out.begin(), out.end());
+        pre.push_back(in);
+        post.push_back(out);
+        seq.push_back(s);
+        name.push_back(n);
+        trans_alive.push_back(1);
+        return pre.size() - 1;
+    }
+
+    void buildAdjacency() {
+        producers.assign(place_ids.size(), {});
+        consumers.assign(place_ids.size(), {});
+        for (size_t t = 0; t < pre.size(); ++t) {
+            if (!trans_alive[t]) continue;
+            for (int p : pre[t]) {
+                if (consumers[p].empty() || consumers[p].back() != (int)t) consumers[p].push_back(t);
+            }
+            for (int p : post[t]) {
+                if (producers[p].empty() || producers[p].back() != (int)t) producers[p].push_back(t);
+            }
+        }
+    }
+};
+
+static int countOf(const std::vector<int>& v, int p) {
+    return std::count(v.begin(), v.end(), p);
+}
+
+static std::vector<int> without(std::vector<int> v, int p) {
+    v.erase(std::remove(v.begin(), v.end(), p), v.end());
+    return v;
+}
+
+static std::vector<int> joined(const std::vector<int>& a, const std::vector<int>& b) {
+    std::vector<int> out(a);
+    out.insert(out.end(), b.begin(), b.end());
+    return out;
+}
+
+// Remove every arc of place p (p becomes a removed place)
+static void detachPlace(WorkNet& w, int p) {
+    for (int t : w.producers[p]) w.post[t] = without(w.post[t], p);
+    for (int t : w.consumers[p]) w.pre[t] = without(w.pre[t], p);
+    w.place_alive[p] = 0;
+}
+
+// --- Rule 1: empty places without producers, and the transitions they block ---
+static bool removeDeadNodes(WorkNet& w, ReductionResult& res) {
+    w.buildAdjacency();
+    bool changed = false;
+    for (size_t p = 0; p < w.place_ids.size(); ++p) {
+        if (!w.place_alive[p] || w.m0[p] != 0 || !w.producers[p].empty()) continue;
+        for (int t : w.consumers[p]) {
+            if (!w.trans_alive[t]) continue;
+            w.trans_alive[t] = 0;
+            res.log.push_back("dead transition: " + w.name[t]);
+        }
+        w.place_alive[p] = 0;
+        res.removed_places.push_back({(int)p, PlaceRemoval::Empty});
+        res.log.push_back("dead place: " + w.place_ids[p]);
+        changed = true;
+    }
+    return changed;
+}
+
+// --- Rule 2: transitions with exactly the same pre- and post-set ---
+static bool removeDuplicateTransitions(WorkNet& w, ReductionResult& res) {
+    std::map<std::pair<std::vector<int>, std::vector<int>>, int> seen;
+    bool changed = false;
+    for (size_t t = 0; t < w.pre.size(); ++t) {
+        if (!w.trans_alive[t]) continue;
+        auto key = std::make_pair(w.pre[t], w.post[t]);
+        auto it = seen.find(key);
+        if (it == seen.end()) {
+            seen[key] = t;
+            continue;
+        }
+        w.trans_alive[t] = 0;
+        res.log.push_back("duplicate transition: " + w.name[t] + " (same as " + w.name[it->second] + ")");
+        changed = true;
+    }
+    return changed;
+}
+
+// --- Rule 3: implicit places ---
+// A marked place that every transition puts back never blocks anything, and a
+// place with the same arcs as another one but at least as many tokens neither.
+// With equal_m0_only a duplicate must also start with the same tokens: an
+// offset copy is only implicit with unbounded token counts, and the 1-safe
+// BDD engine (which saturates at one token) would count fewer markings.
+static bool removeImplicitPlaces(WorkNet& w, ReductionResult& res, bool equal_m0_only) {
+    w.buildAdjacency();
+    bool changed = false;
+
+    // Signature: (transition, tokens taken, tokens given) around the place
+    std::map<std::vector<std::vector<int>>, std::vector<int>> same_arcs;
+
+    for (size_t p = 0; p < w.place_ids.size(); ++p) {
+        if (!w.place_alive[p]) continue;
+
+        std::vector<int> around(w.producers[p]);
+        around.insert(around.end(), w.consumers[p].begin(), w.consumers[p].end());
+        std::sort(around.begin(), around.end());
+        around.erase(std::unique(around.begin(), around.end()), around.end());
+
+        bool self_loop = w.m0[p] >= 1;
+        std::vector<std::vector<int>> signature;
+        for (int t : around) {
+            int taken = countOf(w.pre[t], p);
+            int given = countOf(w.post[t], p);
+            if (taken != given || taken > w.m0[p]) self_loop = false;
+            signature.push_back({t, taken, given});
+        }
+        if (equal_m0_only) signature.push_back({-1, w.m0[p], 0});
+
+        if (self_loop) {
+            detachPlace(w, p);
+            res.removed_places.push_back({(int)p, PlaceRemoval::Constant, -1, w.m0[p]});
+            res.log.push_back("implicit place (constant): " + w.place_ids[p]);
+            changed = true;
+            continue;
+        }
+        same_arcs[signature].push_back(p);
+    }
+
+    for (auto& entry : same_arcs) {
+        std::vector<int>& places = entry.second;
+        if (places.size() < 2) continue;
+
+        // Keep the least marked place, the others follow it with a fixed offset
+        int keep = places[0];
+        for (int p : places) {
+            if (w.m0[p] < w.m0[keep]) keep = p;
+        }
+        for (int p : places) {
+            if (p == keep) continue;
+            detachPlace(w, p);
+            res.removed_places.push_back({p, PlaceRemoval::Copy, keep, w.m0[p] - w.m0[keep]});
+            res.log.push_back("implicit place (duplicate): " + w.place_ids[p] + " (copy of " + w.place_ids[keep] + ")");
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// --- Rules 4-6: agglomerations and series fusion ---
+// The adjacency is built once per pass; a rule is only applied around places
+// that no earlier rule of the same pass touched, so the adjacency stays valid.
+static bool agglomerate(WorkNet& w, ReductionResult& res) {
+    w.buildAdjacency();
+    std::vector<char> touched(w.place_ids.size(), 0);
+    bool changed = false;
+
+    auto touch = [&](int t) {
+        for (int q : w.pre[t]) touched[q] = 1;
+        for (int q : w.post[t]) touched[q] = 1;
+    };
+
+    for (size_t pi = 0; pi < w.place_ids.size(); ++pi) {
+        int p = pi;
+        if (!w.place_alive[p] || touched[p]) continue;
+        const std::vector<int>& producers = w.producers[p];
+        const std::vector<int>& consumers = w.consumers[p];
+        if (consumers.size() != 1) continue;
+        int f = consumers[0];
+        if (countOf(w.pre[f], p) != 1 || countOf(w.post[f], p) != 0) continue;
+
+        // 6. Series place fusion: *f = {p}, f* = {q}, p* = {f}. Tokens of p
+        // can always move to q, so p is merged into q and f disappears.
+        if (w.pre[f].size() == 1 && w.post[f].size() == 1) {
+            int q = w.post[f][0];
+            touch(f);
+            for (int h : producers) {
+                touch(h);
+                for (int& r : w.post[h]) {
+                    if (r == p) r = q;
+                }
+                std::sort(w.post[h].begin(), w.post[h].end());
+            }
+            w.m0[q] += w.m0[p];
+            w.trans_alive[f] = 0;
+            w.place_alive[p] = 0;
+            res.fusions.push_back({p, q, w.seq[f]});
+            res.removed_places.push_back({p, PlaceRemoval::Merged, q});
+            res.log.push_back("series fusion: " + w.place_ids[p] + " -> " + w.place_ids[q] + " (" + w.name[f] + ")");
+            res.exact_state_count = false;
+            changed = true;
+            continue;
+        }
+
+        if (w.m0[p] != 0 || producers.empty()) continue;
+        bool simple_producers = true;
+        for (int h : producers) {
+            if (countOf(w.post[h], p) != 1) simple_producers = false;
+        }
+        if (!simple_producers) continue;
+
+        // 4. Post-agglomeration: *f = {p}, so f can fire right after any producer
+        if (w.pre[f].size() == 1) {
+            touch(f);
+            for (int h : producers) {
+                touch(h);
+                w.addTransition(w.pre[h], joined(without(w.post[h], p), w.post[f]),
+                                joined(w.seq[h], w.seq[f]), w.name[h] + "." + w.name[f]);
+                w.trans_alive[h] = 0;
+            }
+            w.trans_alive[f] = 0;
+            w.place_alive[p] = 0;
+            res.removed_places.push_back({p, PlaceRemoval::Empty});
+            res.log.push_back("post-agglomeration: " + w.place_ids[p] + " (into " + w.name[f] + ")");
+            res.exact_state_count = false;
+            changed = true;
+            continue;
+        }
+
+        // 5. Pre-agglomeration: h* = {p}, *p = {h}, and the inputs of h feed
+        // nothing else, so h can wait until f is ready to fire.
+        if (producers.size() != 1) continue;
+        int h = producers[0];
+        if (w.post[h].size() != 1 || w.pre[h].empty() || countOf(w.pre[h], p) != 0) continue;
+        bool private_inputs = true;
+        for (int q : w.pre[h]) {
+            if (touched[q] || w.consumers[q].size() != 1) private_inputs = false;
+        }
+        if (!private_inputs) continue;
+
+        touch(h);
+        touch(f);
+        std::vector<int> inputs = w.pre[h];
+        w.addTransition(joined(inputs, without(w.pre[f], p)), w.post[f],
+                        joined(w.seq[h], w.seq[f]), w.name[h] + "." + w.name[f]);
+        w.trans_alive[h] = 0;
+        w.trans_alive[f] = 0;
+        w.place_alive[p] = 0;
+        res.delayed.push_back({inputs, p, w.seq[h]});
+        res.removed_places.push_back({p, PlaceRemoval::Empty});
+        res.log.push_back("pre-agglomeration: " + w.place_ids[p] + " (" + w.name[h] + " delayed into " + w.name[f] + ")");
+        res.exact_state_count = false;
+        changed = true;
+    }
+    return changed;
+}
+
+ReductionResult reduceNet(const PetriNet& net, bool preserve_state_count) {
+    ReductionResult res;
+
+    WorkNet w;
+    w.place_ids = net.place_ids;
+    w.m0 = net.initial_marking;
+    w.place_alive.assign(net.place_ids.size(), 1);
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+        w.addTransition(net.pre_matrix[t], net.post_matrix[t], {(int)t}, net.transition_ids[t]);
+    }
+
+    // Every rule removes at least one node, so this terminates
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        changed |= removeDeadNodes(w, res);
+        changed |= removeDuplicateTransitions(w, res);
+        changed |= removeImplicitPlaces(w, res, preserve_state_count);
+        if (!preserve_state_count) changed |= agglomerate(w, res);
+    }
+
+    // --- Build the reduced PetriNet ---
+    std::vector<int> new_index(w.place_ids.size(), -1);
+    for (size_t p = 0; p < w.place_ids.size(); ++p) {
+        if (!w.place_alive[p]) continue;
+        new_index[p] = res.place_origin.size();
+        res.place_origin.push_back(p);
+        res.net.place_ids.push_back(w.place_ids[p]);
+        res.net.initial_marking.push_back(w.m0[p]);
+    }
+    for (size_t t = 0; t < w.pre.size(); ++t) {
+        if (!w.trans_alive[t]) continue;
+        std::vector<int> in, out;
+        for (int p : w.pre[t]) in.push_back(new_index[p]);
+        for (int p : w.post[t]) out.push_back(new_index[p]);
+        res.net.transition_ids.push_back(w.name[t]);
+        res.net.pre_matrix.push_back(in);
+        res.net.post_matrix.push_back(out);
+        res.transition_origin.push_back(w.seq[t]);
+    }
+    res.net.rebuildIndex();
+
+    return res;
+}
+
+// --- Lifting results back to the original net ---
+
+std::vector<int> ReductionResult::liftMarking(const std::vector<int>& reduced_marking) const {
+    std::vector<int> marking(place_origin.size() + removed_places.size(), 0);
+    for (size_t i = 0; i < place_origin.size(); ++i) marking[place_origin[i]] = reduced_marking[i];
+
+    // Undo removals last-to-first: 'other' is already filled in
+    for (auto it = removed_places.rbegin(); it != removed_places.rend(); ++it) {
+        switch (it->kind) {
+            case PlaceRemoval::Copy:     marking[it->place] = marking[it->other] + it->value; break;
+            case PlaceRemoval::Constant: marking[it->place] = it->value; break;
+            default:                     marking[it->place] = 0; break;
+        }
+    }
+    return marking;
+}
+
+// Replay helper on the original net
+struct Replay {
+    const PetriNet& net;
+    const ReductionResult& res;
+    std::vector<int> marking;
+    std::vector<int> trace;
+
+    bool enabled(int t) const {
+        std::map<int, int> need;
+        for (int p : net.pre_matrix[t]) need[p]++;
+        for (auto& e : need) {
+            if (marking[e.first] < e.second) return false;
+        }
+        return true;
+    }
+
+    void fire(int t) {
+        for (int p : net.pre_matrix[t]) marking[p]--;
+        for (int p : net.post_matrix[t]) marking[p]++;
+        trace.push_back(t);
+    }
+
+    // Bring a token into q by firing the series transitions fused into it
+    bool supply(int q, int depth) {
+        if (depth > (int)res.fusions.size()) return false;
+        for (const auto& fusion : res.fusions) {
+            if (fusion.to_place != q) continue;
+            if (marking[fusion.from_place] == 0 && !supply(fusion.from_place, depth + 1)) continue;
+            if (fireSequence(fusion.sequence, depth + 1)) return true;
+        }
+        return false;
+    }
+
+    bool fireOne(int t, int depth) {
+        while (!enabled(t)) {
+            bool progress = false;
+            for (int p : net.pre_matrix[t]) {
+                if (marking[p] < countOf(net.pre_matrix[t], p) && supply(p, depth)) { progress = true; break; }
+            }
+            if (!progress) return false;
+        }
+        fire(t);
+        return true;
+    }
+
+    bool fireSequence(const std::vector<int>& sequence, int depth) {
+        for (int t : sequence) {
+            if (!fireOne(t, depth)) return false;
+        }
+        return true;
+    }
+};
+
+bool ReductionResult::liftTrace(const PetriNet& original, const std::vector<int>& reduced_trace,
+                                std::vector<int>& original_trace, std::vector<int>& final_marking,
+                                bool deadlock) const {
+    Replay replay{original, *this, original.initial_marking, {}};
+
+    for (int rt : reduced_trace) {
+        if (!replay.fireSequence(transition_origin[rt], 0)) return false;
+    }
+
+    // A reduced deadlock may still have tokens waiting in fused places or
+    // delayed transitions enabled in the original net: fire them.
+    bool progress = deadlock;
+    while (progress) {
+        progress = false;
+        for (const auto& fusion : fusions) {
+            Replay attempt = replay;
+            if (attempt.marking[fusion.from_place] > 0 && attempt.fireSequence(fusion.sequence, 0)) {
+                replay.marking = attempt.marking;
+                replay.trace = attempt.trace;
+                progress = true;
+            }
+        }
+        for (const auto& d : delayed) {
+            Replay attempt = replay;
+            if (attempt.enabled(d.sequence[0]) && attempt.fireSequence(d.sequence, 0)) {
+                replay.marking = attempt.marking;
+                replay.trace = attempt.trace;
+                progress = true;
+            }
+        }
+    }
+
+    // What is still enabled was removed by a reduction (the fusions above
+    // may need a delayed transition that already fired): fire it until the
+    // original marking is dead too. Every such firing moves a token towards
+    // the end of a removed chain, so this is bounded.
+    if (deadlock) {
+        long tokens = 1;
+        for (int v : replay.marking) tokens += v;
+        long limit = tokens * ((long)original.transition_ids.size() + 1);
+        for (long step = 0;; ++step) {
+            int next = -1;
+            for (size_t t = 0; t < original.transition_ids.size() && next < 0; ++t) {
+                if (replay.enabled(t)) next = t;
+            }
+            if (next < 0) break;
+            if (step == limit) return false;
+            replay.fire(next);
+        }
+    }
+
+    original_trace = replay.trace;
+    final_marking = replay.marking;
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "PetriNet.h"
+#include <string>
+#include <vector>
+
+// How a removed place gets its tokens back when lifting a reduced marking.
+// Removals are undone in reverse order, so 'other' is always known by then.
+struct PlaceRemoval {
+    enum Kind {
+        Empty,     // agglomerated or dead place: 0 tokens in the representative state
+        Copy,      // implicit duplicate: M(place) = M(other) + value
+        Constant,  // marked self-loop place: M(place) = value
+        Merged     // series fusion: tokens were moved into 'other'
+    };
+    int place;
+    Kind kind;
+    int other = -1;
+    int value = 0;
+};
+
+// A place p fused into q through the series transition(s) 'sequence' (p -> q)
+struct SeriesFusion {
+    int from_place;
+    int to_place;
+    std::vector<int> sequence;
+};
+
+// A pre-agglomerated transition h (only output p, inputs only used by h).
+// Reduced deadlocks may leave h enabled; firing it gives the original deadlock.
+struct DelayedTransition {
+    std::vector<int> inputs;
+    int place;
+    std::vector<int> sequence;
+};
+
+struct ReductionResult {
+    PetriNet net; // the reduced net
+
+    // --- Mapping back to the original net ---
+    std::vector<int> place_origin;                   // [reduced place] -> original place
+    std::vector<std::vector<int>> transition_origin; // [reduced transition] -> original firing sequence
+    std::vector<PlaceRemoval> removed_places;        // in removal order
+    std::vector<SeriesFusion> fusions;
+    std::vector<DelayedTransition> delayed;
+
+    // True when only rules preserving the state graph were applied (implicit
+    // places, duplicate/dead transitions): the reduced state count is exact.
+    // Agglomerations drop intermediate states, the count is then a lower bound.
+    bool exact_state_count = true;
+
+    std::vector<std::string> log; // one line per applied rule
+
+    // Original marking represented by a reduced marking
+    std::vector<int> liftMarking(const std::vector<int>& reduced_marking) const;
+
+    // Original firing sequence for a reduced one, replayed on 'original'.
+    // With deadlock = true the tail is completed so that the final original
+    // marking is a deadlock whenever the reduced one is.
+    // Returns false if the replay gets stuck (should not happen).
+    bool liftTrace(const PetriNet& original, const std::vector<int>& reduced_trace,
+                   std::vector<int>& original_trace, std::vector<int>& final_marking,
+                   bool deadlock = false) const;
+};
+
+// --- Berthelot-style structural reductions, applied until a fixpoint ---
+// 1. Dead nodes: empty places without producers and their consumers.
+// 2. Redundant transitions: duplicates with the same pre- and post-set.
+// 3. Implicit places: duplicated places and marked self-loop places.
+// 4. Post-agglomeration: p with p* = {f}, *f = {p}, M0(p) = 0 -> h.f for all h in *p.
+// 5. Pre-agglomeration: h* = {p}, *p = {h}, p* = {f}, (*h)* = {h}, M0(p) = 0 -> h.f.
+// 6. Series place fusion: t with *t = {p}, t* = {q}, p* = {t} -> p merged into q.
+// Sound for reachability of the representative markings and for deadlocks
+// (arc weights are 1, as produced by parsePNML).
+// With preserve_state_count only rules 1-3 run, and rule 3 only merges
+// duplicates with the same initial marking: the reduced net then has exactly
+// as many reachable markings as 'net', also under the 1-safe semantics of the
+// BDD engine (exact_state_count stays true).
+ReductionResult reduceNet(const PetriNet& net, bool preserve_state_count = false);
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Scoped spans and counters written in the Chrome trace-event format
+// (chrome://tracing, Perfetto). Header-only, so the explicit engine can use
+// it without linking the parser. While no trace is open a span costs one
+// relaxed atomic load; events are coarse (phases, fixpoint iterations,
+// BFS levels) and go through one mutex-protected buffer when tracing.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+struct TraceState {
+    std::atomic<bool> on{false};
+    std::mutex mu;
+    FILE* out = nullptr;
+    std::string buf;
+    bool first = true;
+    std::chrono::steady_clock::time_point start;
+};
+
+inline TraceState& traceState() {
+    static TraceState s;
+    return s;
+}
+
+inline bool traceEnabled() { return traceState().on.load(std::memory_order_relaxed); }
+
+// Microseconds since traceStart
+inline double traceNow() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - traceState().start).count();
+}
+
+inline int tracePid() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return (int)getpid();
+#endif
+}
+
+// Small per-thread numbers, so viewers show one row per thread
+inline int traceThreadId() {
+    static std::atomic<int> next{0};
+    thread_local int id = ++next;
+    return id;
+}
+
+// JSON string literal of s: quotes, backslashes and control characters
+// escaped (process names hold file paths)
+inline std::string traceQuote(const std::string& s) {
+    std::string q = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') { q += '\\'; q += c; }
+        else if ((unsigned char)c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)(unsigned char)c);
+            q += buf;
+        }
+        else q += c;
+    }
+    return q + "\"";
+}
+
+// One event; 'fields' are the JSON members besides pid and tid
+inline void traceEmit(const std::string& fields) {
+    TraceState& s = traceState();
+    std::lock_guard<std::mutex> lock(s.mu);
+    if (!s.out) return;
+    s.buf += s.first ? "\n" : ",\n";
+    s.first = false;
+    s.buf += "{" + fields + ",\"pid\":" + std::to_string(tracePid()) + ",\"tid\":" + std::to_string(traceThreadId()) + "}";
+    if (s.buf.size() >= (1 << 16)) {
+        fwrite(s.buf.data(), 1, s.buf.size(), s.out);
+        s.buf.clear();
+    }
+}
+
+inline void traceStop();
+
+// Starts writing events to 'path'; process_name labels the process in the
+// viewer. The trace is closed by traceStop or at exit.
+inline bool traceStart(const std::string& path, const std::string& process_name) {
+    TraceState& s = traceState();
+    {
+        std::lock_guard<std::mutex> lock(s.mu);
+        if (s.out) return false;
+        s.out = fopen(path.c_str(), "w");
+        if (!s.out) return false;
+        fputs("[", s.out);
+        s.first = true;
+        s.start = std::chrono::steady_clock::now();
+        static bool registered = false;
+        if (!registered) { registered = true; std::atexit(traceStop); }
+    }
+    s.on.store(true, std::memory_order_relaxed);
+    traceEmit("\"name\":\"process_name\",\"ph\":\"M\",\"args\":{\"name\":" + traceQuote(process_name) + "}");
+    return true;
+}
+
+// Flushes and closes the trace; spans still open are dropped
+inline void traceStop() {
+    TraceState& s = traceState();
+    s.on.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(s.mu);
+    if (!s.out) return;
+    s.buf += "\n]\n";
+    fwrite(s.buf.data(), 1, s.buf.size(), s.out);
+    s.buf.clear();
+    fclose(s.out);
+    s.out = nullptr;
+}
+
+// Value of a counter track (e.g. BDD nodes, frontier size)
+inline void traceCounter(const char* name, double value) {
+    if (!traceEnabled()) return;
+    traceEmit("\"name\":" + traceQuote(name) + ",\"ph\":\"C\",\"ts\":" + std::to_string(traceNow()) +
+              ",\"args\":{\"value\":" + std::to_string(value) + "}");
+}
+
+// A complete ("X") event from construction to end() or destruction
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category) : name(name), category(category) {
+        if (traceEnabled()) { active = true; start = traceNow(); }
+    }
+    ~TraceSpan() { end(); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Shown with the span in the viewer
+    void arg(const char* key, double value) {
+        if (!active) return;
+        args += args.empty() ? "" : ",";
+        args += traceQuote(key) + ":" + std::to_string(value);
+    }
+
+    void end() {
+        if (!active) return;
+        active = false;
+        double now = traceNow();
+        traceEmit("\"name\":" + traceQuote(name) + ",\"cat\":" + traceQuote(category) + ",\"ph\":\"X\",\"ts\":" +
+                  std::to_string(start) + ",\"dur\":" + std::to_string(now - start) + ",\"args\":{" + args + "}");
+    }
+
+private:
+    const char* name;
+    const char* category;
+    bool active = false;
+    double start = 0;
+    std::string args;
+};
+
+#endif
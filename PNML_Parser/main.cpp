@@ -1,11 +1,14 @@
 #include "PetriNet.h"
+#include "Invariants.h"
+#include "Reduction.h"
+#include "Deadlock.h"
 #include <iostream>
 
-int main() {
+int main(int argc, char* argv[]) {
     PetriNet net;
     
-    // PNML file path
-    std::string filename = "pnml/example/examples.pnml"; 
+    // PNML file path (first argument, or the bundled example)
+    std::string filename = argc > 1 ? argv[1] : "pnml/example/examples.pnml"; 
     
     std::cout << "Parsing " << filename << "..." << std::endl;
     
@@ -37,6 +40,44 @@ int main() {
             }
             std::cout << "\n" << std::endl;
         }
+
+        // Structural invariants: y.M = y.M0 for every P-semiflow y
+        SemiflowResult p_flows = computePSemiflows(net);
+        SemiflowResult t_flows = computeTSemiflows(net);
+        std::cout << "P-semiflows (" << p_flows.flows.size()
+                  << (p_flows.complete ? "" : ", incomplete") << "):" << std::endl;
+        for (const auto& flow : p_flows.flows) {
+            std::cout << "  ";
+            for (const auto& w : flow.weights) {
+                std::cout << w.second << "*" << net.place_ids[w.first] << " ";
+            }
+            std::cout << "= " << semiflowValue(flow, net.initial_marking) << std::endl;
+        }
+        std::cout << "T-semiflows: " << t_flows.flows.size()
+                  << (t_flows.complete ? "" : " (incomplete)") << std::endl;
+
+        // Structural reductions (what a reachability engine would explore)
+        ReductionResult reduction = reduceNet(net);
+        std::cout << "\nReduced net: " << reduction.net.place_ids.size() << " places, "
+                  << reduction.net.transition_ids.size() << " transitions" << std::endl;
+        for (const auto& line : reduction.log) {
+            std::cout << "  " << line << std::endl;
+        }
+
+        // Deadlock search on the reduced net, witness lifted to the original net
+        DeadlockWitness deadlock = findDeadlockReduced(net, reduction);
+        if (deadlock.found) {
+            std::cout << "Deadlock reached by " << deadlock.trace.size() << " firings:";
+            for (size_t i = 0; i < deadlock.trace.size() && i < 50; ++i) std::cout << " " << net.transition_ids[deadlock.trace[i]];
+            if (deadlock.trace.size() > 50) std::cout << " ...";
+            std::cout << std::endl;
+        }
+        else if (deadlock.complete) {
+            std::cout << "No deadlock (" << deadlock.states << " reduced markings)" << std::endl;
+        }
+        else {
+            std::cout << "Deadlock search inconclusive after " << deadlock.states << " reduced markings" << std::endl;
+        }
     } else {
         std::cerr << "Parsing failed." << std::endl;
     }
@@ -0,0 +1,277 @@
+// Unit tests of the parser-side analyses (make test). The explicit engine
+// has its own PetriNet class, so these cannot live in its test binary.
+#include "PetriNet.h"
+#include "Reduction.h"
+#include "Deadlock.h"
+#include "Invariants.h"
+#include "NetGenerator.h"
+#include <map>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+using namespace std;
+
+void assertTrue(bool ok, const string& testName) {
+    cout << (ok ? "[PASS] " : "[FAIL] ") << testName << "\n";
+}
+
+// Net built in code: pre/post as lists of places per transition
+PetriNet makeNet(const vector<int>& m0, const vector<vector<int>>& pre, const vector<vector<int>>& post) {
+    PetriNet net;
+    for (size_t p = 0; p < m0.size(); ++p) net.place_ids.push_back("p" + to_string(p));
+    for (size_t t = 0; t < pre.size(); ++t) net.transition_ids.push_back("t" + to_string(t));
+    net.initial_marking = m0;
+    net.pre_matrix = pre;
+    net.post_matrix = post;
+    net.rebuildIndex();
+    return net;
+}
+
+// Replays a trace with its own firing rule; true if it ends in a deadlock
+bool replaysToDeadlock(const PetriNet& net, const vector<int>& trace, const vector<int>& expected) {
+    vector<int> m = net.initial_marking;
+    auto enabled = [&](int t) {
+        vector<int> need(m.size(), 0);
+        for (int p : net.pre_matrix[t]) need[p]++;
+        for (size_t p = 0; p < m.size(); ++p) if (m[p] < need[p]) return false;
+        return true;
+    };
+    for (int t : trace) {
+        if (!enabled(t)) return false;
+        for (int p : net.pre_matrix[t]) m[p]--;
+        for (int p : net.post_matrix[t]) m[p]++;
+    }
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) if (enabled(t)) return false;
+    return m == expected;
+}
+
+// Reachable markings under the 1-safe semantics of the BDD engine: a
+// transition needs a token in every input, empties its inputs, then marks
+// its outputs (a place never holds more than one token)
+size_t safeStateCount(const PetriNet& net) {
+    vector<int> m0 = net.initial_marking;
+    for (int& v : m0) v = v > 0;
+    set<vector<int>> seen = {m0};
+    vector<vector<int>> stack = {m0};
+    while (!stack.empty()) {
+        vector<int> m = stack.back();
+        stack.pop_back();
+        for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+            bool enabled = true;
+            for (int p : net.pre_matrix[t]) enabled = enabled && m[p];
+            if (!enabled) continue;
+            vector<int> next = m;
+            for (int p : net.pre_matrix[t]) next[p] = 0;
+            for (int p : net.post_matrix[t]) next[p] = 1;
+            if (seen.insert(next).second) stack.push_back(next);
+        }
+    }
+    return seen.size();
+}
+
+// C[p][t] = tokens t puts into p - tokens t takes from p
+vector<vector<long long>> incidence(const PetriNet& net) {
+    vector<vector<long long>> c(net.place_ids.size(), vector<long long>(net.transition_ids.size(), 0));
+    for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+        for (int p : net.pre_matrix[t]) c[p][t]--;
+        for (int p : net.post_matrix[t]) c[p][t]++;
+    }
+    return c;
+}
+
+// Supports of the semiflows, as sorted index lists
+set<vector<int>> supports(const SemiflowResult& r) {
+    set<vector<int>> out;
+    for (const auto& f : r.flows) {
+        vector<int> s;
+        for (const auto& w : f.weights) s.push_back(w.first);
+        out.insert(s);
+    }
+    return out;
+}
+
+// Two processes sharing a mutex: p0 idle1, p1 crit1, p2 idle2, p3 crit2,
+// p4 mutex; t0/t1 enter/leave for process 1, t2/t3 for process 2
+PetriNet mutexNet() {
+    return makeNet({1, 0, 1, 0, 1},
+                   {{0, 4}, {1}, {2, 4}, {3}},
+                   {{1}, {0, 4}, {3}, {2, 4}});
+}
+
+// Standard firing rule (a transition moves one token per arc): true if no
+// reachable marking puts two tokens on a place
+bool isOneSafe(const PetriNet& net) {
+    set<vector<int>> seen = {net.initial_marking};
+    vector<vector<int>> stack = {net.initial_marking};
+    while (!stack.empty()) {
+        vector<int> m = stack.back();
+        stack.pop_back();
+        for (int v : m) if (v > 1) return false;
+        for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+            map<int, int> need;
+            for (int p : net.pre_matrix[t]) need[p]++;
+            bool enabled = true;
+            for (const auto& n : need) enabled = enabled && m[n.first] >= n.second;
+            if (!enabled) continue;
+            vector<int> next = m;
+            for (int p : net.pre_matrix[t]) next[p]--;
+            for (int p : net.post_matrix[t]) next[p]++;
+            if (seen.insert(next).second) stack.push_back(next);
+        }
+    }
+    return true;
+}
+
+/* ===============================
+        TEST CASES
+   =============================== */
+
+// Chain p0 -> ... -> p5: collapses completely, the lifted witness fires the whole chain
+void test_Reduction_1() {
+    PetriNet net = makeNet({1, 0, 0, 0, 0, 0},
+                           {{0}, {1}, {2}, {3}, {4}},
+                           {{1}, {2}, {3}, {4}, {5}});
+    ReductionResult red = reduceNet(net);
+    DeadlockWitness w = findDeadlockReduced(net, red);
+    assertTrue(red.net.place_ids.size() < net.place_ids.size(), "Reduction Test 1 (chain reduced)");
+    assertTrue(w.found && w.trace == vector<int>({0, 1, 2, 3, 4}), "Reduction Test 1 (lifted trace)");
+    assertTrue(replaysToDeadlock(net, w.trace, {0, 0, 0, 0, 0, 1}), "Reduction Test 1 (replay on original)");
+}
+
+// Fork/join where the join also waits for t5, whose input only feeds t5
+// (a pre-agglomeration candidate)
+void test_Reduction_2() {
+    PetriNet net = makeNet({1, 0, 0, 0, 0, 0, 0, 0, 1},
+                           {{0}, {1}, {2}, {3}, {4, 5, 7}, {8}},
+                           {{1, 2}, {3}, {4}, {5}, {6}, {7}});
+    ReductionResult red = reduceNet(net);
+    DeadlockWitness direct = findDeadlock(net);
+    DeadlockWitness w = findDeadlockReduced(net, red);
+    assertTrue(!red.log.empty(), "Reduction Test 2 (rules applied)");
+    assertTrue(direct.found && w.found, "Reduction Test 2 (deadlock kept)");
+    assertTrue(replaysToDeadlock(net, w.trace, w.marking), "Reduction Test 2 (replay on original)");
+}
+
+// Count-preserving rules only: same number of reachable markings, and an
+// implicit copy place is dropped
+void test_Reduction_3() {
+    // p0 <-> p1 cycle, p2 follows p0, t2 duplicates t0
+    PetriNet net = makeNet({1, 0, 1},
+                           {{0, 2}, {1}, {0, 2}},
+                           {{1}, {0, 2}, {1}});
+    ReductionResult red = reduceNet(net, /*preserve_state_count=*/true);
+    DeadlockWitness original = findDeadlock(net), reduced = findDeadlock(red.net);
+    assertTrue(red.exact_state_count && red.net.place_ids.size() == 2 && red.net.transition_ids.size() == 2,
+               "Reduction Test 3 (implicit place and duplicate removed)");
+    assertTrue(!original.found && !reduced.found && original.states == reduced.states,
+               "Reduction Test 3 (state count kept)");
+}
+
+// p0 and p1 have the same arcs but not the same initial marking: merging
+// them is sound with token counts, not under the 1-safe semantics
+void test_Reduction_4() {
+    PetriNet net = makeNet({1, 0, 0},
+                           {{0, 1}, {0, 1}, {}},
+                           {{}, {2}, {0, 1}});
+    ReductionResult red = reduceNet(net, /*preserve_state_count=*/true);
+    assertTrue(red.exact_state_count && red.net.place_ids.size() == 3,
+               "Reduction Test 4 (offset copy kept)");
+    assertTrue(safeStateCount(net) == 5 && safeStateCount(red.net) == 5,
+               "Reduction Test 4 (1-safe state count kept)");
+}
+
+// P-semiflows: y.C = 0, exactly the three minimal supports
+void test_Invariants_1() {
+    PetriNet net = mutexNet();
+    vector<vector<long long>> c = incidence(net);
+    SemiflowResult r = computePSemiflows(net);
+    bool zero = r.complete;
+    for (const auto& f : r.flows) {
+        for (size_t t = 0; t < net.transition_ids.size(); ++t) {
+            long long sum = 0;
+            for (const auto& w : f.weights) sum += w.second * c[w.first][t];
+            zero = zero && sum == 0;
+        }
+    }
+    assertTrue(zero, "Invariants Test 1 (y.C = 0)");
+    assertTrue(supports(r) == set<vector<int>>({{0, 1}, {2, 3}, {1, 3, 4}}),
+               "Invariants Test 1 (minimal supports only)");
+    assertTrue(semiflowValue(r.flows[0], net.initial_marking) == 1 &&
+               provesUnreachable(r.flows, net.initial_marking, {0, 1, 0, 1, 0}),
+               "Invariants Test 1 (both critical sections unreachable)");
+}
+
+// T-semiflows: C.x = 0, one enter/leave cycle per process; the sum of the
+// two cycles is not minimal
+void test_Invariants_2() {
+    PetriNet net = mutexNet();
+    vector<vector<long long>> c = incidence(net);
+    SemiflowResult r = computeTSemiflows(net);
+    bool zero = r.complete;
+    for (const auto& f : r.flows) {
+        for (size_t p = 0; p < net.place_ids.size(); ++p) {
+            long long sum = 0;
+            for (const auto& w : f.weights) sum += c[p][w.first] * w.second;
+            zero = zero && sum == 0;
+        }
+    }
+    assertTrue(zero, "Invariants Test 2 (C.x = 0)");
+    set<vector<int>> s = supports(r);
+    assertTrue(s == set<vector<int>>({{0, 1}, {2, 3}}) && !s.count({0, 1, 2, 3}),
+               "Invariants Test 2 (minimal supports only)");
+}
+
+// Too small a max_rows stops the elimination and says so
+void test_Invariants_3() {
+    SemiflowResult r = computePSemiflows(mutexNet(), 2);
+    assertTrue(!r.complete && r.flows.empty(), "Invariants Test 3 (max_rows cutoff)");
+}
+
+// cross 1000 is the hand-made worst case of the BDD testcases
+void test_Generator_1() {
+    GeneratorOptions opt;
+    opt.family = NetFamily::CrossLinked;
+    opt.places = 1000;
+    PetriNet gen = generateNet(opt);
+    PetriNet file;
+    bool parsed = file.parsePNML("../SymbolicComputationUsingBDD/testcase/test_1000_places_worst_case.pnml");
+    assertTrue(parsed && gen.place_ids == file.place_ids && gen.transition_ids == file.transition_ids &&
+               gen.initial_marking == file.initial_marking && gen.pre_matrix == file.pre_matrix &&
+               gen.post_matrix == file.post_matrix,
+               "Generator Test 1 (cross 1000 = test_1000_places_worst_case.pnml)");
+}
+
+// Random nets are 1-safe by construction, for any seed and density
+void test_Generator_2() {
+    bool safe = true;
+    for (uint64_t seed = 1; seed <= 5; ++seed) {
+        GeneratorOptions opt;
+        opt.family = NetFamily::RandomSafe;
+        opt.places = 16;
+        opt.density = 1 + (int)(seed % 3);
+        opt.seed = seed;
+        safe = safe && isOneSafe(generateNet(opt));
+    }
+    assertTrue(safe, "Generator Test 2 (random nets are 1-safe)");
+}
+
+int main() {
+    cout << "====== Running Reduction Tests ======\n";
+    test_Reduction_1();
+    test_Reduction_2();
+    test_Reduction_3();
+    test_Reduction_4();
+
+    cout << "\n====== Running Invariant Tests ======\n";
+    test_Invariants_1();
+    test_Invariants_2();
+    test_Invariants_3();
+
+    cout << "\n====== Running Generator Tests ======\n";
+    test_Generator_1();
+    test_Generator_2();
+
+    cout << "\nAll tests completed.\n";
+    return 0;
+}
@@ -1,41 +1,75 @@
 #include "BDD_Reachability.h"
+#include "BddCheckpoint.h"
+#include "PNML_Parser/Progress.h"
+#include "PNML_Parser/Trace.h"
 #include <iostream>
 #include <algorithm> // For std::find
+#include <chrono>
+#include <memory>
 
 // Constructor
-BDDReachability::BDDReachability(PetriNet& net) : pn(net) {
-    // 1. Initialize CUDD Manager
-    // 0,0 are default parameters for memory management
-    manager = Cudd(0, 0);
-
-    // 2. Create Variables
-    // We need 2 variables per Place: x_i (current) and y_i (next).
-    // Mapping: Place index i -> x is (2*i), y is (2*i + 1)
-    int num_places = pn.place_ids.size();
-    
-    for (int i = 0; i < num_places; ++i) {
+BDDReachability::BDDReachability(PetriNet& net, bool log_encoding) : pn(net) {
+    // 1. The BDD manager starts empty (default sizes for memory management)
+
+    // 2. Choose the Variable Layout
+    // One-hot: one bit per place. Log encoding: 1-of-k groups share ceil(log2 k) bits.
+    std::vector<std::vector<int>> groups;
+    if (log_encoding) groups = find_exclusive_groups(pn);
+    encoding = build_encoding(pn, groups);
+
+    // 3. Create Variables
+    // We need 2 variables per bit: x_i (current) and y_i (next).
+    // Mapping: Bit index i -> x is (2*i), y is (2*i + 1)
+    for (int i = 0; i < encoding.num_bits; ++i) {
         x_vars.push_back(manager.bddVar(2 * i));     
         y_vars.push_back(manager.bddVar(2 * i + 1)); 
     }
 }
 
+BDD BDDReachability::group_code(int g, int code, const std::vector<BDD>& vars) const {
+    // Bit b of the code (LSB first) lives in vars[first + b]
+    BDD cube = manager.bddOne();
+    int first = encoding.group_first_bit[g];
+    for (int b = 0; b < encoding.group_width[g]; ++b) {
+        if ((code >> b) & 1) cube *= vars[first + b];
+        else                 cube *= !vars[first + b];
+    }
+    return cube;
+}
+
+BDD BDDReachability::place_marked(int p, const std::vector<BDD>& vars) const {
+    int g = encoding.group_of[p];
+    if (g == -1) return vars[encoding.bit_of[p]];
+    return group_code(g, encoding.code_of[p], vars);
+}
+
 std::pair<BDD, double> BDDReachability::compute_reachable_markings() {
     int num_places = pn.place_ids.size();
     int num_transitions = pn.transition_ids.size();
+    int num_groups = encoding.groups.size();
 
     // --- STEP 1: Encode Initial Marking (M0) ---
+    TraceSpan initial_span("initial marking", "bdd");
     // Logic: AND all places. If M0[i]=1 then x_i, else !x_i
+    // A group stores the code of its (only) marked place instead.
     BDD M0_bdd = manager.bddOne();
     for (int i = 0; i < num_places; ++i) {
-        if (pn.initial_marking[i] == 1) { //  Accessing initial_marking vector
-            M0_bdd *= x_vars[i];
+        if (encoding.group_of[i] != -1) {
+            if (pn.initial_marking[i] == 1) M0_bdd *= place_marked(i, x_vars);
+        }
+        else if (pn.initial_marking[i] == 1) { //  Accessing initial_marking vector
+            M0_bdd *= x_vars[encoding.bit_of[i]];
         } else {
-            M0_bdd *= !x_vars[i];
+            M0_bdd *= !x_vars[encoding.bit_of[i]];
         }
     }
 
+    initial_span.end();
+
     // --- STEP 2: Build Global Transition Relation (R) ---
     // R(x, y) = OR ( Relation_of_Transition_t )
+    TraceSpan relation_span("transition relation", "bdd");
+    ProgressCounters& progress = progressCounters(); // heartbeat, see Progress.h
     BDD Relation = manager.bddZero();
 
     for (int t = 0; t < num_transitions; ++t) {
@@ -46,75 +80,211 @@ std::pair<BDD, double> BDDReachability::compute_reachable_markings() {
         std::vector<bool> is_input(num_places, false);
         std::vector<bool> is_output(num_places, false);
 
+        // Place of each group that receives the token (-1: group untouched)
+        std::vector<int> group_target(num_groups, -1);
+
         // A. Analyze Input Arcs (Pre-set) -> Accessing pre_matrix 
         // pre_matrix[t] contains indices of places inputting to transition t
         for (int p_idx : pn.pre_matrix[t]) {
             is_input[p_idx] = true;
             // Condition to fire: Input place must have a token
-            t_enabled *= x_vars[p_idx]; 
+            t_enabled *= place_marked(p_idx, x_vars); 
         }
 
         // B. Analyze Output Arcs (Post-set) -> Accessing post_matrix 
         for (int p_idx : pn.post_matrix[t]) {
             is_output[p_idx] = true;
+            if (encoding.group_of[p_idx] != -1) group_target[encoding.group_of[p_idx]] = p_idx;
         }
 
-        // C. Define Logic for Next State (y) for ALL places
+        // C. Define Logic for Next State (y) for ALL places, one constraint per bit
+        std::vector<BDD> next_bit(encoding.num_bits);
         for (int p = 0; p < num_places; ++p) {
+            if (encoding.group_of[p] != -1) continue; // handled per group below
+
+            int bit = encoding.bit_of[p];
+            BDD x = x_vars[bit];
+            BDD y = y_vars[bit];
+
             // Case 1: Input but not Output -> Token Consumed -> y = 0
             if (is_input[p] && !is_output[p]) {
-                t_change *= !y_vars[p];
+                next_bit[bit] = !y;
             }
             // Case 2: Output but not Input -> Token Produced -> y = 1
             else if (!is_input[p] && is_output[p]) {
-                t_change *= y_vars[p];
+                next_bit[bit] = y;
             }
             // Case 3: Both Input and Output (Self-loop) -> Token stays -> y = 1
             else if (is_input[p] && is_output[p]) {
-                t_change *= y_vars[p]; 
+                next_bit[bit] = y;
             }
             // Case 4: Not involved -> Frame Condition -> y = x (State doesn't change)
             else {
-                t_change *= (x_vars[p].Xnor(y_vars[p]));
+                next_bit[bit] = x.Xnor(y);
             }
         }
 
+        // D. Groups: the token moves to the output place, or the code is kept.
+        // (Detection guarantees a transition takes and gives back one token per group.)
+        for (int g = 0; g < num_groups; ++g) {
+            int first = encoding.group_first_bit[g];
+            for (int b = 0; b < encoding.group_width[g]; ++b) {
+                if (group_target[g] != -1) {
+                    bool set = (encoding.code_of[group_target[g]] >> b) & 1;
+                    next_bit[first + b] = set ? y_vars[first + b] : !y_vars[first + b];
+                } else {
+                    next_bit[first + b] = x_vars[first + b].Xnor(y_vars[first + b]);
+                }
+            }
+        }
+
+        // E. Conjoin from the last bit up: each step puts one bit on top of
+        // the chain instead of walking it to the bottom (linear, not quadratic)
+        for (int bit = encoding.num_bits - 1; bit >= 0; --bit) t_change *= next_bit[bit];
+
         // Add this transition's logic to the global relation
         Relation += (t_enabled * t_change);
+        progress.bdd_nodes.store(manager.ReadNodeCount(), std::memory_order_relaxed);
+    }
+    if (traceEnabled()) {
+        relation_span.arg("transitions", num_transitions);
+        relation_span.arg("nodes", Relation.nodeCount());
     }
+    relation_span.end();
 
     // --- STEP 3: Symbolic BFS (Fixed Point Iteration) ---
     BDD Reachable = M0_bdd;
     BDD OldReachable = manager.bddZero();
+    int iterations = 0;
+
+    // Resume: the fixpoint only depends on Reachable, so continuing from a
+    // saved Reachable gives the same result
+    std::unique_ptr<BddCheckpointer> checkpoint;
+    if (!checkpoint_path.empty()) {
+        checkpoint.reset(new BddCheckpointer(manager, checkpoint_path, fingerprint(), checkpoint_resume));
+        if (checkpoint->resumed()) {
+            Reachable = checkpoint->resumed_states();
+            iterations = checkpoint->resumed_iteration();
+            if (checkpoint->resumed_finished()) OldReachable = Reachable;
+        }
+    }
+    auto last_checkpoint = std::chrono::steady_clock::now();
 
     // Create a "cube" of all x variables for existential abstraction
     BDD cube_x = manager.bddOne();
     for (const auto& x : x_vars) cube_x *= x;
+    std::vector<BDD> relations = {Relation};
 
-    int iterations = 0;
     while (Reachable != OldReachable) {
         OldReachable = Reachable;
         iterations++;
+        TraceSpan iteration_span("fixpoint iteration", "bdd");
 
-        // 1. Image Computation: Find Next States (in terms of y)
-        // Next(y) = Exist x . (Reachable(x) AND Relation(x,y))
-        BDD Next_y = Reachable.AndAbstract(Relation, cube_x);
+        // 1. Image Computation: Next(y) = Exist x . (Reachable(x) AND Relation(x,y))
+        // 2. Rename y -> x for the next loop
+        // 3. Union: Add new states to Reachable set
+        // (one fused pass per relation on the native package, see BddBackend.h)
+        Reachable = bdd_image_union(Reachable, relations, cube_x, y_vars, x_vars);
 
-        // 2. Swap Variables: Convert Next(y) -> Next(x) for the next loop
-        // We prepare vectors for swap
-        std::vector<BDD> from_y = y_vars;
-        std::vector<BDD> to_x = x_vars;
-        BDD Next_x = Next_y.SwapVariables(from_y, to_x);
+        // Per-iteration sizes go to the trace (node counts walk the BDD, so only when tracing)
+        if (traceEnabled()) {
+            iteration_span.arg("iteration", iterations);
+            iteration_span.arg("reachable_nodes", Reachable.nodeCount());
+            traceCounter("BDD nodes", manager.ReadNodeCount());
+        }
+        progress.depth.store(iterations, std::memory_order_relaxed);
+        progress.bdd_nodes.store(manager.ReadNodeCount(), std::memory_order_relaxed);
+        // counting walks the whole set: once per printed line, not per iteration
+        if (progressRefreshDue()) progress.states.store((int64_t)Reachable.CountMinterm(encoding.num_bits), std::memory_order_relaxed);
 
-        // 3. Union: Add new states to Reachable set
-        Reachable = Reachable + Next_x;
-        
-        // Debug info (optional)
-        // std::cout << "Iteration " << iterations << "..." << std::endl;
+        // 4. Periodic checkpoint (written in the background)
+        if (checkpoint) {
+            auto now = std::chrono::steady_clock::now();
+            if (std::chrono::duration<double>(now - last_checkpoint).count() >= checkpoint_seconds) {
+                checkpoint->save(Reachable, iterations, false);
+                last_checkpoint = now;
+            }
+        }
     }
+    if (checkpoint) {
+        checkpoint->save(Reachable, iterations, true);
+        checkpoint->drain();
+    }
+    iterations_done = iterations;
 
     // --- STEP 4: Count States ---
-    double num_states = Reachable.CountMinterm(num_places);
+    // Every reachable marking has exactly one assignment of the x bits
+    TraceSpan count_span("count states", "bdd");
+    double num_states = Reachable.CountMinterm(encoding.num_bits);
     
     return {Reachable, num_states};
-}
\ No newline at end of file
+}
+
+std::vector<std::vector<int>> BDDReachability::decode_markings(const BDD& states, size_t limit) const {
+    std::vector<std::vector<int>> markings;
+    int num_places = pn.place_ids.size();
+
+    // Walk the x bits in order, splitting on each one (x_i = 0 / x_i = 1).
+    // Stack entry: {remaining BDD, next bit, value chosen for the previous bit}
+    struct Entry { BDD f; int level; int value; };
+    std::vector<Entry> stack = {{states, 0, 0}};
+    std::vector<int> chosen; // bit values along the current path
+    while (!stack.empty() && markings.size() < limit) {
+        Entry e = stack.back();
+        stack.pop_back();
+        chosen.resize(e.level);
+        if (e.level > 0) chosen[e.level - 1] = e.value;
+
+        if (e.f.IsZero()) continue;
+
+        if (e.level < encoding.num_bits) {
+            stack.push_back({e.f.Cofactor(x_vars[e.level]), e.level + 1, 1});
+            stack.push_back({e.f.Cofactor(!x_vars[e.level]), e.level + 1, 0});
+            continue;
+        }
+
+        // Full assignment of the bits -> one marking
+        std::vector<int> marking(num_places, 0);
+        for (int p = 0; p < num_places; ++p) {
+            if (encoding.group_of[p] == -1) marking[p] = chosen[encoding.bit_of[p]];
+        }
+        for (size_t g = 0; g < encoding.groups.size(); ++g) {
+            int code = 0;
+            for (int b = 0; b < encoding.group_width[g]; ++b) {
+                code |= chosen[encoding.group_first_bit[g] + b] << b;
+            }
+            if (code < (int)encoding.groups[g].size()) marking[encoding.groups[g][code]] = 1;
+        }
+        markings.push_back(marking);
+    }
+
+    return markings;
+}
+
+void BDDReachability::enable_checkpoints(const std::string& path, double interval_seconds, bool resume) {
+    checkpoint_path = path;
+    checkpoint_seconds = interval_seconds;
+    checkpoint_resume = resume;
+}
+
+uint64_t BDDReachability::fingerprint() const {
+    // FNV-1a over the net structure, M0 and the bit layout
+    uint64_t h = 1469598103934665603ull;
+    auto add = [&](long long v) { h ^= (uint64_t)v; h *= 1099511628211ull; };
+    add(pn.place_ids.size());
+    add(pn.transition_ids.size());
+    for (size_t t = 0; t < pn.transition_ids.size(); ++t) {
+        add(-1);
+        for (int p : pn.pre_matrix[t]) add(p);
+        add(-2);
+        for (int p : pn.post_matrix[t]) add(p);
+    }
+    for (int v : pn.initial_marking) add(v);
+    add(encoding.num_bits);
+    for (size_t p = 0; p < encoding.group_of.size(); ++p) {
+        add(encoding.group_of[p]);
+        add(encoding.code_of[p]);
+        add(encoding.bit_of[p]);
+    }
+    return h;
+}
@@ -2,24 +2,61 @@
 #define BDD_REACHABILITY_H
 
 #include "PNML_Parser/PetriNet.h" 
+#include "PlaceEncoding.h"
+#include "BddBackend.h"
 
-#include <cuddObj.hh> 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 class BDDReachability {
 private:
-    Cudd manager;           // BDD manager
+    BddManager manager;     // BDD manager (native, parallel or CUDD, see BddBackend.h)
     PetriNet& pn;
 
-    // Save BDD: x (Temp), y (Next)
+    // Which bits store which places (one-hot or log-encoded groups)
+    PlaceEncoding encoding;
+
+    // Save BDD per encoding bit: x (Temp), y (Next)
     std::vector<BDD> x_vars; 
     std::vector<BDD> y_vars;
 
+    // "Place p holds a token", expressed over x_vars or y_vars
+    BDD place_marked(int p, const std::vector<BDD>& vars) const;
+    // "Group g stores code c", expressed over x_vars or y_vars
+    BDD group_code(int g, int code, const std::vector<BDD>& vars) const;
+
+    // Checkpoints of the fixpoint (see BddCheckpoint.h)
+    std::string checkpoint_path;
+    double checkpoint_seconds = 60;
+    bool checkpoint_resume = false;
+    int iterations_done = 0;
+    // Identifies the net and the variable layout of a checkpoint
+    uint64_t fingerprint() const;
+
 public:
-    BDDReachability(PetriNet& net);
+    // log_encoding: store 1-of-k place groups on ceil(log2 k) bits
+    BDDReachability(PetriNet& net, bool log_encoding = true);
+
+    // Save Reachable and the iteration count to <path>.nodes / <path>.ckpt
+    // at most every interval_seconds (0 = every iteration). With resume, the
+    // next compute_reachable_markings() continues from the last checkpoint.
+    void enable_checkpoints(const std::string& path, double interval_seconds = 60, bool resume = false);
+
+    // Worker threads of the BDD package (parallel package only, see BddBackend.h)
+    void set_threads(int n) { bdd_set_workers(manager, n); }
 
     // Return Pair <BDD (show status), double (count)>
     std::pair<BDD, double> compute_reachable_markings();
+    int get_iterations() const { return iterations_done; }
+    // Most BDD nodes alive at once in the manager so far
+    long get_peak_nodes() const { return manager.ReadPeakNodeCount(); }
+
+    // Decode up to 'limit' markings (one int per place) of a BDD over x_vars
+    std::vector<std::vector<int>> decode_markings(const BDD& states, size_t limit) const;
+
+    const PlaceEncoding& get_encoding() const { return encoding; }
+    int num_bits() const { return encoding.num_bits; }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,78 @@
+#ifndef BDD_BACKEND_H
+#define BDD_BACKEND_H
+
+// The BDD package of the symbolic engine: the native package (NativeBdd.h)
+// by default, its multi-core variant (ParallelBdd.h) when built with
+// -DUSE_PARALLEL_BDD (make BDD=parallel), CUDD when built with -DUSE_CUDD
+// (make BDD=cudd). All provide the BDD operations under CUDD's names; the
+// few places that differ go through the helpers below.
+
+#include <cstdint>
+#include <vector>
+
+#ifdef USE_CUDD
+#include <cuddObj.hh>
+using BddManager = Cudd;
+#elif defined(USE_PARALLEL_BDD)
+#include "ParallelBdd.h"
+using BddManager = ParallelBddManager;
+using BDD = ParallelBdd;
+#else
+#include "NativeBdd.h"
+using BddManager = NativeBddManager;
+using BDD = NativeBdd;
+#endif
+
+// Worker threads of the package; 0 keeps its default. The single-threaded
+// packages ignore it.
+inline void bdd_set_workers(BddManager& manager, int n) {
+#ifdef USE_PARALLEL_BDD
+    if (n > 0) manager.setWorkers(n);
+#else
+    (void)manager;
+    (void)n;
+#endif
+}
+
+// states or the images of states under every relation: exists cube . (states
+// and R), with the next-state variables 'from' renamed to 'to'.
+// Native and parallel: one fused relational product per relation.
+inline BDD bdd_image_union(const BDD& states, const std::vector<BDD>& relations, const BDD& cube,
+                           const std::vector<BDD>& from, const std::vector<BDD>& to) {
+#ifdef USE_CUDD
+    BDD result = states;
+    for (const auto& r : relations) result += states.AndAbstract(r, cube).SwapVariables(from, to);
+    return result;
+#else
+    return states.ImageUnion(relations, cube, from, to);
+#endif
+}
+
+// --- Raw diagram walk (checkpoint files) ---
+// An edge is a node plus a complement bit; regular edges name the nodes.
+
+#ifdef USE_CUDD
+using BddEdge = DdNode*;
+inline BddEdge bdd_edge(const BDD& f) { return f.getNode(); }
+inline BddEdge bdd_regular(BddEdge e) { return Cudd_Regular(e); }
+inline bool bdd_is_complement(BddEdge e) { return Cudd_IsComplement(e); }
+inline bool bdd_is_constant(BddEdge e) { return Cudd_IsConstant(Cudd_Regular(e)); }
+// value of a regular constant edge
+inline bool bdd_constant_value(BddEdge e) { return Cudd_V(e) != 0; }
+inline unsigned bdd_var(const BddManager&, BddEdge e) { return Cudd_NodeReadIndex(e); }
+inline BddEdge bdd_then(const BddManager&, BddEdge e) { return Cudd_T(e); }
+inline BddEdge bdd_else(const BddManager&, BddEdge e) { return Cudd_E(e); }
+#else
+using BddEdge = uint32_t;
+inline BddEdge bdd_edge(const BDD& f) { return f.getEdge(); }
+inline BddEdge bdd_regular(BddEdge e) { return BddManager::edgeRegular(e); }
+inline bool bdd_is_complement(BddEdge e) { return BddManager::edgeIsComplement(e); }
+inline bool bdd_is_constant(BddEdge e) { return BddManager::edgeIsConstant(e); }
+inline bool bdd_constant_value(BddEdge) { return true; } // zero is the complemented one
+inline unsigned bdd_var(const BddManager& m, BddEdge e) { return m.edgeVar(e); }
+// children of a regular node
+inline BddEdge bdd_then(const BddManager& m, BddEdge e) { return m.edgeThen(e); }
+inline BddEdge bdd_else(const BddManager& m, BddEdge e) { return m.edgeElse(e); }
+#endif
+
+#endif
@@ -0,0 +1,246 @@
+#include "BddCheckpoint.h"
+#include <cstring>
+#include <stdexcept>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// --- File layout ---
+struct CheckpointHeader {
+    char magic[8];         // "PNBDDCK1"
+    uint64_t fingerprint;
+    uint64_t iteration;
+    uint64_t node_count;   // valid records in <path>.nodes
+    uint64_t root;         // edge of the Reachable BDD
+    uint64_t finished;     // the fixpoint was reached
+};
+
+static const char BDD_CHECKPOINT_MAGIC[8] = {'P','N','B','D','D','C','K','1'};
+
+// Edges: 0 = constant one, 1 = constant zero, ((k + 1) << 1) | complement for record k
+static const uint32_t EDGE_ONE = 0;
+
+static void sync_file(FILE* f) {
+    fflush(f);
+#ifndef _WIN32
+    fsync(fileno(f));
+#endif
+}
+
+static bool replace_file(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    std::remove(to.c_str());
+#endif
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+BddCheckpointer::BddCheckpointer(BddManager& mgr, const std::string& p, uint64_t fp, bool resume)
+    : manager(mgr), path(p), fingerprint(fp) {
+    last_saved = manager.bddZero();
+
+    CheckpointHeader h;
+    FILE* f = resume ? std::fopen((path + ".ckpt").c_str(), "rb") : nullptr;
+    if (f) {
+        bool ok = std::fread(&h, sizeof(h), 1, f) == 1;
+        std::fclose(f);
+        if (!ok || std::memcmp(h.magic, BDD_CHECKPOINT_MAGIC, 8) != 0) {
+            throw std::runtime_error("checkpoint: bad record " + path + ".ckpt");
+        }
+        if (h.fingerprint != fingerprint) {
+            throw std::runtime_error("checkpoint: " + path + " was written for another net or encoding");
+        }
+
+        // Rebuild the nodes bottom-up (children always come first in the file)
+        std::vector<uint32_t> records(h.node_count * 3);
+        FILE* n = std::fopen((path + ".nodes").c_str(), "rb");
+        if (!n || std::fread(records.data(), 4, records.size(), n) != records.size()) {
+            if (n) std::fclose(n);
+            throw std::runtime_error("checkpoint: cannot read " + path + ".nodes");
+        }
+        std::fclose(n);
+
+        std::vector<BDD> built;
+        built.reserve(h.node_count);
+        auto from_edge = [&](uint64_t e) {
+            BDD r = (e >> 1) == 0 ? manager.bddOne() : built[(e >> 1) - 1];
+            return (e & 1) ? !r : r;
+        };
+        for (uint64_t k = 0; k < h.node_count; ++k) {
+            BDD var = manager.bddVar(records[3 * k]);
+            built.push_back(var.Ite(from_edge(records[3 * k + 1]), from_edge(records[3 * k + 2])));
+        }
+        last_saved = from_edge(h.root);
+        // only nodes under the root stay alive once 'built' is gone
+        std::unordered_map<BddEdge, uint32_t> all;
+        for (uint64_t k = 0; k < h.node_count; ++k) {
+            BddEdge node = bdd_edge(built[k]);
+            if (!bdd_is_complement(node)) all[node] = (uint32_t)k;
+        }
+        for (BddEdge node : live_nodes(bdd_edge(last_saved))) {
+            auto it = all.find(node);
+            if (it != all.end()) written[node] = it->second;
+        }
+        nodes_in_file = h.node_count;
+        has_resumed = true;
+        resumed_iter = (int)h.iteration;
+        resumed_done = h.finished != 0;
+
+        // drop records written after the last complete checkpoint
+        std::vector<uint32_t> keep(records.begin(), records.begin() + h.node_count * 3);
+        FILE* t = std::fopen((path + ".nodes").c_str(), "wb");
+        bool ok_t = t && std::fwrite(keep.data(), 4, keep.size(), t) == keep.size();
+        if (t) std::fclose(t);
+        if (!ok_t) throw std::runtime_error("checkpoint: cannot write " + path + ".nodes");
+    }
+    else {
+        std::remove((path + ".nodes").c_str());
+        std::remove((path + ".ckpt").c_str());
+    }
+
+    nodes_file = std::fopen((path + ".nodes").c_str(), "ab");
+    if (!nodes_file) throw std::runtime_error("checkpoint: cannot open " + path + ".nodes");
+    worker = std::thread([this] { run(); });
+}
+
+BddCheckpointer::~BddCheckpointer() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+    }
+    cv.notify_one();
+    worker.join();
+    std::fclose(nodes_file);
+}
+
+std::vector<BddEdge> BddCheckpointer::live_nodes(BddEdge root) const {
+    std::vector<BddEdge> live;
+    std::unordered_map<BddEdge, bool> seen;
+    std::vector<std::pair<BddEdge, bool>> stack; // (node, children done)
+    if (!bdd_is_constant(root)) stack.push_back({bdd_regular(root), false});
+    while (!stack.empty()) {
+        std::pair<BddEdge, bool> top = stack.back();
+        stack.pop_back();
+        if (top.second) { live.push_back(top.first); continue; }
+        if (seen.count(top.first)) continue;
+        seen[top.first] = true;
+        stack.push_back({top.first, true});
+        BddEdge kids[2] = {bdd_regular(bdd_then(manager, top.first)), bdd_regular(bdd_else(manager, top.first))};
+        for (BddEdge k : kids) {
+            if (!bdd_is_constant(k) && !seen.count(k)) stack.push_back({k, false});
+        }
+    }
+    return live;
+}
+
+uint32_t BddCheckpointer::edge_of(BddEdge p) const {
+    BddEdge r = bdd_regular(p);
+    uint32_t c = bdd_is_complement(p) ? 1 : 0;
+    if (bdd_is_constant(r)) return (bdd_constant_value(r) ? EDGE_ONE : 1) ^ c;
+    return ((written.at(r) + 1) << 1) | c;
+}
+
+void BddCheckpointer::save(const BDD& reachable, int iteration, bool finished) {
+    // --- STEP 1: Live nodes of the new root, children before parents ---
+    BddEdge root = bdd_edge(reachable);
+    std::vector<BddEdge> live = live_nodes(root);
+
+    // --- STEP 2: Append the new nodes, or rewrite when the file is mostly garbage ---
+    Job job;
+    job.rewrite = nodes_in_file > 2 * live.size() + 1024;
+    std::unordered_map<BddEdge, uint32_t> next;
+    if (job.rewrite) nodes_in_file = 0;
+    for (BddEdge n : live) {
+        auto it = written.find(n);
+        if (!job.rewrite && it != written.end()) { next[n] = it->second; continue; }
+        uint32_t id = (uint32_t)nodes_in_file++;
+        written[n] = id; // children are looked up through 'written' below
+        job.nodes.push_back(bdd_var(manager, n));
+        job.nodes.push_back(edge_of(bdd_then(manager, n)));
+        job.nodes.push_back(edge_of(bdd_else(manager, n)));
+        next[n] = id;
+    }
+    written.swap(next);
+    last_saved = reachable;
+
+    job.node_count = nodes_in_file;
+    job.root = edge_of(root);
+    job.iteration = iteration;
+    job.finished = finished;
+
+    // --- STEP 3: Hand over to the writer (merged with a pending job) ---
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (failed) throw std::runtime_error("checkpoint: " + error);
+        if (has_job && !job.rewrite) {
+            pending.nodes.insert(pending.nodes.end(), job.nodes.begin(), job.nodes.end());
+            job.nodes.swap(pending.nodes);
+            job.rewrite = pending.rewrite;
+        }
+        pending = std::move(job);
+        has_job = true;
+    }
+    cv.notify_one();
+}
+
+void BddCheckpointer::drain() {
+    std::unique_lock<std::mutex> lock(m);
+    idle_cv.wait(lock, [this] { return !has_job && !busy; });
+    if (failed) throw std::runtime_error("checkpoint: " + error);
+}
+
+void BddCheckpointer::run() {
+    std::unique_lock<std::mutex> lock(m);
+    while (true) {
+        cv.wait(lock, [this] { return has_job || stopping; });
+        if (!has_job) break;
+        Job job = std::move(pending);
+        pending = Job();
+        has_job = false;
+        busy = true;
+        lock.unlock();
+
+        std::string err = write(job);
+
+        lock.lock();
+        busy = false;
+        if (!err.empty() && !failed) { failed = true; error = err; }
+        idle_cv.notify_all();
+    }
+}
+
+std::string BddCheckpointer::write(const Job& job) {
+    // nodes first, so the record never points past the data
+    if (job.rewrite) {
+        std::string tmp = path + ".nodes.tmp";
+        FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return "cannot create " + tmp;
+        bool ok = std::fwrite(job.nodes.data(), 4, job.nodes.size(), f) == job.nodes.size();
+        sync_file(f);
+        ok = std::fclose(f) == 0 && ok;
+        std::fclose(nodes_file);
+        if (!ok || !replace_file(tmp, path + ".nodes")) { nodes_file = std::fopen((path + ".nodes").c_str(), "ab"); return "cannot write " + tmp; }
+        nodes_file = std::fopen((path + ".nodes").c_str(), "ab");
+        if (!nodes_file) return "cannot open " + path + ".nodes";
+    }
+    else if (!job.nodes.empty()) {
+        if (std::fwrite(job.nodes.data(), 4, job.nodes.size(), nodes_file) != job.nodes.size()) return "cannot write " + path + ".nodes";
+        sync_file(nodes_file);
+    }
+
+    CheckpointHeader h;
+    std::memcpy(h.magic, BDD_CHECKPOINT_MAGIC, 8);
+    h.fingerprint = fingerprint;
+    h.iteration = job.iteration;
+    h.node_count = job.node_count;
+    h.root = job.root;
+    h.finished = job.finished;
+
+    std::string tmp = path + ".ckpt.tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return "cannot create " + tmp;
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+    sync_file(f);
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok || !replace_file(tmp, path + ".ckpt")) return "cannot write " + tmp;
+    return "";
+}
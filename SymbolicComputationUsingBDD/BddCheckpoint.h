@@ -0,0 +1,76 @@
+#ifndef BDD_CHECKPOINT_H
+#define BDD_CHECKPOINT_H
+
+#include "BddBackend.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Checkpoints of the symbolic fixpoint: the Reachable BDD and the iteration count.
+//
+// <path>.nodes is an append-only node table (12 bytes per node: variable
+// index, then-edge, else-edge). A checkpoint appends only the nodes that are
+// not in the file yet, then replaces <path>.ckpt (root edge, node count,
+// iteration) by write + rename. Nodes that are no longer used stay in the
+// file until it holds twice the live nodes; then it is rewritten.
+//
+// The node table is built on the calling thread (the BDD packages are not
+// thread-safe);
+// the file writes run on a background thread.
+class BddCheckpointer {
+public:
+    // fingerprint identifies the net and variable layout; with resume = true
+    // the last checkpoint is loaded if one exists (throws if it belongs to
+    // another fingerprint).
+    BddCheckpointer(BddManager& manager, const std::string& path, uint64_t fingerprint, bool resume);
+    ~BddCheckpointer();
+    BddCheckpointer(const BddCheckpointer&) = delete;
+    BddCheckpointer& operator=(const BddCheckpointer&) = delete;
+
+    bool resumed() const { return has_resumed; }
+    const BDD& resumed_states() const { return last_saved; }
+    int resumed_iteration() const { return resumed_iter; }
+    bool resumed_finished() const { return resumed_done; }
+
+    void save(const BDD& reachable, int iteration, bool finished);
+    void drain(); // wait until every save is on disk
+
+private:
+    struct Job {
+        std::vector<uint32_t> nodes; // records to append (or the whole table if rewrite)
+        bool rewrite = false;
+        uint64_t node_count = 0, root = 0, iteration = 0, finished = 0;
+    };
+
+    std::vector<BddEdge> live_nodes(BddEdge root) const; // post-order, regular nodes
+    uint32_t edge_of(BddEdge p) const;
+    void run();
+    std::string write(const Job& job);
+
+    BddManager& manager;
+    std::string path;
+    uint64_t fingerprint;
+
+    std::unordered_map<BddEdge, uint32_t> written; // live node -> index in the file
+    BDD last_saved;                                // keeps the written nodes alive
+    uint64_t nodes_in_file = 0;
+
+    bool has_resumed = false, resumed_done = false;
+    int resumed_iter = 0;
+
+    std::thread worker;
+    std::mutex m;
+    std::condition_variable cv, idle_cv;
+    Job pending;
+    bool has_job = false, busy = false, stopping = false, failed = false;
+    std::string error;
+    FILE* nodes_file = nullptr;
+};
+
+#endif
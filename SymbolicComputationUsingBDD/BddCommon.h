@@ -0,0 +1,319 @@
+#ifndef BDD_COMMON_H
+#define BDD_COMMON_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Code shared by the native and the parallel BDD packages (NativeBdd.h,
+// ParallelBdd.h): the edge encoding, hashing, the sequential recursive
+// operations, the variable maps, counting, the mark phase of the garbage
+// collector and the reference-counted handle. The packages differ in how
+// they store nodes, cache results and run the parallel operations.
+//
+// BddManagerBase<M> is a CRTP base: M provides nodes, refs, marks, make,
+// lookup, insert, and_rec, or_rec, var_edge and out_of_nodes (true once an
+// operation must be abandoned; the native package never abandons one), and
+// makes the base a friend.
+
+namespace bdd_common {
+
+const uint32_t ONE = 0, ZERO = 1;
+const uint32_t INVALID = 0xffffffffu;   // result of an abandoned operation (parallel package)
+const uint32_t CONST_VAR = 0xffffffffu; // variable of the constant: below every level
+const uint32_t FREE_VAR = 0xfffffffeu;  // variable of a node on the free list
+
+// Cache operation codes (low 4 bits; the variable-map generation sits above)
+enum : uint32_t { OP_AND = 1, OP_XOR, OP_ITE, OP_EXISTS, OP_AND_EXISTS, OP_REL_NEXT, OP_PERMUTE, OP_COFACTOR };
+
+inline uint64_t mix(uint64_t h) {
+    h ^= h >> 31; h *= 0x7fb5d329728ea185ull;
+    h ^= h >> 27; h *= 0x81dadef4bc2dd44dull;
+    return h ^ (h >> 33);
+}
+
+inline uint64_t hash3(uint32_t a, uint32_t b, uint32_t c) {
+    return mix(((uint64_t)a << 32 | b) ^ (uint64_t)c * 0x9e3779b97f4a7c15ull);
+}
+
+// Slot hash of an operation-cache entry
+inline uint64_t cache_hash(uint32_t op, uint32_t a, uint32_t b, uint32_t c) {
+    return hash3(a, b, c) ^ op * 0xff51afd7ed558ccdull;
+}
+
+inline uint32_t flip(uint32_t r, uint32_t c) { return r == INVALID ? INVALID : r ^ c; }
+
+template <class M> class BddManagerBase {
+protected:
+    M& self() { return static_cast<M&>(*this); }
+    const M& self() const { return static_cast<const M&>(*this); }
+    uint32_t top_var(uint32_t e) const { return self().nodes[e >> 1].var; }
+
+    // --- Sequential recursive operations (INVALID when abandoned) ---
+    // Cofactors are read into locals before recursing: make() may move the nodes.
+
+    uint32_t ite_rec(uint32_t f, uint32_t g, uint32_t h) {
+        M& m = self();
+        if (f == ONE) return g;
+        if (f == ZERO) return h;
+        if (g == h) return g;
+        if (f == g) g = ONE;
+        else if (f == (g ^ 1)) g = ZERO;
+        if (f == h) h = ZERO;
+        else if (f == (h ^ 1)) h = ONE;
+        if (g == ONE && h == ZERO) return f;
+        if (g == ZERO && h == ONE) return f ^ 1;
+        if (g == ONE) return m.or_rec(f, h);
+        if (g == ZERO) return m.and_rec(f ^ 1, h);
+        if (h == ZERO) return m.and_rec(f, g);
+        if (h == ONE) return m.or_rec(f ^ 1, g);
+        if (m.out_of_nodes()) return INVALID;
+        // regular f and g: ite(!f, g, h) = ite(f, h, g), ite(f, !g, !h) = !ite(f, g, h)
+        if (f & 1) { f ^= 1; std::swap(g, h); }
+        uint32_t c = g & 1;
+        g ^= c;
+        h ^= c;
+        uint32_t r;
+        if (m.lookup(OP_ITE, f, g, h, r)) return r ^ c;
+
+        uint32_t v = std::min(top_var(f), std::min(top_var(g), top_var(h)));
+        uint32_t f1 = f, f0 = f, g1 = g, g0 = g, h1 = h, h0 = h;
+        if (top_var(f) == v) { f1 = m.edgeThen(f); f0 = m.edgeElse(f); }
+        if (top_var(g) == v) { g1 = m.edgeThen(g); g0 = m.edgeElse(g); }
+        if (top_var(h) == v) { h1 = m.edgeThen(h); h0 = m.edgeElse(h); }
+        uint32_t t = ite_rec(f1, g1, h1);
+        uint32_t e = ite_rec(f0, g0, h0);
+        if (t == INVALID || e == INVALID) return INVALID;
+        r = m.make(v, t, e);
+        if (r == INVALID) return INVALID;
+        m.insert(OP_ITE, f, g, h, r);
+        return r ^ c;
+    }
+
+    uint32_t permute_rec(uint32_t f) {
+        M& m = self();
+        if (M::edgeIsConstant(f)) return f;
+        if (m.out_of_nodes()) return INVALID;
+        uint32_t c = f & 1;
+        f ^= c;
+        uint32_t op = OP_PERMUTE | perm_gen << 4, r;
+        if (m.lookup(op, f, 0, 0, r)) return r ^ c;
+        uint32_t v = top_var(f), f1 = m.edgeThen(f), f0 = m.edgeElse(f);
+        uint32_t t = permute_rec(f1);
+        uint32_t e = permute_rec(f0);
+        uint32_t x = m.var_edge(perm_map[v]);
+        if (t == INVALID || e == INVALID || x == INVALID) return INVALID;
+        r = ite_rec(x, t, e); // the new variable may sit below t and e
+        if (r == INVALID) return INVALID;
+        m.insert(op, f, 0, 0, r);
+        return r ^ c;
+    }
+
+    uint32_t cofactor_rec(uint32_t f, uint32_t cube) {
+        M& m = self();
+        if (M::edgeIsConstant(f)) return f;
+        uint32_t v = top_var(f);
+        // literals above f do not matter
+        while (cube != ONE && top_var(cube) < v) cube = m.edgeThen(cube) == ZERO ? m.edgeElse(cube) : m.edgeThen(cube);
+        if (cube == ONE) return f;
+        if (m.out_of_nodes()) return INVALID;
+        uint32_t r;
+        if (m.lookup(OP_COFACTOR, f, cube, 0, r)) return r;
+
+        uint32_t f1 = m.edgeThen(f), f0 = m.edgeElse(f);
+        if (top_var(cube) == v) {
+            bool positive = m.edgeThen(cube) != ZERO;
+            r = cofactor_rec(positive ? f1 : f0, positive ? m.edgeThen(cube) : m.edgeElse(cube));
+        }
+        else {
+            uint32_t t = cofactor_rec(f1, cube);
+            uint32_t e = cofactor_rec(f0, cube);
+            r = t == INVALID || e == INVALID ? INVALID : m.make(v, t, e);
+        }
+        if (r != INVALID) m.insert(OP_COFACTOR, f, cube, 0, r);
+        return r;
+    }
+
+    // --- Counting ---
+
+    long double density(uint32_t f, std::unordered_map<uint32_t, long double>& memo) const {
+        // fraction of all assignments that satisfy f. The complement is pushed
+        // down to the constants instead of taking 1 - d, which would round sparse
+        // sets to 0; long double keeps thousands of variables above underflow.
+        if (f == ONE) return 1;
+        if (f == ZERO) return 0;
+        auto it = memo.find(f);
+        if (it != memo.end()) return it->second;
+        long double d = (density(self().edgeThen(f), memo) + density(self().edgeElse(f), memo)) / 2;
+        memo[f] = d;
+        return d;
+    }
+
+    long dag_size(uint32_t f) const {
+        // distinct nodes, the constant included (as Cudd_DagSize). Own visited
+        // set: 'marks' still holds the survivors of the last collection.
+        std::unordered_set<uint32_t> seen = {f >> 1};
+        std::vector<uint32_t> stack = {f >> 1};
+        while (!stack.empty()) {
+            uint32_t i = stack.back();
+            stack.pop_back();
+            if (i == 0) continue;
+            uint32_t kids[2] = {self().nodes[i].hi >> 1, self().nodes[i].lo >> 1};
+            for (uint32_t k : kids) if (seen.insert(k).second) stack.push_back(k);
+        }
+        return (long)seen.size();
+    }
+
+    // --- Garbage collection: marks[i] = 1 for every node reachable from a handle ---
+    void mark_live() {
+        M& m = self();
+        std::fill(m.marks.begin(), m.marks.end(), 0);
+        m.marks[0] = 1;
+        std::vector<uint32_t> stack;
+        for (uint32_t i = 1; i < m.nodes.size(); ++i) {
+            if (m.refs[i] == 0 || m.marks[i] || m.nodes[i].var == FREE_VAR) continue;
+            m.marks[i] = 1;
+            stack.push_back(i);
+            while (!stack.empty()) {
+                uint32_t k = stack.back();
+                stack.pop_back();
+                uint32_t kids[2] = {m.nodes[k].hi >> 1, m.nodes[k].lo >> 1};
+                for (uint32_t j : kids) if (!m.marks[j]) { m.marks[j] = 1; stack.push_back(j); }
+            }
+        }
+    }
+
+    // --- Variable maps of rel_next_rec / permute_rec ---
+    // A new map gets a new generation, so cached results of the previous map
+    // are not reused. Keyed on variable indices: edges of collected nodes get reused.
+
+    template <class B>
+    bool set_rename(const std::vector<B>& from, const std::vector<B>& to, uint32_t cube) {
+        std::vector<uint32_t> key;
+        for (const auto& b : from) key.push_back(top_var(b.getEdge()));
+        key.push_back(CONST_VAR);
+        for (const auto& b : to) key.push_back(top_var(b.getEdge()));
+        key.push_back(CONST_VAR);
+        for (uint32_t c = cube; c != ONE; c = self().edgeThen(c)) key.push_back(top_var(c));
+        if (key == rename_key && !rename_map.empty()) return true;
+
+        if (from.size() != to.size()) throw std::invalid_argument("BDD: rename lists differ in length");
+        std::vector<uint32_t> map(num_vars);
+        for (uint32_t v = 0; v < num_vars; ++v) map[v] = v;
+        uint32_t end = 0;
+        for (size_t i = 0; i < from.size(); ++i) {
+            uint32_t a = top_var(from[i].getEdge()), b = top_var(to[i].getEdge());
+            if (a >= num_vars || b >= num_vars) throw std::invalid_argument("BDD: rename of a non-variable");
+            map[a] = b;
+            if (a != b) end = std::max(end, a + 1);
+        }
+        // the kept variables must stay in order
+        std::vector<bool> quantified(num_vars, false);
+        for (uint32_t c = cube; c != ONE; c = self().edgeThen(c)) quantified[top_var(c)] = true;
+        long last = -1;
+        for (uint32_t v = 0; v < num_vars; ++v) {
+            if (quantified[v]) continue;
+            if ((long)map[v] <= last) return false;
+            last = map[v];
+        }
+        rename_map.swap(map);
+        rename_key.swap(key);
+        rename_end = end;
+        rename_gen = (rename_gen + 1) & 0x0fffffffu;
+        return true;
+    }
+
+    template <class B>
+    void set_permutation(const std::vector<B>& x, const std::vector<B>& y) {
+        std::vector<uint32_t> key;
+        for (const auto& b : x) key.push_back(top_var(b.getEdge()));
+        key.push_back(CONST_VAR);
+        for (const auto& b : y) key.push_back(top_var(b.getEdge()));
+        if (key == perm_key && !perm_map.empty()) return;
+
+        if (x.size() != y.size()) throw std::invalid_argument("BDD: swap lists differ in length");
+        perm_map.resize(num_vars);
+        for (uint32_t v = 0; v < num_vars; ++v) perm_map[v] = v;
+        for (size_t i = 0; i < x.size(); ++i) {
+            uint32_t a = top_var(x[i].getEdge()), b = top_var(y[i].getEdge());
+            if (a >= num_vars || b >= num_vars) throw std::invalid_argument("BDD: swap of a non-variable");
+            perm_map[a] = b;
+            perm_map[b] = a;
+        }
+        perm_key.swap(key);
+        perm_gen = (perm_gen + 1) & 0x0fffffffu;
+    }
+
+    uint32_t num_vars = 0;
+    std::vector<uint32_t> rename_map, rename_key; // var -> var; key: variables of from, to, cube
+    uint32_t rename_gen = 0, rename_end = 0;      // rename_end: one past the deepest renamed variable
+    std::vector<uint32_t> perm_map, perm_key;
+    uint32_t perm_gen = 0;
+};
+
+// Reference-counted handle of a root edge (CRTP: D is the package's BDD
+// class, M its manager; M::ref/deref are called on copy and destruction)
+template <class D, class M> class BddHandle {
+public:
+    BddHandle() = default;
+    BddHandle(const BddHandle& o) : mgr(o.mgr), e(o.e) { if (mgr) mgr->ref(e); }
+    BddHandle(BddHandle&& o) noexcept : mgr(o.mgr), e(o.e) { o.mgr = nullptr; }
+    BddHandle& operator=(const BddHandle& o) {
+        if (o.mgr) o.mgr->ref(o.e);
+        if (mgr) mgr->deref(e);
+        mgr = o.mgr;
+        e = o.e;
+        return *this;
+    }
+    BddHandle& operator=(BddHandle&& o) noexcept {
+        if (this == &o) return *this;
+        if (mgr) mgr->deref(e);
+        mgr = o.mgr;
+        e = o.e;
+        o.mgr = nullptr;
+        return *this;
+    }
+    ~BddHandle() { if (mgr) mgr->deref(e); }
+
+    D operator!() const { return D(mgr, e ^ 1); }
+    D& operator*=(const D& g) { return self() = self() * g; }
+    D& operator+=(const D& g) { return self() = self() + g; }
+    bool operator==(const D& g) const { return e == g.e; }
+    bool operator!=(const D& g) const { return e != g.e; }
+
+    bool IsZero() const { return e == ZERO; }
+    bool IsOne() const { return e == ONE; }
+    D Xnor(const D& g) const { return !(self() ^ g); }
+
+    // this or the images under every relation of a partitioned relation
+    D ImageUnion(const std::vector<D>& relations, const D& cube, const std::vector<D>& from, const std::vector<D>& to) const {
+        D result = self();
+        for (const auto& r : relations) result += self().RelNext(r, cube, from, to);
+        return result;
+    }
+
+    uint32_t getEdge() const { return e; }
+
+protected:
+    BddHandle(M* m, uint32_t edge) : mgr(m), e(edge) { if (mgr) mgr->ref(e); }
+
+    D& self() { return static_cast<D&>(*this); }
+    const D& self() const { return static_cast<const D&>(*this); }
+
+    // Manager of an operation (a default-constructed handle has none)
+    static M* manager_of(M* a, M* b) {
+        if (!a && !b) throw std::logic_error("BDD: operation on handles without a manager");
+        return a ? a : b;
+    }
+
+    M* mgr = nullptr;
+    uint32_t e = ZERO;
+};
+
+} // namespace bdd_common
+
+#endif
@@ -0,0 +1,338 @@
+#include "NativeBdd.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace bdd_common;
+
+static const uint32_t MAX_NODES = 1u << 31;   // index << 1 must fit in an edge
+static const size_t MIN_CACHE = 1u << 15, MAX_CACHE = 1u << 26;
+
+// --- Manager ---
+
+NativeBddManager::NativeBddManager(unsigned numVars, unsigned numVarsZ, unsigned numSlots) {
+    if (numVarsZ != 0) throw std::invalid_argument("NativeBddManager: ZDD variables are not supported");
+    uint32_t size = 4; // a power of two: the unique table masks its hashes
+    while (size < numSlots && size < MAX_NODES) size *= 2;
+    nodes.resize(size);
+    refs.assign(size, 0);
+    marks.assign(size, 0);
+    nodes[0] = {CONST_VAR, ONE, ONE, 0};
+    for (uint32_t i = size - 1; i >= 1; --i) nodes[i] = {FREE_VAR, 0, 0, i + 1 < size ? i + 1 : 0};
+    free_head = 1;
+    buckets.assign(size, 0);
+    cache.assign(MIN_CACHE, CacheEntry{0, 0, 0, 0, 0});
+    for (unsigned v = 0; v < numVars; ++v) var_edge(v);
+}
+
+NativeBdd NativeBddManager::bddOne() const { return NativeBdd(const_cast<NativeBddManager*>(this), ONE); }
+NativeBdd NativeBddManager::bddZero() const { return NativeBdd(const_cast<NativeBddManager*>(this), ZERO); }
+
+NativeBdd NativeBddManager::bddVar(int index) const {
+    if (index < 0) throw std::invalid_argument("NativeBddManager: negative variable index");
+    NativeBddManager* self = const_cast<NativeBddManager*>(this);
+    self->maybe_collect();
+    return NativeBdd(self, self->var_edge((uint32_t)index));
+}
+
+uint32_t NativeBddManager::var_edge(uint32_t v) {
+    if (v >= num_vars) num_vars = v + 1;
+    return make(v, ONE, ZERO);
+}
+
+// --- Node table ---
+
+uint32_t NativeBddManager::make(uint32_t var, uint32_t hi, uint32_t lo) {
+    if (hi == lo) return hi;
+    uint32_t c = hi & 1; // keep the then-edge regular
+    hi ^= c;
+    lo ^= c;
+    for (uint32_t i = buckets[hash3(var, hi, lo) & (buckets.size() - 1)]; i != 0; i = nodes[i].next) {
+        const Node& n = nodes[i];
+        if (n.var == var && n.hi == hi && n.lo == lo) return (i << 1) | c;
+    }
+    uint32_t i = alloc(); // may grow and rehash
+    uint32_t& head = buckets[hash3(var, hi, lo) & (buckets.size() - 1)];
+    nodes[i] = {var, hi, lo, head};
+    head = i;
+    return (i << 1) | c;
+}
+
+uint32_t NativeBddManager::alloc() {
+    if (free_head == 0) grow();
+    uint32_t i = free_head;
+    free_head = nodes[i].next;
+    if (++used > peak) peak = used;
+    return i;
+}
+
+void NativeBddManager::grow() {
+    uint32_t old = (uint32_t)nodes.size();
+    if (old >= MAX_NODES) throw std::runtime_error("NativeBddManager: node table full");
+    uint32_t size = old * 2;
+    nodes.resize(size);
+    refs.resize(size, 0);
+    marks.resize(size, 0);
+    for (uint32_t i = size - 1; i >= old; --i) nodes[i] = {FREE_VAR, 0, 0, free_head}, free_head = i;
+    rehash();
+    // the cache follows the table: about one entry per two nodes
+    size_t entries = std::min(MAX_CACHE, std::max(MIN_CACHE, (size_t)size / 2));
+    if (entries != cache.size()) cache.assign(entries, CacheEntry{0, 0, 0, 0, 0});
+}
+
+void NativeBddManager::rehash() {
+    buckets.assign(nodes.size(), 0);
+    size_t mask = buckets.size() - 1;
+    for (uint32_t i = 1; i < nodes.size(); ++i) {
+        Node& n = nodes[i];
+        if (n.var == FREE_VAR) continue;
+        uint32_t& head = buckets[hash3(n.var, n.hi, n.lo) & mask];
+        n.next = head;
+        head = i;
+    }
+}
+
+void NativeBddManager::maybe_collect() {
+    // collect when the table is nearly full; grow ahead when most of it survives
+    if (used + nodes.size() / 16 < nodes.size()) return;
+    collect();
+    if (used > nodes.size() / 2 && nodes.size() < MAX_NODES) grow();
+}
+
+void NativeBddManager::collect() {
+    mark_live(); // from the referenced nodes
+
+    // --- Sweep into the free list, rebuild the chains of the survivors ---
+    free_head = 0;
+    used = 0;
+    std::fill(buckets.begin(), buckets.end(), 0);
+    size_t mask = buckets.size() - 1;
+    for (uint32_t i = (uint32_t)nodes.size() - 1; i >= 1; --i) {
+        Node& n = nodes[i];
+        if (!marks[i]) {
+            n.var = FREE_VAR;
+            n.next = free_head;
+            free_head = i;
+            continue;
+        }
+        uint32_t& head = buckets[hash3(n.var, n.hi, n.lo) & mask];
+        n.next = head;
+        head = i;
+        used++;
+    }
+
+    // cached results stay valid while all their nodes survive
+    for (CacheEntry& c : cache) {
+        if (c.op && !(marks[c.a >> 1] && marks[c.b >> 1] && marks[c.c >> 1] && marks[c.r >> 1])) c.op = 0;
+    }
+    collections++;
+}
+
+// --- Cache ---
+
+bool NativeBddManager::lookup(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t& r) const {
+    const CacheEntry& e = cache[cache_hash(op, a, b, c) & (cache.size() - 1)];
+    if (e.op != op || e.a != a || e.b != b || e.c != c) return false;
+    r = e.r;
+    return true;
+}
+
+void NativeBddManager::insert(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t r) {
+    cache[cache_hash(op, a, b, c) & (cache.size() - 1)] = {op, a, b, c, r};
+}
+
+// --- Recursive operations ---
+// Cofactors are read into locals before recursing: make() may grow 'nodes'.
+
+uint32_t NativeBddManager::and_rec(uint32_t f, uint32_t g) {
+    if (f == ZERO || g == ZERO || f == (g ^ 1)) return ZERO;
+    if (f == ONE || f == g) return g;
+    if (g == ONE) return f;
+    if (f > g) std::swap(f, g);
+    uint32_t r;
+    if (lookup(OP_AND, f, g, 0, r)) return r;
+
+    uint32_t v = std::min(top_var(f), top_var(g));
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    uint32_t t = and_rec(f1, g1);
+    uint32_t e = and_rec(f0, g0);
+    r = make(v, t, e);
+    insert(OP_AND, f, g, 0, r);
+    return r;
+}
+
+uint32_t NativeBddManager::xor_rec(uint32_t f, uint32_t g) {
+    // not(f) xor g = not(f xor g): only regular operands are cached
+    uint32_t c = (f ^ g) & 1;
+    f &= ~1u;
+    g &= ~1u;
+    if (f == g) return ZERO ^ c;
+    if (f == ONE) return g ^ 1 ^ c;
+    if (g == ONE) return f ^ 1 ^ c;
+    if (f > g) std::swap(f, g);
+    uint32_t r;
+    if (lookup(OP_XOR, f, g, 0, r)) return r ^ c;
+
+    uint32_t v = std::min(top_var(f), top_var(g));
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    uint32_t t = xor_rec(f1, g1);
+    uint32_t e = xor_rec(f0, g0);
+    r = make(v, t, e);
+    insert(OP_XOR, f, g, 0, r);
+    return r ^ c;
+}
+
+uint32_t NativeBddManager::exists_rec(uint32_t f, uint32_t cube) {
+    if (edgeIsConstant(f)) return f;
+    uint32_t v = top_var(f);
+    while (cube != ONE && top_var(cube) < v) cube = nodes[cube >> 1].hi;
+    if (cube == ONE) return f;
+    uint32_t r;
+    if (lookup(OP_EXISTS, f, cube, 0, r)) return r;
+
+    uint32_t f1 = edgeThen(f), f0 = edgeElse(f);
+    if (top_var(cube) == v) {
+        uint32_t rest = nodes[cube >> 1].hi;
+        r = exists_rec(f0, rest);
+        if (r != ONE) r = or_rec(r, exists_rec(f1, rest));
+    }
+    else {
+        uint32_t t = exists_rec(f1, cube);
+        uint32_t e = exists_rec(f0, cube);
+        r = make(v, t, e);
+    }
+    insert(OP_EXISTS, f, cube, 0, r);
+    return r;
+}
+
+uint32_t NativeBddManager::and_exists_rec(uint32_t f, uint32_t g, uint32_t cube) {
+    if (f == ZERO || g == ZERO || f == (g ^ 1)) return ZERO;
+    if (f == ONE && g == ONE) return ONE;
+    if (cube == ONE) return and_rec(f, g);
+    if (f == ONE || f == g) return exists_rec(g, cube);
+    if (g == ONE) return exists_rec(f, cube);
+    uint32_t v = std::min(top_var(f), top_var(g));
+    while (cube != ONE && top_var(cube) < v) cube = nodes[cube >> 1].hi;
+    if (cube == ONE) return and_rec(f, g);
+    if (f > g) std::swap(f, g);
+    uint32_t r;
+    if (lookup(OP_AND_EXISTS, f, g, cube, r)) return r;
+
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    if (top_var(cube) == v) {
+        uint32_t rest = nodes[cube >> 1].hi;
+        r = and_exists_rec(f0, g0, rest);
+        if (r != ONE) r = or_rec(r, and_exists_rec(f1, g1, rest));
+    }
+    else {
+        uint32_t t = and_exists_rec(f1, g1, cube);
+        uint32_t e = and_exists_rec(f0, g0, cube);
+        r = make(v, t, e);
+    }
+    insert(OP_AND_EXISTS, f, g, cube, r);
+    return r;
+}
+
+uint32_t NativeBddManager::rel_next_rec(uint32_t f, uint32_t g, uint32_t cube) {
+    // and_exists_rec, but the kept variables are renamed as the result is built
+    if (f == ZERO || g == ZERO || f == (g ^ 1)) return ZERO;
+    if (f == ONE && g == ONE) return ONE;
+    uint32_t v = std::min(top_var(f), top_var(g));
+    while (cube != ONE && top_var(cube) < v) cube = nodes[cube >> 1].hi;
+    if (cube == ONE && v >= rename_end) return and_rec(f, g); // nothing left to do below v
+    if (f > g) std::swap(f, g);
+    uint32_t op = OP_REL_NEXT | rename_gen << 4, r;
+    if (lookup(op, f, g, cube, r)) return r;
+
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    if (cube != ONE && top_var(cube) == v) {
+        uint32_t rest = nodes[cube >> 1].hi;
+        r = rel_next_rec(f0, g0, rest);
+        if (r != ONE) r = or_rec(r, rel_next_rec(f1, g1, rest));
+    }
+    else {
+        uint32_t t = rel_next_rec(f1, g1, cube);
+        uint32_t e = rel_next_rec(f0, g0, cube);
+        r = make(rename_map[v], t, e);
+    }
+    insert(op, f, g, cube, r);
+    return r;
+}
+
+// --- Handles ---
+
+NativeBdd NativeBdd::operator*(const NativeBdd& g) const {
+    NativeBddManager* m = manager_of(mgr, g.mgr);
+    m->maybe_collect();
+    return NativeBdd(m, m->and_rec(e, g.e));
+}
+
+NativeBdd NativeBdd::operator+(const NativeBdd& g) const {
+    NativeBddManager* m = manager_of(mgr, g.mgr);
+    m->maybe_collect();
+    return NativeBdd(m, m->or_rec(e, g.e));
+}
+
+NativeBdd NativeBdd::operator^(const NativeBdd& g) const {
+    NativeBddManager* m = manager_of(mgr, g.mgr);
+    m->maybe_collect();
+    return NativeBdd(m, m->xor_rec(e, g.e));
+}
+
+NativeBdd NativeBdd::Ite(const NativeBdd& g, const NativeBdd& h) const {
+    NativeBddManager* m = manager_of(mgr, manager_of(g.mgr, h.mgr));
+    m->maybe_collect();
+    return NativeBdd(m, m->ite_rec(e, g.e, h.e));
+}
+
+NativeBdd NativeBdd::ExistAbstract(const NativeBdd& cube) const {
+    NativeBddManager* m = manager_of(mgr, cube.mgr);
+    m->maybe_collect();
+    return NativeBdd(m, m->exists_rec(e, cube.e));
+}
+
+NativeBdd NativeBdd::AndAbstract(const NativeBdd& g, const NativeBdd& cube) const {
+    NativeBddManager* m = manager_of(mgr, g.mgr);
+    m->maybe_collect();
+    return NativeBdd(m, m->and_exists_rec(e, g.e, cube.e));
+}
+
+NativeBdd NativeBdd::SwapVariables(const std::vector<NativeBdd>& x, const std::vector<NativeBdd>& y) const {
+    if (!mgr) return *this;
+    mgr->maybe_collect();
+    mgr->set_permutation(x, y);
+    return NativeBdd(mgr, mgr->permute_rec(e));
+}
+
+NativeBdd NativeBdd::Cofactor(const NativeBdd& cube) const {
+    NativeBddManager* m = manager_of(mgr, cube.mgr);
+    if (cube.e == ZERO) throw std::invalid_argument("BDD: cofactor by zero");
+    m->maybe_collect();
+    return NativeBdd(m, m->cofactor_rec(e, cube.e));
+}
+
+double NativeBdd::CountMinterm(int nvars) const {
+    if (!mgr) return e == ONE ? std::ldexp(1.0, nvars) : 0;
+    std::unordered_map<uint32_t, long double> memo;
+    return (double)std::ldexp(mgr->density(e, memo), nvars);
+}
+
+int NativeBdd::nodeCount() const {
+    return mgr ? (int)mgr->dag_size(e) : 1;
+}
+
+NativeBdd NativeBdd::RelNext(const NativeBdd& relation, const NativeBdd& cube,
+                             const std::vector<NativeBdd>& from, const std::vector<NativeBdd>& to) const {
+    NativeBddManager* m = manager_of(mgr, relation.mgr);
+    m->maybe_collect();
+    if (!m->set_rename(from, to, cube.e)) return AndAbstract(relation, cube).SwapVariables(from, to);
+    return NativeBdd(m, m->rel_next_rec(e, relation.e, cube.e));
+}
@@ -0,0 +1,139 @@
+#ifndef NATIVE_BDD_H
+#define NATIVE_BDD_H
+
+#include "BddCommon.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// A small BDD package for the reachability engine, so petri_solver builds
+// without CUDD. The method names follow CUDD's C++ wrapper (cuddObj.hh) for
+// the subset BDDReachability and BddCheckpointer use; BddBackend.h picks
+// this package or CUDD.
+//
+// Edges are 32-bit: node index << 1 | complement bit. Node 0 is the constant
+// one (edge 0), so edge 1 is zero. As in CUDD the then-edge of a node is never
+// complemented, which keeps the diagrams canonical. Variable index = level
+// (no reordering).
+//
+// Nodes live in one array with a chained unique table; operation results go
+// to a lossy direct-mapped cache. Hashing, ite/cofactor/permute, the variable
+// maps, counting and the handle are shared with ParallelBdd (BddCommon.h).
+// NativeBdd handles reference their root; garbage collection (mark from referenced roots, sweep into a free list)
+// only runs at the start of a top-level operation, never inside a recursion,
+// so intermediate results need no protection. When a recursion runs out of
+// nodes the array doubles instead.
+//
+// Not thread-safe (one manager per thread, like CUDD).
+
+class NativeBdd;
+
+class NativeBddManager : public bdd_common::BddManagerBase<NativeBddManager> {
+public:
+    // Same leading parameters as Cudd(numVars, numVarsZ, numSlots); ZDD
+    // variables are not supported. numSlots is the initial node table size
+    // (rounded up to a power of two); the table doubles as needed.
+    explicit NativeBddManager(unsigned numVars = 0, unsigned numVarsZ = 0, unsigned numSlots = 1u << 16);
+    NativeBddManager(const NativeBddManager&) = delete;
+    NativeBddManager& operator=(const NativeBddManager&) = delete;
+
+    NativeBdd bddOne() const;
+    NativeBdd bddZero() const;
+    NativeBdd bddVar(int index) const; // creates the variables up to index
+
+    int ReadSize() const { return (int)num_vars; }
+    long ReadNodeCount() const { return (long)used; }     // nodes in the unique table
+    long ReadPeakNodeCount() const { return (long)peak; } // most nodes in the table at once
+    long ReadGarbageCollections() const { return (long)collections; }
+
+    // Raw edges, for walking a diagram (see BddBackend.h)
+    static bool edgeIsComplement(uint32_t e) { return e & 1; }
+    static uint32_t edgeRegular(uint32_t e) { return e & ~1u; }
+    static bool edgeIsConstant(uint32_t e) { return (e >> 1) == 0; }
+    uint32_t edgeVar(uint32_t e) const { return nodes[e >> 1].var; }
+    uint32_t edgeThen(uint32_t e) const { return nodes[e >> 1].hi ^ (e & 1); }
+    uint32_t edgeElse(uint32_t e) const { return nodes[e >> 1].lo ^ (e & 1); }
+
+private:
+    friend class NativeBdd;
+    friend class bdd_common::BddManagerBase<NativeBddManager>;
+    friend class bdd_common::BddHandle<NativeBdd, NativeBddManager>;
+
+    struct Node {
+        uint32_t var;  // FREE_VAR while on the free list
+        uint32_t hi;   // then-edge, always regular
+        uint32_t lo;   // else-edge
+        uint32_t next; // unique-table chain or free list
+    };
+    struct CacheEntry { uint32_t op, a, b, c, r; };
+
+    // --- Node table ---
+    uint32_t make(uint32_t var, uint32_t hi, uint32_t lo);
+    uint32_t alloc();
+    void grow();
+    void rehash();
+    void ref(uint32_t e) { refs[e >> 1]++; }
+    void deref(uint32_t e) { refs[e >> 1]--; }
+    void maybe_collect(); // called before every top-level operation
+    void collect();
+    uint32_t var_edge(uint32_t v);
+    bool out_of_nodes() const { return false; } // the table grows inside an operation instead
+
+    // --- Cache ---
+    bool lookup(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t& r) const;
+    void insert(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t r);
+
+    // --- Recursive operations (edges in, edge out); ite, permute and
+    // cofactor come from BddManagerBase ---
+    uint32_t and_rec(uint32_t f, uint32_t g);
+    uint32_t or_rec(uint32_t f, uint32_t g) { return and_rec(f ^ 1, g ^ 1) ^ 1; }
+    uint32_t xor_rec(uint32_t f, uint32_t g);
+    uint32_t exists_rec(uint32_t f, uint32_t cube);
+    uint32_t and_exists_rec(uint32_t f, uint32_t g, uint32_t cube);
+    uint32_t rel_next_rec(uint32_t f, uint32_t g, uint32_t cube);
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> refs;      // handles per node
+    std::vector<uint32_t> buckets;   // unique table heads (0 = empty)
+    std::vector<CacheEntry> cache;
+    std::vector<uint8_t> marks;
+    uint32_t free_head = 0;
+    uint64_t used = 0, peak = 0, collections = 0;
+};
+
+class NativeBdd : public bdd_common::BddHandle<NativeBdd, NativeBddManager> {
+public:
+    NativeBdd() = default;
+
+    NativeBdd operator*(const NativeBdd& g) const;  // and
+    NativeBdd operator+(const NativeBdd& g) const;  // or
+    NativeBdd operator^(const NativeBdd& g) const;  // xor
+    NativeBdd Ite(const NativeBdd& g, const NativeBdd& h) const;
+    NativeBdd ExistAbstract(const NativeBdd& cube) const;
+    // Exists cube . (this and g), in one pass
+    NativeBdd AndAbstract(const NativeBdd& g, const NativeBdd& cube) const;
+    // Swaps x[i] and y[i] in the function
+    NativeBdd SwapVariables(const std::vector<NativeBdd>& x, const std::vector<NativeBdd>& y) const;
+    // Restriction to a cube of literals
+    NativeBdd Cofactor(const NativeBdd& cube) const;
+    double CountMinterm(int nvars) const;
+    int nodeCount() const;
+
+    // --- Fused operations of the reachability fixpoint ---
+
+    // Image under a relation: (exists cube . this and relation) with from[i]
+    // renamed to to[i], in one pass. The rename is applied while the result
+    // is built, which needs it to keep the order of the variables that are
+    // not quantified (true for the interleaved x/y layout); otherwise this
+    // falls back to AndAbstract + SwapVariables. ImageUnion (BddHandle) ors
+    // the images of a partitioned relation; garbage is collected between them.
+    NativeBdd RelNext(const NativeBdd& relation, const NativeBdd& cube,
+                      const std::vector<NativeBdd>& from, const std::vector<NativeBdd>& to) const;
+
+private:
+    friend class NativeBddManager;
+    friend class bdd_common::BddHandle<NativeBdd, NativeBddManager>;
+    NativeBdd(NativeBddManager* m, uint32_t edge) : BddHandle(m, edge) {}
+};
+
+#endif
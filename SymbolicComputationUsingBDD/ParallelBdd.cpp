@@ -0,0 +1,563 @@
+#include "ParallelBdd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using namespace bdd_common;
+
+static const uint32_t MAX_NODES = 1u << 30;    // edges stay below INVALID
+static const size_t MIN_CACHE = 1u << 15, MAX_CACHE = 1u << 26;
+static const uint64_t ALLOC_CHUNK = 256;       // node indices a worker takes at once
+static const int64_t DEQUE_SIZE = 1 << 16;     // tasks per worker; deeper spawns run inline
+
+enum : int { TASK_EMPTY = 0, TASK_QUEUED, TASK_STOLEN, TASK_DONE };
+
+// The worker the current thread runs as (set by run() and the helper threads)
+static thread_local void* tl_worker = nullptr;
+
+// --- Manager ---
+
+ParallelBddManager::ParallelBddManager(unsigned numVars, unsigned numVarsZ, unsigned numSlots) {
+    if (numVarsZ != 0) throw std::invalid_argument("ParallelBddManager: ZDD variables are not supported");
+    uint32_t size = 4; // a power of two: the bucket array masks its hashes
+    while (size < numSlots && size < MAX_NODES) size *= 2;
+    nodes.assign(size, Node{FREE_VAR, 0, 0, 0});
+    nodes[0] = {CONST_VAR, ONE, ONE, 0};
+    refs.assign(size, 0);
+    marks.assign(size, 0);
+    marks[0] = 1;
+    rebuild_table();
+    cache_mask = MIN_CACHE - 1;
+    cache.reset(new CacheEntry[MIN_CACHE]);
+    setWorkers((int)std::max(1u, std::thread::hardware_concurrency()));
+    for (unsigned v = 0; v < numVars; ++v) bddVar((int)v);
+}
+
+ParallelBddManager::~ParallelBddManager() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mu);
+        stopping = true;
+    }
+    pool_cv.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void ParallelBddManager::setWorkers(int n) {
+    n = std::max(1, n);
+    if (!threads.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mu);
+            stopping = true;
+        }
+        pool_cv.notify_all();
+        for (auto& t : threads) t.join();
+        threads.clear();
+        stopping = false;
+    }
+    // the chunks the old workers claimed go back to the free list
+    if (!workers.empty()) collect();
+    workers.clear();
+    for (int i = 0; i < n; ++i) {
+        workers.emplace_back(new Worker());
+        workers.back()->deque.reset(new Task[DEQUE_SIZE]);
+        workers.back()->rng = mix(i + 1);
+    }
+    for (int i = 1; i < n; ++i) threads.emplace_back([this, i] { worker_loop(i); });
+}
+
+long ParallelBddManager::ReadNodeCount() const {
+    uint64_t n = used_at_collect;
+    for (const auto& w : workers) n += w->allocated.load(std::memory_order_relaxed);
+    return (long)n;
+}
+
+ParallelBdd ParallelBddManager::bddOne() const { return ParallelBdd(const_cast<ParallelBddManager*>(this), ONE); }
+ParallelBdd ParallelBddManager::bddZero() const { return ParallelBdd(const_cast<ParallelBddManager*>(this), ZERO); }
+
+ParallelBdd ParallelBddManager::bddVar(int index) const {
+    if (index < 0) throw std::invalid_argument("ParallelBddManager: negative variable index");
+    ParallelBddManager* self = const_cast<ParallelBddManager*>(this);
+    return ParallelBdd(self, self->run([self, index] { return self->var_edge((uint32_t)index); }));
+}
+
+uint32_t ParallelBddManager::var_edge(uint32_t v) {
+    if (v >= num_vars) num_vars = v + 1;
+    return make(v, ONE, ZERO);
+}
+
+// --- Node table ---
+
+uint32_t ParallelBddManager::make(uint32_t var, uint32_t hi, uint32_t lo) {
+    if (hi == lo) return hi;
+    uint32_t c = hi & 1; // keep the then-edge regular
+    hi ^= c;
+    lo ^= c;
+    uint64_t h = hash3(var, hi, lo);
+    uint64_t tag = (h >> 32) << 32;
+    uint32_t mine = 0; // our copy of the node, once allocated
+    size_t i = h & bucket_mask;
+    for (size_t probe = 0; probe <= bucket_mask; ++probe, i = (i + 1) & bucket_mask) {
+        uint64_t w = buckets[i].load(std::memory_order_acquire);
+        if (w == 0) {
+            if (!mine) {
+                mine = alloc(*static_cast<Worker*>(tl_worker));
+                if (!mine) return INVALID;
+                nodes[mine] = {var, hi, lo, 0};
+            }
+            // the CAS publishes the node data written above
+            if (buckets[i].compare_exchange_strong(w, tag | mine, std::memory_order_acq_rel)) return (mine << 1) | c;
+            // lost the slot: w is the winner's word
+        }
+        if ((w & ~0xffffffffull) == tag) {
+            const Node& n = nodes[(uint32_t)w];
+            if (n.var == var && n.hi == hi && n.lo == lo) {
+                if (mine) static_cast<Worker*>(tl_worker)->spare = mine; // another worker made it first
+                return ((uint32_t)w << 1) | c;
+            }
+        }
+    }
+    table_full.store(true, std::memory_order_relaxed);
+    return INVALID;
+}
+
+uint32_t ParallelBddManager::alloc(Worker& w) {
+    if (w.spare) {
+        uint32_t i = w.spare;
+        w.spare = 0;
+        return i;
+    }
+    if (w.alloc_next == w.alloc_end) {
+        if (table_full.load(std::memory_order_relaxed)) return 0;
+        uint64_t start = free_cursor.fetch_add(ALLOC_CHUNK, std::memory_order_relaxed);
+        if (start >= free_ids.size()) {
+            table_full.store(true, std::memory_order_relaxed);
+            return 0;
+        }
+        w.alloc_next = start;
+        w.alloc_end = std::min<uint64_t>(start + ALLOC_CHUNK, free_ids.size());
+    }
+    w.allocated.store(w.allocated.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return free_ids[w.alloc_next++];
+}
+
+void ParallelBddManager::rebuild_table() {
+    // buckets at most half full; the free list holds every unmarked index
+    size_t size = nodes.size() * 2;
+    buckets.reset(new std::atomic<uint64_t>[size]);
+    bucket_mask = size - 1;
+    for (size_t i = 0; i < size; ++i) buckets[i].store(0, std::memory_order_relaxed);
+    free_ids.clear();
+    used_at_collect = 0;
+    for (uint32_t i = 1; i < nodes.size(); ++i) {
+        Node& n = nodes[i];
+        if (!marks[i]) {
+            n.var = FREE_VAR;
+            free_ids.push_back(i);
+            continue;
+        }
+        uint64_t h = hash3(n.var, n.hi, n.lo);
+        size_t b = h & bucket_mask;
+        while (buckets[b].load(std::memory_order_relaxed) != 0) b = (b + 1) & bucket_mask;
+        buckets[b].store((h >> 32) << 32 | i, std::memory_order_relaxed);
+        used_at_collect++;
+    }
+    free_cursor = 0;
+    table_full = false;
+    for (auto& w : workers) {
+        w->alloc_next = w->alloc_end = 0;
+        w->spare = 0;
+        w->allocated = 0;
+    }
+}
+
+void ParallelBddManager::collect() {
+    mark_live(); // helpers are parked
+    peak = std::max<uint64_t>(peak, ReadNodeCount());
+    rebuild_table();
+
+    // cached results stay valid while all their nodes survive
+    for (size_t i = 0; i <= cache_mask; ++i) {
+        CacheEntry& c = cache[i];
+        if (c.op.load(std::memory_order_relaxed) == 0) continue;
+        uint32_t k[4] = {c.a, c.b, c.c, c.r};
+        bool live = true;
+        for (uint32_t e : k) live = live && e != INVALID && marks[e >> 1];
+        if (!live) c.op.store(0, std::memory_order_relaxed);
+    }
+    collections++;
+}
+
+void ParallelBddManager::grow() {
+    if (nodes.size() >= MAX_NODES) throw std::runtime_error("ParallelBddManager: node table full");
+    size_t size = nodes.size() * 2;
+    nodes.resize(size, Node{FREE_VAR, 0, 0, 0});
+    refs.resize(size, 0);
+    marks.resize(size, 0); // new nodes are unmarked, hence free
+    rebuild_table();
+    size_t entries = std::min(MAX_CACHE, std::max(MIN_CACHE, size / 2));
+    if (entries != cache_mask + 1) {
+        cache.reset(new CacheEntry[entries]);
+        cache_mask = entries - 1;
+    }
+}
+
+void ParallelBddManager::maybe_collect() {
+    // collect when the table is nearly full; grow ahead when most of it survives
+    uint64_t used = ReadNodeCount();
+    if (used + nodes.size() / 16 < nodes.size()) return;
+    collect();
+    if (used_at_collect > nodes.size() / 2 && nodes.size() < MAX_NODES) grow();
+}
+
+// --- Cache (one sequence counter per entry) ---
+
+bool ParallelBddManager::lookup(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t& r) {
+    CacheEntry& e = cache[cache_hash(op, a, b, c) & cache_mask];
+    uint32_t s = e.seq.load(std::memory_order_acquire);
+    if (s & 1) return false;
+    if (e.op.load(std::memory_order_relaxed) != op || e.a.load(std::memory_order_relaxed) != a ||
+        e.b.load(std::memory_order_relaxed) != b || e.c.load(std::memory_order_relaxed) != c) return false;
+    r = e.r.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return e.seq.load(std::memory_order_relaxed) == s;
+}
+
+void ParallelBddManager::insert(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t r) {
+    CacheEntry& e = cache[cache_hash(op, a, b, c) & cache_mask];
+    uint32_t s = e.seq.load(std::memory_order_relaxed);
+    if ((s & 1) || !e.seq.compare_exchange_strong(s, s + 1, std::memory_order_acquire)) return; // busy: drop
+    std::atomic_thread_fence(std::memory_order_release);
+    e.op.store(op, std::memory_order_relaxed);
+    e.a.store(a, std::memory_order_relaxed);
+    e.b.store(b, std::memory_order_relaxed);
+    e.c.store(c, std::memory_order_relaxed);
+    e.r.store(r, std::memory_order_relaxed);
+    e.seq.store(s + 2, std::memory_order_release);
+}
+
+// --- Tasks ---
+
+int64_t ParallelBddManager::spawn(uint32_t op, uint32_t a, uint32_t b, uint32_t c) {
+    if (workers.size() == 1) return -1;
+    Worker& w = *static_cast<Worker*>(tl_worker);
+    // top passes bottom when the last task was stolen or raced for: push above it
+    int64_t bot = std::max(w.bottom.load(std::memory_order_relaxed), w.top.load(std::memory_order_acquire));
+    Task& t = w.deque[bot & (DEQUE_SIZE - 1)];
+    if (t.state.load(std::memory_order_acquire) != TASK_EMPTY) return -1; // slot of an unsynced stolen task
+    t.op.store(op, std::memory_order_relaxed);
+    t.a.store(a, std::memory_order_relaxed);
+    t.b.store(b, std::memory_order_relaxed);
+    t.c.store(c, std::memory_order_relaxed);
+    t.state.store(TASK_QUEUED, std::memory_order_relaxed);
+    w.bottom.store(bot + 1, std::memory_order_release);
+    return bot;
+}
+
+uint32_t ParallelBddManager::sync(int64_t index) {
+    // Chase-Lev pop of the task spawned last. bottom stays at index: the
+    // tasks still to sync lie below it, stolen or not
+    Worker& w = *static_cast<Worker*>(tl_worker);
+    Task& t = w.deque[index & (DEQUE_SIZE - 1)];
+    w.bottom.store(index, std::memory_order_seq_cst);
+    int64_t top = w.top.load(std::memory_order_seq_cst);
+    bool mine = top < index;
+    if (top == index) mine = w.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst); // race the thieves
+    if (mine) {
+        uint32_t op = t.op.load(std::memory_order_relaxed), a = t.a.load(std::memory_order_relaxed);
+        uint32_t b = t.b.load(std::memory_order_relaxed), c = t.c.load(std::memory_order_relaxed);
+        t.state.store(TASK_EMPTY, std::memory_order_relaxed);
+        return run_task(op, a, b, c);
+    }
+    // stolen: help with other work until the thief is done
+    while (t.state.load(std::memory_order_acquire) != TASK_DONE) {
+        if (!steal_one(w)) std::this_thread::yield();
+    }
+    uint32_t r = t.result.load(std::memory_order_relaxed);
+    t.state.store(TASK_EMPTY, std::memory_order_release);
+    return r;
+}
+
+bool ParallelBddManager::steal_one(Worker& self) {
+    size_t n = workers.size();
+    self.rng ^= self.rng << 13; self.rng ^= self.rng >> 7; self.rng ^= self.rng << 17;
+    Worker& v = *workers[self.rng % n];
+    if (&v == &self) return false;
+    int64_t top = v.top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bot = v.bottom.load(std::memory_order_acquire);
+    if (top >= bot) return false;
+    Task& t = v.deque[top & (DEQUE_SIZE - 1)];
+    uint32_t op = t.op.load(std::memory_order_relaxed), a = t.a.load(std::memory_order_relaxed);
+    uint32_t b = t.b.load(std::memory_order_relaxed), c = t.c.load(std::memory_order_relaxed);
+    if (!v.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst)) return false;
+    t.state.store(TASK_STOLEN, std::memory_order_relaxed);
+    uint32_t r = run_task(op, a, b, c);
+    t.result.store(r, std::memory_order_relaxed);
+    t.state.store(TASK_DONE, std::memory_order_release);
+    return true;
+}
+
+uint32_t ParallelBddManager::run_task(uint32_t op, uint32_t a, uint32_t b, uint32_t c) {
+    switch (op & 15) {
+        case OP_AND:        return and_rec(a, b);
+        case OP_XOR:        return xor_rec(a, b);
+        case OP_EXISTS:     return exists_rec(a, b);
+        case OP_AND_EXISTS: return and_exists_rec(a, b, c);
+        case OP_REL_NEXT:   return rel_next_rec(a, b, c);
+    }
+    throw std::logic_error("ParallelBddManager: unknown task");
+}
+
+void ParallelBddManager::worker_loop(int id) {
+    Worker& w = *workers[id];
+    tl_worker = &w;
+    for (;;) {
+        // --- Wait for an operation: spin a little, then sleep ---
+        auto idle_since = std::chrono::steady_clock::now();
+        while (!active.load(std::memory_order_seq_cst) && !stopping.load(std::memory_order_relaxed)) {
+            if (std::chrono::steady_clock::now() - idle_since < std::chrono::milliseconds(2)) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(pool_mu);
+            pool_cv.wait(lock, [this] { return active.load() || stopping.load(); });
+        }
+        if (stopping.load()) return;
+
+        // --- Steal until the operation ends (park() waits for this loop to exit) ---
+        stealing.fetch_add(1, std::memory_order_seq_cst);
+        while (active.load(std::memory_order_seq_cst)) {
+            if (!steal_one(w)) std::this_thread::yield();
+        }
+        stealing.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+
+void ParallelBddManager::park() {
+    active.store(false, std::memory_order_seq_cst);
+    while (stealing.load(std::memory_order_seq_cst) != 0) std::this_thread::yield();
+}
+
+template <class F> uint32_t ParallelBddManager::run(F op) {
+    tl_worker = workers[0].get();
+    maybe_collect();
+    for (;;) {
+        if (workers.size() > 1) {
+            {
+                std::lock_guard<std::mutex> lock(pool_mu);
+                active.store(true, std::memory_order_seq_cst);
+            }
+            pool_cv.notify_all();
+        }
+        uint32_t r = op();
+        if (workers.size() > 1) park();
+        peak = std::max<uint64_t>(peak, ReadNodeCount());
+        if (r != INVALID) return r;
+        // the table filled up: the operation needs more room than was free
+        collect();
+        grow();
+    }
+}
+
+// --- Recursive operations ---
+// The parallel ones spawn the then-branch, compute the else-branch and then
+// sync; the table never moves during an operation, so node reads need no lock.
+
+uint32_t ParallelBddManager::and_rec(uint32_t f, uint32_t g) {
+    if (f == ZERO || g == ZERO || f == (g ^ 1)) return ZERO;
+    if (f == ONE || f == g) return g;
+    if (g == ONE) return f;
+    if (table_full.load(std::memory_order_relaxed)) return INVALID;
+    if (f > g) std::swap(f, g);
+    uint32_t r;
+    if (lookup(OP_AND, f, g, 0, r)) return r;
+
+    uint32_t v = std::min(top_var(f), top_var(g));
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    int64_t task = spawn(OP_AND, f1, g1, 0);
+    uint32_t e = and_rec(f0, g0);
+    uint32_t t = task >= 0 ? sync(task) : and_rec(f1, g1);
+    if (t == INVALID || e == INVALID) return INVALID;
+    r = make(v, t, e);
+    if (r != INVALID) insert(OP_AND, f, g, 0, r);
+    return r;
+}
+
+uint32_t ParallelBddManager::or_rec(uint32_t f, uint32_t g) {
+    return flip(and_rec(f ^ 1, g ^ 1), 1);
+}
+
+uint32_t ParallelBddManager::xor_rec(uint32_t f, uint32_t g) {
+    uint32_t c = (f ^ g) & 1;
+    f &= ~1u;
+    g &= ~1u;
+    if (f == g) return ZERO ^ c;
+    if (f == ONE) return g ^ 1 ^ c;
+    if (g == ONE) return f ^ 1 ^ c;
+    if (table_full.load(std::memory_order_relaxed)) return INVALID;
+    if (f > g) std::swap(f, g);
+    uint32_t r;
+    if (lookup(OP_XOR, f, g, 0, r)) return r ^ c;
+
+    uint32_t v = std::min(top_var(f), top_var(g));
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    int64_t task = spawn(OP_XOR, f1, g1, 0);
+    uint32_t e = xor_rec(f0, g0);
+    uint32_t t = task >= 0 ? sync(task) : xor_rec(f1, g1);
+    if (t == INVALID || e == INVALID) return INVALID;
+    r = make(v, t, e);
+    if (r == INVALID) return INVALID;
+    insert(OP_XOR, f, g, 0, r);
+    return r ^ c;
+}
+
+uint32_t ParallelBddManager::exists_rec(uint32_t f, uint32_t cube) {
+    if (edgeIsConstant(f)) return f;
+    uint32_t v = top_var(f);
+    while (cube != ONE && top_var(cube) < v) cube = nodes[cube >> 1].hi;
+    if (cube == ONE) return f;
+    if (table_full.load(std::memory_order_relaxed)) return INVALID;
+    uint32_t r;
+    if (lookup(OP_EXISTS, f, cube, 0, r)) return r;
+
+    uint32_t f1 = edgeThen(f), f0 = edgeElse(f);
+    bool quantified = top_var(cube) == v;
+    uint32_t below = quantified ? nodes[cube >> 1].hi : cube;
+    int64_t task = spawn(OP_EXISTS, f1, below, 0);
+    uint32_t e = exists_rec(f0, below);
+    uint32_t t = task >= 0 ? sync(task) : exists_rec(f1, below);
+    if (t == INVALID || e == INVALID) return INVALID;
+    r = quantified ? or_rec(e, t) : make(v, t, e);
+    if (r != INVALID) insert(OP_EXISTS, f, cube, 0, r);
+    return r;
+}
+
+uint32_t ParallelBddManager::and_exists_rec(uint32_t f, uint32_t g, uint32_t cube) {
+    if (f == ZERO || g == ZERO || f == (g ^ 1)) return ZERO;
+    if (f == ONE && g == ONE) return ONE;
+    if (cube == ONE) return and_rec(f, g);
+    if (f == ONE || f == g) return exists_rec(g, cube);
+    if (g == ONE) return exists_rec(f, cube);
+    uint32_t v = std::min(top_var(f), top_var(g));
+    while (cube != ONE && top_var(cube) < v) cube = nodes[cube >> 1].hi;
+    if (cube == ONE) return and_rec(f, g);
+    if (table_full.load(std::memory_order_relaxed)) return INVALID;
+    if (f > g) std::swap(f, g);
+    uint32_t r;
+    if (lookup(OP_AND_EXISTS, f, g, cube, r)) return r;
+
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    bool quantified = top_var(cube) == v;
+    uint32_t below = quantified ? nodes[cube >> 1].hi : cube;
+    int64_t task = spawn(OP_AND_EXISTS, f1, g1, below);
+    uint32_t e = and_exists_rec(f0, g0, below);
+    uint32_t t = task >= 0 ? sync(task) : and_exists_rec(f1, g1, below);
+    if (t == INVALID || e == INVALID) return INVALID;
+    r = quantified ? or_rec(e, t) : make(v, t, e);
+    if (r != INVALID) insert(OP_AND_EXISTS, f, g, cube, r);
+    return r;
+}
+
+uint32_t ParallelBddManager::rel_next_rec(uint32_t f, uint32_t g, uint32_t cube) {
+    // and_exists_rec, but the kept variables are renamed as the result is built
+    if (f == ZERO || g == ZERO || f == (g ^ 1)) return ZERO;
+    if (f == ONE && g == ONE) return ONE;
+    uint32_t v = std::min(top_var(f), top_var(g));
+    while (cube != ONE && top_var(cube) < v) cube = nodes[cube >> 1].hi;
+    if (cube == ONE && v >= rename_end) return and_rec(f, g); // nothing left to do below v
+    if (table_full.load(std::memory_order_relaxed)) return INVALID;
+    if (f > g) std::swap(f, g);
+    uint32_t op = OP_REL_NEXT | rename_gen << 4, r;
+    if (lookup(op, f, g, cube, r)) return r;
+
+    uint32_t f1 = f, f0 = f, g1 = g, g0 = g;
+    if (top_var(f) == v) { f1 = edgeThen(f); f0 = edgeElse(f); }
+    if (top_var(g) == v) { g1 = edgeThen(g); g0 = edgeElse(g); }
+    bool quantified = cube != ONE && top_var(cube) == v;
+    uint32_t below = quantified ? nodes[cube >> 1].hi : cube;
+    int64_t task = spawn(op, f1, g1, below);
+    uint32_t e = rel_next_rec(f0, g0, below);
+    uint32_t t = task >= 0 ? sync(task) : rel_next_rec(f1, g1, below);
+    if (t == INVALID || e == INVALID) return INVALID;
+    r = quantified ? or_rec(e, t) : make(rename_map[v], t, e);
+    if (r != INVALID) insert(op, f, g, cube, r);
+    return r;
+}
+
+// --- Handles ---
+
+ParallelBdd ParallelBdd::operator*(const ParallelBdd& g) const {
+    ParallelBddManager* m = manager_of(mgr, g.mgr);
+    uint32_t a = e, b = g.e;
+    return ParallelBdd(m, m->run([=] { return m->and_rec(a, b); }));
+}
+
+ParallelBdd ParallelBdd::operator+(const ParallelBdd& g) const {
+    ParallelBddManager* m = manager_of(mgr, g.mgr);
+    uint32_t a = e, b = g.e;
+    return ParallelBdd(m, m->run([=] { return m->or_rec(a, b); }));
+}
+
+ParallelBdd ParallelBdd::operator^(const ParallelBdd& g) const {
+    ParallelBddManager* m = manager_of(mgr, g.mgr);
+    uint32_t a = e, b = g.e;
+    return ParallelBdd(m, m->run([=] { return m->xor_rec(a, b); }));
+}
+
+ParallelBdd ParallelBdd::Ite(const ParallelBdd& g, const ParallelBdd& h) const {
+    ParallelBddManager* m = manager_of(mgr, manager_of(g.mgr, h.mgr));
+    uint32_t a = e, b = g.e, c = h.e;
+    return ParallelBdd(m, m->run([=] { return m->ite_rec(a, b, c); }));
+}
+
+ParallelBdd ParallelBdd::ExistAbstract(const ParallelBdd& cube) const {
+    ParallelBddManager* m = manager_of(mgr, cube.mgr);
+    uint32_t a = e, c = cube.e;
+    return ParallelBdd(m, m->run([=] { return m->exists_rec(a, c); }));
+}
+
+ParallelBdd ParallelBdd::AndAbstract(const ParallelBdd& g, const ParallelBdd& cube) const {
+    ParallelBddManager* m = manager_of(mgr, g.mgr);
+    uint32_t a = e, b = g.e, c = cube.e;
+    return ParallelBdd(m, m->run([=] { return m->and_exists_rec(a, b, c); }));
+}
+
+ParallelBdd ParallelBdd::SwapVariables(const std::vector<ParallelBdd>& x, const std::vector<ParallelBdd>& y) const {
+    if (!mgr) return *this;
+    ParallelBddManager* m = mgr;
+    m->set_permutation(x, y);
+    uint32_t a = e;
+    return ParallelBdd(m, m->run([=] { return m->permute_rec(a); }));
+}
+
+ParallelBdd ParallelBdd::Cofactor(const ParallelBdd& cube) const {
+    ParallelBddManager* m = manager_of(mgr, cube.mgr);
+    if (cube.e == ZERO) throw std::invalid_argument("BDD: cofactor by zero");
+    uint32_t a = e, c = cube.e;
+    return ParallelBdd(m, m->run([=] { return m->cofactor_rec(a, c); }));
+}
+
+double ParallelBdd::CountMinterm(int nvars) const {
+    if (!mgr) return e == ONE ? std::ldexp(1.0, nvars) : 0;
+    std::unordered_map<uint32_t, long double> memo;
+    return (double)std::ldexp(mgr->density(e, memo), nvars);
+}
+
+int ParallelBdd::nodeCount() const {
+    return mgr ? (int)mgr->dag_size(e) : 1;
+}
+
+ParallelBdd ParallelBdd::RelNext(const ParallelBdd& relation, const ParallelBdd& cube,
+                                 const std::vector<ParallelBdd>& from, const std::vector<ParallelBdd>& to) const {
+    ParallelBddManager* m = manager_of(mgr, relation.mgr);
+    if (!m->set_rename(from, to, cube.e)) return AndAbstract(relation, cube).SwapVariables(from, to);
+    uint32_t a = e, b = relation.e, c = cube.e;
+    return ParallelBdd(m, m->run([=] { return m->rel_next_rec(a, b, c); }));
+}
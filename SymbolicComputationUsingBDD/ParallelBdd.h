@@ -0,0 +1,183 @@
+#ifndef PARALLEL_BDD_H
+#define PARALLEL_BDD_H
+
+#include "BddCommon.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Multi-core variant of the native BDD package (NativeBdd.h), in the style
+// of Sylvan: the recursive operations (and, or, xor, exists, and-exists and
+// the fused image RelNext) split into tasks that idle workers steal, and all
+// workers share one lock-free unique table and operation cache. The API is
+// the same as NativeBdd's, so BddBackend.h can select it
+// (make BDD=parallel). The sequential operations (ite, permute, cofactor),
+// the variable maps, counting and the handle come from BddCommon.h.
+//
+// Unique table: node data in one array, found through an open-addressing
+// bucket array of 64-bit words (hash tag, node index) inserted with CAS, so
+// node indices never move. Workers allocate node indices in chunks from the
+// free list left by the last garbage collection.
+//
+// Cache: lossy and direct-mapped; every entry has a sequence counter, so a
+// reader never sees a half-written entry and a writer skips a busy entry.
+//
+// Tasks: one Chase-Lev deque per worker. A recursion spawns one branch,
+// computes the other and then syncs: a task nobody stole runs inline;
+// while a stolen one is still running the worker steals other work.
+//
+// When the free list runs out during an operation, the operation is
+// abandoned, the table is collected (and grown if still full) with all
+// workers parked, and the operation runs again. Garbage is otherwise
+// collected, as in NativeBdd, at the start of a top-level operation.
+//
+// The handles are not thread-safe: one thread drives the manager, the
+// workers only run inside its operations.
+
+class ParallelBdd;
+
+class ParallelBddManager : public bdd_common::BddManagerBase<ParallelBddManager> {
+public:
+    // numSlots: initial node table size, as in NativeBddManager
+    explicit ParallelBddManager(unsigned numVars = 0, unsigned numVarsZ = 0, unsigned numSlots = 1u << 16);
+    ~ParallelBddManager();
+    ParallelBddManager(const ParallelBddManager&) = delete;
+    ParallelBddManager& operator=(const ParallelBddManager&) = delete;
+
+    // Worker threads, the calling thread included (default: hardware threads)
+    void setWorkers(int n);
+    int ReadWorkers() const { return (int)workers.size(); }
+
+    ParallelBdd bddOne() const;
+    ParallelBdd bddZero() const;
+    ParallelBdd bddVar(int index) const;
+
+    int ReadSize() const { return (int)num_vars; }
+    long ReadNodeCount() const;
+    long ReadPeakNodeCount() const { return (long)std::max<uint64_t>(peak, ReadNodeCount()); }
+    long ReadGarbageCollections() const { return (long)collections; }
+
+    // Raw edges, for walking a diagram (see BddBackend.h)
+    static bool edgeIsComplement(uint32_t e) { return e & 1; }
+    static uint32_t edgeRegular(uint32_t e) { return e & ~1u; }
+    static bool edgeIsConstant(uint32_t e) { return (e >> 1) == 0; }
+    uint32_t edgeVar(uint32_t e) const { return nodes[e >> 1].var; }
+    uint32_t edgeThen(uint32_t e) const { return nodes[e >> 1].hi ^ (e & 1); }
+    uint32_t edgeElse(uint32_t e) const { return nodes[e >> 1].lo ^ (e & 1); }
+
+private:
+    friend class ParallelBdd;
+    friend class bdd_common::BddManagerBase<ParallelBddManager>;
+    friend class bdd_common::BddHandle<ParallelBdd, ParallelBddManager>;
+
+    struct Node { uint32_t var, hi, lo, pad; }; // hi: always regular
+    struct CacheEntry {
+        std::atomic<uint32_t> seq{0}; // odd while written
+        std::atomic<uint32_t> op{0}, a{0}, b{0}, c{0}, r{0};
+    };
+    struct Task {
+        std::atomic<uint32_t> op{0}, a{0}, b{0}, c{0};
+        std::atomic<uint32_t> result{0};
+        std::atomic<int> state{0}; // TASK_EMPTY until synced, TASK_QUEUED, TASK_STOLEN, TASK_DONE
+    };
+    struct Worker {
+        std::unique_ptr<Task[]> deque;
+        std::atomic<int64_t> top{0}, bottom{0};
+        uint64_t alloc_next = 0, alloc_end = 0;  // chunk of the free list
+        uint32_t spare = 0;                      // index of a node that lost an insert race
+        std::atomic<uint64_t> allocated{0};      // nodes created since the last collection
+        uint64_t rng = 0;
+    };
+
+    // --- Node table ---
+    uint32_t make(uint32_t var, uint32_t hi, uint32_t lo);
+    uint32_t alloc(Worker& w);
+    void collect();
+    void grow();
+    void rebuild_table(); // buckets and free list from the marked nodes
+    void maybe_collect();
+    void ref(uint32_t e) { refs[e >> 1]++; }
+    void deref(uint32_t e) { refs[e >> 1]--; }
+    uint32_t var_edge(uint32_t v);
+    bool out_of_nodes() const { return table_full.load(std::memory_order_relaxed); }
+
+    // --- Cache ---
+    bool lookup(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t& r);
+    void insert(uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t r);
+
+    // --- Tasks ---
+    int64_t spawn(uint32_t op, uint32_t a, uint32_t b, uint32_t c); // deque index, -1: run it inline
+    uint32_t sync(int64_t index);
+    bool steal_one(Worker& self);
+    uint32_t run_task(uint32_t op, uint32_t a, uint32_t b, uint32_t c);
+    void worker_loop(int id);
+    void park(); // stop the helpers before touching the table alone
+
+    // Runs op(args) as the calling thread's task with the helpers awake,
+    // again after a collection if the table filled up
+    template <class F> uint32_t run(F op);
+
+    // --- Parallel recursive operations (INVALID when the table filled up);
+    // ite, permute and cofactor run sequentially in BddManagerBase ---
+    uint32_t and_rec(uint32_t f, uint32_t g);
+    uint32_t or_rec(uint32_t f, uint32_t g);
+    uint32_t xor_rec(uint32_t f, uint32_t g);
+    uint32_t exists_rec(uint32_t f, uint32_t cube);
+    uint32_t and_exists_rec(uint32_t f, uint32_t g, uint32_t cube);
+    uint32_t rel_next_rec(uint32_t f, uint32_t g, uint32_t cube);
+
+    std::vector<Node> nodes;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets; // tag << 32 | index, 0 = empty
+    size_t bucket_mask = 0;
+    std::vector<uint32_t> refs;
+    std::vector<uint8_t> marks;
+    std::vector<uint32_t> free_ids;
+    std::atomic<uint64_t> free_cursor{0};
+    std::atomic<bool> table_full{false};
+    uint64_t used_at_collect = 0, peak = 0, collections = 0;
+
+    std::unique_ptr<CacheEntry[]> cache;
+    size_t cache_mask = 0;
+
+    // --- Worker pool: workers[0] is the calling thread ---
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<bool> active{false};  // an operation runs: helpers steal
+    std::atomic<int> stealing{0};     // helpers inside their steal loop
+    std::atomic<bool> stopping{false};
+    std::mutex pool_mu;
+    std::condition_variable pool_cv;
+};
+
+class ParallelBdd : public bdd_common::BddHandle<ParallelBdd, ParallelBddManager> {
+public:
+    ParallelBdd() = default;
+
+    ParallelBdd operator*(const ParallelBdd& g) const;
+    ParallelBdd operator+(const ParallelBdd& g) const;
+    ParallelBdd operator^(const ParallelBdd& g) const;
+    ParallelBdd Ite(const ParallelBdd& g, const ParallelBdd& h) const;
+    ParallelBdd ExistAbstract(const ParallelBdd& cube) const;
+    ParallelBdd AndAbstract(const ParallelBdd& g, const ParallelBdd& cube) const;
+    ParallelBdd SwapVariables(const std::vector<ParallelBdd>& x, const std::vector<ParallelBdd>& y) const;
+    ParallelBdd Cofactor(const ParallelBdd& cube) const;
+    double CountMinterm(int nvars) const;
+    int nodeCount() const;
+
+    // Fused image, as in NativeBdd (ImageUnion comes from BddHandle)
+    ParallelBdd RelNext(const ParallelBdd& relation, const ParallelBdd& cube,
+                        const std::vector<ParallelBdd>& from, const std::vector<ParallelBdd>& to) const;
+
+private:
+    friend class ParallelBddManager;
+    friend class bdd_common::BddHandle<ParallelBdd, ParallelBddManager>;
+    ParallelBdd(ParallelBddManager* m, uint32_t edge) : BddHandle(m, edge) {}
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "PlaceEncoding.h"
+#include "PNML_Parser/Invariants.h"
+#include <algorithm>
+#include <stdexcept>
+
+// Remove duplicated arcs so that "one token in, one token out" is easy to check
+static std::vector<int> unique_places(std::vector<int> places) {
+    std::sort(places.begin(), places.end());
+    places.erase(std::unique(places.begin(), places.end()), places.end());
+    return places;
+}
+
+std::vector<std::vector<int>> find_exclusive_groups(const PetriNet& pn) {
+    int num_places = pn.place_ids.size();
+    int num_transitions = pn.transition_ids.size();
+
+    std::vector<std::vector<int>> pre(num_transitions), post(num_transitions);
+    std::vector<std::vector<int>> touching(num_places); // transitions with an arc to/from the place
+    for (int t = 0; t < num_transitions; ++t) {
+        pre[t] = unique_places(pn.pre_matrix[t]);
+        post[t] = unique_places(pn.post_matrix[t]);
+        for (int p : pre[t]) touching[p].push_back(t);
+        for (int p : post[t]) touching[p].push_back(t);
+    }
+
+    std::vector<int> owner(num_places, -1); // group already claiming the place
+    std::vector<std::vector<int>> groups;
+
+    // 1. P-semiflows with unit weights and y.M0 = 1: exactly one place of the
+    // support is marked in every reachable marking. Largest groups first.
+    std::vector<std::vector<int>> unit_flows;
+    try {
+        SemiflowResult p_flows = computePSemiflows(pn, 20000);
+        for (const auto& flow : p_flows.flows) {
+            bool unit = flow.weights.size() >= 2;
+            for (auto& w : flow.weights) unit = unit && w.second == 1;
+            if (!unit || semiflowValue(flow, pn.initial_marking) != 1) continue;
+
+            std::vector<int> places;
+            for (auto& w : flow.weights) places.push_back(w.first);
+            unit_flows.push_back(places);
+        }
+    } catch (const std::overflow_error&) {
+        unit_flows.clear(); // fall back to the closure search below
+    }
+    std::stable_sort(unit_flows.begin(), unit_flows.end(),
+                     [](const std::vector<int>& a, const std::vector<int>& b) { return a.size() > b.size(); });
+    for (const auto& places : unit_flows) {
+        bool free = true;
+        for (int p : places) free = free && owner[p] == -1;
+        if (!free) continue;
+        for (int p : places) owner[p] = groups.size();
+        groups.push_back(places);
+    }
+
+    // 2. State-machine components grown from the remaining marked places
+
+    for (int seed = 0; seed < num_places; ++seed) {
+        if (owner[seed] != -1 || pn.initial_marking[seed] != 1) continue;
+
+        // Grow S from the marked seed. Every transition touching S must move the
+        // single token inside S; when exactly one place can absorb (or supply)
+        // that token it is added, any other situation rejects the seed.
+        std::vector<char> in_s(num_places, 0);
+        std::vector<int> members = {seed};
+        std::vector<int> work(touching[seed]);
+        in_s[seed] = 1;
+        bool ok = true;
+
+        while (ok && !work.empty()) {
+            int t = work.back();
+            work.pop_back();
+
+            int n_in = 0, n_out = 0;
+            for (int p : pre[t]) n_in += in_s[p];
+            for (int p : post[t]) n_out += in_s[p];
+            if (n_in > 1 || n_out > 1) { ok = false; break; }
+            if (n_in == n_out) continue;
+
+            // The side missing a place of S must offer exactly one free candidate
+            const std::vector<int>& side = (n_in == 1) ? post[t] : pre[t];
+            int candidate = -1, count = 0;
+            for (int p : side) {
+                if (owner[p] == -1 && pn.initial_marking[p] == 0) {
+                    candidate = p;
+                    count++;
+                }
+            }
+            if (count != 1) { ok = false; break; }
+
+            in_s[candidate] = 1;
+            members.push_back(candidate);
+            work.insert(work.end(), touching[candidate].begin(), touching[candidate].end());
+        }
+
+        if (!ok || members.size() < 2) continue;
+
+        std::sort(members.begin(), members.end());
+        for (int p : members) owner[p] = groups.size();
+        groups.push_back(members);
+    }
+
+    return groups;
+}
+
+PlaceEncoding build_encoding(const PetriNet& pn, const std::vector<std::vector<int>>& groups) {
+    int num_places = pn.place_ids.size();
+
+    PlaceEncoding enc;
+    enc.groups = groups;
+    enc.group_of.assign(num_places, -1);
+    enc.code_of.assign(num_places, 0);
+    enc.bit_of.assign(num_places, -1);
+    enc.group_first_bit.assign(groups.size(), -1);
+    enc.group_width.assign(groups.size(), 0);
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        for (size_t c = 0; c < groups[g].size(); ++c) {
+            enc.group_of[groups[g][c]] = g;
+            enc.code_of[groups[g][c]] = c;
+        }
+        int width = 0;
+        while ((1u << width) < groups[g].size()) width++;
+        enc.group_width[g] = width;
+    }
+
+    // Allocate bits in place order so that a group sits where its first place was
+    for (int p = 0; p < num_places; ++p) {
+        int g = enc.group_of[p];
+        if (g == -1) {
+            enc.bit_of[p] = enc.num_bits++;
+        } else if (enc.group_first_bit[g] == -1) {
+            enc.group_first_bit[g] = enc.num_bits;
+            enc.num_bits += enc.group_width[g];
+        }
+    }
+
+    return enc;
+}
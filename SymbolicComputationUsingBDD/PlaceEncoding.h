@@ -0,0 +1,36 @@
+#ifndef PLACE_ENCODING_H
+#define PLACE_ENCODING_H
+
+#include "PNML_Parser/PetriNet.h"
+
+#include <vector>
+
+// Compact variable layout for the BDD engine.
+// A "group" is a set of places where exactly one place is marked in every
+// reachable marking (1-of-k). Such a group is stored as a binary number on
+// ceil(log2 k) bits instead of k one-hot bits. Places outside any group keep
+// their own bit.
+struct PlaceEncoding {
+    std::vector<std::vector<int>> groups; // groups[g] = places of group g (code = position)
+
+    std::vector<int> group_of;  // [place] -> group index, or -1 if the place has its own bit
+    std::vector<int> code_of;   // [place] -> code of the place inside its group
+    std::vector<int> bit_of;    // [place] -> its bit (ungrouped places only)
+
+    std::vector<int> group_first_bit; // [group] -> first bit of the group
+    std::vector<int> group_width;     // [group] -> number of bits of the group
+
+    int num_bits = 0;
+};
+
+// Detect disjoint 1-of-k place groups.
+// Candidates are unit P-semiflows whose weighted sum in M0 is 1, then
+// state-machine components: sets S where M0 marks exactly one place of S and
+// every transition either does not touch S, or consumes one token from S and
+// puts one back.
+std::vector<std::vector<int>> find_exclusive_groups(const PetriNet& pn);
+
+// Build the bit layout. Pass no groups to get the plain one-bit-per-place layout.
+PlaceEncoding build_encoding(const PetriNet& pn, const std::vector<std::vector<int>>& groups);
+
+#endif
@@ -1,28 +1,108 @@
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
 #include "PNML_Parser/PetriNet.h"
+#include "PNML_Parser/Reduction.h"
 #include "BDD_Reachability.h"
+#include "PNML_Parser/Progress.h"
+#include "PNML_Parser/Trace.h"
+#include <memory>
+#include <new>
+#include <stdexcept>
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cout << "Usage: ./main <pnml_file_path>" << std::endl;
+        std::cout << "Usage: ./main <pnml_file_path> [--one-hot] [--reduce]"
+                  << " [--checkpoint <path>] [--checkpoint-every <seconds>] [--resume] [--trace <file.json>]"
+                  << " [--progress <seconds>] [--threads <n>]" << std::endl;
         return 1;
     }
 
     std::string filename = argv[1];
-    PetriNet pn;
-
-    // Parse file PNML
-    std::cout << "Parsing " << filename << "..." << std::endl;
-    if (!pn.parsePNML(filename)) {
-        std::cerr << "Failed to parse PNML." << std::endl;
+    bool log_encoding = true;
+    bool reduce = false;
+    std::string checkpoint_path;
+    double checkpoint_seconds = 60;
+    bool resume = false;
+    std::string trace_path;
+    double progress_seconds = 0;
+    int threads = 0;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--one-hot") == 0) log_encoding = false;
+        else if (std::strcmp(argv[i], "--reduce") == 0) reduce = true;
+        else if (std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) checkpoint_path = argv[++i];
+        else if (std::strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) checkpoint_seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--resume") == 0) resume = true;
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+        else if (std::strcmp(argv[i], "--progress") == 0 && i + 1 < argc) progress_seconds = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = std::atoi(argv[++i]);
+    }
+    if (!trace_path.empty() && !traceStart(trace_path, "petri_solver")) {
+        std::cerr << "Cannot write trace " << trace_path << std::endl;
         return 1;
     }
+    // Heartbeat on stderr while the solver runs
+    std::unique_ptr<ProgressReporter> reporter;
+    if (progress_seconds > 0) reporter.reset(new ProgressReporter(progress_seconds));
+
+    // Exit codes: 2 = the net cannot be parsed, 3 = out of memory (what
+    // petri_analyze reports as parse_error and memout)
+    try {
+        PetriNet pn;
+
+        // Parse file PNML
+        std::cout << "Parsing " << filename << "..." << std::endl;
+        if (!pn.parsePNML(filename)) {
+            std::cerr << "Failed to parse PNML." << std::endl;
+            return 2;
+        }
+
+        // Optional structural reduction before the symbolic exploration
+        ReductionResult reduction;
+        PetriNet* net = &pn;
+        if (reduce) {
+            TraceSpan reduce_span("structural reduction", "parse");
+            // only count-preserving rules: agglomerations would drop markings
+            reduction = reduceNet(pn, /*preserve_state_count=*/true);
+            reduce_span.end();
+            net = &reduction.net;
+            std::cout << "Reduced: " << pn.place_ids.size() << " places, " << pn.transition_ids.size()
+                      << " transitions -> " << net->place_ids.size() << " places, "
+                      << net->transition_ids.size() << " transitions ("
+                      << reduction.log.size() << " rules applied)" << std::endl;
+        }
+
+        BDDReachability bdd_solver(*net, log_encoding);
+        bdd_solver.set_threads(threads);
+        std::cout << "Encoding: " << net->place_ids.size() << " places -> "
+                  << bdd_solver.num_bits() << " bits ("
+                  << bdd_solver.get_encoding().groups.size() << " 1-of-k groups)" << std::endl;
 
-    BDDReachability bdd_solver(pn);
-    
-    std::pair<BDD, double> result = bdd_solver.compute_reachable_markings();
+        if (!checkpoint_path.empty()) bdd_solver.enable_checkpoints(checkpoint_path, checkpoint_seconds, resume);
 
-    std::cout << "Total reachable markings: " << (long long)result.second << std::endl;
+        std::pair<BDD, double> result = bdd_solver.compute_reachable_markings();
+        std::cout << "Iterations: " << bdd_solver.get_iterations() << std::endl;
+        std::cout << "Peak nodes: " << bdd_solver.get_peak_nodes() << std::endl;
 
-    return 0;
-}
\ No newline at end of file
+        if (reduce && !reduction.exact_state_count) {
+            // never report the count of a reduced net as that of the original
+            std::cerr << "Reduced net does not preserve the state count; no count printed." << std::endl;
+            traceStop();
+            return 1;
+        }
+        std::cout << "Total reachable markings: " << (long long)result.second << std::endl;
+
+        traceStop();
+        return 0;
+    }
+    catch (const std::bad_alloc&) {
+        std::cout << "Out of memory" << std::endl;
+        traceStop();
+        return 3;
+    }
+    catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        traceStop();
+        return 1;
+    }
+}
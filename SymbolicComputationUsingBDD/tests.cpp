@@ -0,0 +1,361 @@
+// Unit tests of the BDD packages (make test). Every operation is checked
+// against brute-force truth tables over N variables. The managers start with
+// a tiny node table, so garbage collection, table growth and rehashing all
+// happen while the operations run; the parallel package must build the
+// same diagrams as the native one with any number of workers.
+#include "NativeBdd.h"
+#include "ParallelBdd.h"
+#include <bitset>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+const int N = 10;               // variables
+const unsigned ALL = (1u << N) - 1;
+const unsigned TINY_TABLE = 64; // initial node table size of the tested managers
+typedef bitset<1u << N> Table;  // bit z: value of the function at assignment z (bit v = variable v)
+
+int failures = 0;
+
+void assertTrue(bool ok, const string& testName) {
+    cout << (ok ? "[PASS] " : "[FAIL] ") << testName << "\n";
+    if (!ok) failures++;
+}
+
+// --- Reading a diagram ---
+
+template <class Mgr> bool evaluate(const Mgr& m, uint32_t e, unsigned z) {
+    while (!Mgr::edgeIsConstant(e)) e = (z >> m.edgeVar(e) & 1) ? m.edgeThen(e) : m.edgeElse(e);
+    return e == bdd_common::ONE;
+}
+
+template <class Mgr> Table tableOf(const Mgr& m, uint32_t e) {
+    Table t;
+    for (unsigned z = 0; z <= ALL; ++z) t[z] = evaluate(m, e, z);
+    return t;
+}
+
+// Reduced, ordered and canonical below e: then-edges regular, children on
+// lower levels, no redundant node and no two nodes with the same triple
+template <class Mgr> bool wellFormed(const Mgr& m, uint32_t e) {
+    map<tuple<uint32_t, uint32_t, uint32_t>, uint32_t> triples;
+    set<uint32_t> visited;
+    vector<uint32_t> stack = {Mgr::edgeRegular(e)};
+    while (!stack.empty()) {
+        uint32_t r = stack.back();
+        stack.pop_back();
+        if (Mgr::edgeIsConstant(r) || !visited.insert(r).second) continue;
+        uint32_t v = m.edgeVar(r), hi = m.edgeThen(r), lo = m.edgeElse(r);
+        if (Mgr::edgeIsComplement(hi) || hi == lo) return false;
+        for (uint32_t c : {hi, lo}) {
+            if (!Mgr::edgeIsConstant(c) && m.edgeVar(c) <= v) return false;
+        }
+        auto it = triples.emplace(make_tuple(v, hi, lo), r).first;
+        if (it->second != r) return false;
+        stack.push_back(hi);
+        stack.push_back(Mgr::edgeRegular(lo));
+    }
+    return true;
+}
+
+// Same diagram in two managers: equal variables and complement bits node by node
+template <class MgrA, class MgrB> bool sameDiagram(const MgrA& ma, uint32_t ea, const MgrB& mb, uint32_t eb) {
+    map<uint32_t, uint32_t> match; // regular edge in a -> regular edge in b
+    vector<pair<uint32_t, uint32_t>> stack = {{ea, eb}};
+    while (!stack.empty()) {
+        uint32_t a = stack.back().first, b = stack.back().second;
+        stack.pop_back();
+        if (MgrA::edgeIsComplement(a) != MgrB::edgeIsComplement(b)) return false;
+        if (MgrA::edgeIsConstant(a) || MgrB::edgeIsConstant(b)) {
+            if (MgrA::edgeIsConstant(a) != MgrB::edgeIsConstant(b)) return false;
+            continue;
+        }
+        auto it = match.emplace(MgrA::edgeRegular(a), MgrB::edgeRegular(b));
+        if (it.first->second != MgrB::edgeRegular(b)) return false;
+        if (!it.second) continue;
+        if (ma.edgeVar(a) != mb.edgeVar(b)) return false;
+        stack.push_back({ma.edgeThen(a), mb.edgeThen(b)});
+        stack.push_back({ma.edgeElse(a), mb.edgeElse(b)});
+    }
+    return true;
+}
+
+// --- Brute force ---
+
+Table existsTable(const Table& f, unsigned q) {
+    Table r;
+    for (unsigned z = 0; z <= ALL; ++z) {
+        unsigned s = q;
+        do { r[z] = r[z] || f[(z & ~q) | s]; s = (s - 1) & q; } while (s != q && !r[z]);
+    }
+    return r;
+}
+
+// f restricted to the literals of a cube: variables 'mask' set to 'values'
+Table cofactorTable(const Table& f, unsigned mask, unsigned values) {
+    Table r;
+    for (unsigned z = 0; z <= ALL; ++z) r[z] = f[(z & ~mask) | values];
+    return r;
+}
+
+// f with variable from[i] and to[i] exchanged
+Table swapTable(const Table& f, const vector<int>& from, const vector<int>& to) {
+    Table r;
+    for (unsigned z = 0; z <= ALL; ++z) {
+        unsigned w = z;
+        for (size_t i = 0; i < from.size(); ++i) {
+            w &= ~(1u << from[i] | 1u << to[i]);
+            w |= (z >> from[i] & 1) << to[i] | (z >> to[i] & 1) << from[i];
+        }
+        r[z] = f[w];
+    }
+    return r;
+}
+
+// (exists q . s and rel) with from[i] renamed to to[i]; the to-variables are in q
+Table imageTable(const Table& s, const Table& rel, unsigned q, const vector<int>& from, const vector<int>& to) {
+    unsigned fromMask = 0;
+    for (int v : from) fromMask |= 1u << v;
+    Table hit;
+    for (unsigned a = 0; a <= ALL; ++a) {
+        if (!s[a] || !rel[a]) continue;
+        unsigned z = a & ~q & ~fromMask;
+        for (size_t i = 0; i < from.size(); ++i) z |= (a >> from[i] & 1) << to[i];
+        hit[z] = 1;
+    }
+    Table r;
+    for (unsigned z = 0; z <= ALL; ++z) r[z] = hit[z & ~fromMask];
+    return r;
+}
+
+// --- Random operation sequence ---
+
+// A pool of functions and their truth tables. Each step applies a random
+// operation to pool members, checks the result against the brute-force
+// table and replaces a random member with it. Equal tables seen during the
+// run must come back as the same edge (canonicity), also after collections.
+template <class Mgr, class Bdd> struct RandomOps {
+    Mgr& m;
+    mt19937 rng;
+    vector<Bdd> vars;
+    vector<Bdd> pool;
+    vector<Table> tables;
+    unordered_map<Table, Bdd> seen; // first handle of each table, kept alive
+    string failed;                  // first failed check, empty when all passed
+    size_t last = 0;                // pool slot of the last result
+
+    RandomOps(Mgr& manager, unsigned seed, size_t poolSize = 24) : m(manager), rng(seed) {
+        for (int v = 0; v < N; ++v) vars.push_back(m.bddVar(v));
+        for (size_t i = 0; i < poolSize; ++i) {
+            int v = (int)(i % N);
+            pool.push_back(i % 2 ? vars[v] : !vars[v]);
+            tables.push_back(varTable(v, i % 2 == 1));
+        }
+    }
+
+    static Table varTable(int v, bool positive) {
+        Table t;
+        for (unsigned z = 0; z <= ALL; ++z) t[z] = (z >> v & 1) == (unsigned)positive;
+        return t;
+    }
+
+    unsigned randomMask() { return rng() & ALL; }
+    size_t pick() { return rng() % pool.size(); }
+
+    Bdd cubeOf(unsigned mask) {
+        Bdd c = m.bddOne();
+        for (int v = 0; v < N; ++v) if (mask >> v & 1) c *= vars[v];
+        return c;
+    }
+
+    void check(const Bdd& r, const Table& expected, const string& op) {
+        if (!failed.empty()) return;
+        if (tableOf(m, r.getEdge()) != expected) failed = op + ": wrong function";
+        else if (!wellFormed(m, r.getEdge())) failed = op + ": not reduced";
+        else if (r.CountMinterm(N) != (double)expected.count()) failed = op + ": wrong CountMinterm";
+        else {
+            auto it = seen.find(expected);
+            if (it == seen.end()) { if (seen.size() < 256) seen.emplace(expected, r); }
+            else if (!(it->second == r)) failed = op + ": two edges for one function";
+        }
+    }
+
+    void step() {
+        size_t a = pick(), b = pick(), c = pick();
+        const Bdd &f = pool[a], &g = pool[b], &h = pool[c];
+        const Table &tf = tables[a], &tg = tables[b], &th = tables[c];
+        Bdd r;
+        Table t;
+        string op;
+        switch (rng() % 11) {
+        case 0: op = "and"; r = f * g; t = tf & tg; break;
+        case 1: op = "or"; r = f + g; t = tf | tg; break;
+        case 2: op = "xor"; r = f ^ g; t = tf ^ tg; break;
+        case 3: op = "not"; r = !f; t = ~tf; break;
+        case 4: op = "ite"; r = f.Ite(g, h); t = (tf & tg) | (~tf & th); break;
+        case 5: {
+            op = "exists";
+            unsigned q = randomMask();
+            r = f.ExistAbstract(cubeOf(q));
+            t = existsTable(tf, q);
+            break;
+        }
+        case 6: {
+            op = "and-exists";
+            unsigned q = randomMask();
+            r = f.AndAbstract(g, cubeOf(q));
+            t = existsTable(tf & tg, q);
+            break;
+        }
+        case 7: {
+            op = "cofactor";
+            unsigned mask = randomMask(), values = randomMask() & mask;
+            Bdd cube = m.bddOne();
+            for (int v = 0; v < N; ++v) if (mask >> v & 1) cube *= (values >> v & 1) ? vars[v] : !vars[v];
+            r = f.Cofactor(cube);
+            t = cofactorTable(tf, mask, values);
+            break;
+        }
+        case 8: {
+            op = "swap";
+            vector<int> from = {0, 1, 2, 3, 4}, to = {5, 6, 7, 8, 9};
+            vector<Bdd> x, y;
+            for (size_t i = 0; i < from.size(); ++i) { x.push_back(vars[from[i]]); y.push_back(vars[to[i]]); }
+            r = f.SwapVariables(x, y);
+            t = swapTable(tf, from, to);
+            break;
+        }
+        case 9: {
+            // interleaved x_i = 2i, y_i = 2i+1 (the engine's layout): the
+            // rename keeps the order, so RelNext takes the fused path;
+            // reversed pairs take the AndAbstract + SwapVariables fallback
+            bool reversed = rng() % 2;
+            op = reversed ? "relnext (reversed)" : "relnext";
+            vector<int> from, to;
+            for (int i = 0; i < N / 2; ++i) { from.push_back(2 * i + 1); to.push_back(reversed ? N - 2 - 2 * i : 2 * i); }
+            unsigned q = 0;
+            for (int v : to) q |= 1u << v;
+            vector<Bdd> fromB, toB;
+            for (size_t i = 0; i < from.size(); ++i) { fromB.push_back(vars[from[i]]); toB.push_back(vars[to[i]]); }
+            Bdd cube = cubeOf(q);
+            if (rng() % 2) {
+                r = f.RelNext(g, cube, fromB, toB);
+                t = imageTable(tf, tg, q, from, to);
+            }
+            else {
+                op = reversed ? "image union (reversed)" : "image union";
+                r = f.ImageUnion({g, h}, cube, fromB, toB);
+                t = tf | imageTable(tf, tg, q, from, to) | imageTable(tf, th, q, from, to);
+            }
+            break;
+        }
+        default: {
+            // fresh literals keep the pool from collapsing to constants
+            op = "literal";
+            int v = (int)(rng() % N);
+            bool positive = rng() % 2;
+            r = positive ? vars[v] : !vars[v];
+            t = varTable(v, positive);
+            break;
+        }
+        }
+        check(r, t, op);
+        last = pick();
+        pool[last] = r;
+        tables[last] = t;
+    }
+
+    // Every pool member and remembered handle still denotes its table
+    bool survivors() const {
+        for (size_t i = 0; i < pool.size(); ++i) if (tableOf(m, pool[i].getEdge()) != tables[i]) return false;
+        for (const auto& s : seen) if (tableOf(m, s.second.getEdge()) != s.first) return false;
+        return true;
+    }
+};
+
+// --- Native package ---
+
+void test_Native_1() {
+    NativeBddManager m(0, 0, TINY_TABLE);
+    RandomOps<NativeBddManager, NativeBdd> ops(m, 1);
+    for (int i = 0; i < 3000 && ops.failed.empty(); ++i) ops.step();
+    assertTrue(ops.failed.empty(), "Native Test 1 (operations against truth tables)" +
+               (ops.failed.empty() ? string() : ": " + ops.failed));
+    assertTrue(ops.survivors(), "Native Test 1 (handles survive collection and rehash)");
+    assertTrue(m.ReadGarbageCollections() > 0 && m.ReadPeakNodeCount() > (long)TINY_TABLE,
+               "Native Test 1 (table collected and grown)");
+}
+
+// Rebuilding a function after its nodes were collected and their slots
+// reused gives the same function, not a stale cache entry
+void test_Native_2() {
+    NativeBddManager m(2 * N, 0, TINY_TABLE);
+    vector<NativeBdd> x;
+    for (int v = 0; v < 2 * N; ++v) x.push_back(m.bddVar(v));
+    Table expected;
+    {
+        NativeBdd f = (x[0] * x[3]) + (x[5] ^ x[9]);
+        expected = tableOf(m, f.getEdge());
+    }
+    // garbage on the other variables until a collection frees f, then live
+    // nodes that take over its slots
+    mt19937 rng(2);
+    auto other = [&]() {
+        NativeBdd g = m.bddOne();
+        for (int v = N; v < 2 * N; ++v) g = (rng() % 2) ? g * x[v] : g ^ x[v];
+        return g;
+    };
+    long before = m.ReadGarbageCollections();
+    while (m.ReadGarbageCollections() == before) other();
+    vector<NativeBdd> kept;
+    for (int i = 0; i < 64; ++i) kept.push_back(other());
+    NativeBdd f = (x[0] * x[3]) + (x[5] ^ x[9]);
+    assertTrue(tableOf(m, f.getEdge()) == expected && wellFormed(m, f.getEdge()),
+               "Native Test 2 (results after collection)");
+}
+
+// --- Parallel package ---
+
+// The same random operations with 1, 4 and 8 workers, from a tiny table so
+// that operations run out of nodes and are retried after collect/grow while
+// tasks are being stolen; every result must be the native package's diagram
+void test_Parallel_1() {
+    for (int threads : {1, 4, 8}) {
+        ParallelBddManager p(0, 0, TINY_TABLE);
+        p.setWorkers(threads);
+        NativeBddManager m(0, 0, TINY_TABLE);
+        RandomOps<ParallelBddManager, ParallelBdd> par(p, 3);
+        RandomOps<NativeBddManager, NativeBdd> nat(m, 3);
+        bool same = true;
+        for (int i = 0; i < 3000 && par.failed.empty() && same; ++i) {
+            par.step();
+            nat.step();
+            same = sameDiagram(p, par.pool[par.last].getEdge(), m, nat.pool[nat.last].getEdge());
+        }
+        string name = "Parallel Test 1 (" + to_string(threads) + " workers";
+        assertTrue(par.failed.empty(), name + ", operations against truth tables)" +
+                   (par.failed.empty() ? string() : ": " + par.failed));
+        assertTrue(same, name + ", same diagrams as the native package)");
+        assertTrue(par.survivors(), name + ", handles survive collection and growth)");
+        assertTrue(p.ReadGarbageCollections() > 0 && p.ReadPeakNodeCount() > (long)TINY_TABLE,
+                   name + ", table collected and grown)");
+    }
+}
+
+int main() {
+    cout << "====== Running Native BDD Tests ======\n";
+    test_Native_1();
+    test_Native_2();
+
+    cout << "\n====== Running Parallel BDD Tests ======\n";
+    test_Parallel_1();
+
+    cout << "\nAll tests completed.\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -1,81 +1,64 @@
 #include "BFS.h"
+#include "CompiledNet.h"
+#include "../PNML_Parser/Progress.h"
+#include "../PNML_Parser/Trace.h"
+#include <optional>
 #include <queue>
-#include <stdexcept>
 using namespace std;
-// transpose helper
-static vector<vector<int>> transpose(const vector<vector<int>>& mat) {
-    if(mat.empty()) return {};
-    size_t rows = mat.size();
-    size_t cols = mat[0].size();
-    vector<vector<int>> res(cols, vector<int>(rows));
-    for(size_t i=0;i<rows;++i)
-        for(size_t j=0;j<cols;++j)
-            res[j][i] = mat[i][j];
-    return res;
-}
-
-static pair<vector<vector<int>>, vector<vector<int>>>
-_infer_IO(const vector<vector<int>>& I,
-          const vector<vector<int>>& O,
-          int n_places)
-{
-    int I_rows = (int)I.size();
-    int I_cols = I_rows>0 ? (int)I[0].size() : 0;
-    int O_rows = (int)O.size();
-    int O_cols = O_rows>0 ? (int)O[0].size() : 0;
-
-    if(I_rows == n_places && O_rows == n_places){
-        if(I_cols != O_cols) throw invalid_argument("I and O have incompatible trans dimension");
-        return {I,O};
-    }
-    if(I_cols == n_places && O_cols == n_places){
-        return {transpose(I), transpose(O)};
-    }
-    throw invalid_argument("Cannot infer I/O matrix orientation");
-}
 
 MarkingSet bfs_reachable(const PetriNet& pn) {
-    int n_places = (int)pn.M0.size();
-    auto IO = _infer_IO(pn.I, pn.O, n_places);
-    const auto& I = IO.first;
-    const auto& O = IO.second;
-    int n_trans = (int)I[0].size();
+    ExactStore visited;
+    bfs_reachable(pn, visited);
+    return visited.take();
+}
 
-    Marking M0 = pn.M0;
+ExplorationStats bfs_reachable(const PetriNet& pn, StateStore& store) {
+    CompiledNet net = compile_net(pn);
+    ExplorationStats stats;
 
-    auto enabled = [&](const Marking& M, int j)->bool{
-        for(int i=0;i<n_places;++i){
-            if(M[i] < I[i][j]) return false;
-        }
-        for(int i=0;i<n_places;++i){
-            int Mnew_i = M[i] - I[i][j] + O[i][j];
-            if(Mnew_i > 1) return false; // 1-safe constraint
-        }
-        return true;
-    };
+    queue<Marking> q;
+    store.insert(pn.M0);
+    q.push(pn.M0);
+    bool safe_start = within_bound(net, pn.M0); // nothing fires from an unsafe M0
 
-    auto fire = [&](const Marking& M, int j)->Marking{
-        Marking Mnew(n_places);
-        for(int i=0;i<n_places;++i) Mnew[i] = M[i] - I[i][j] + O[i][j];
-        return Mnew;
-    };
+    // The queue holds the rest of one level, then the next one (for the trace)
+    uint64_t depth = 0, level_left = 1, next_level = 0;
+    optional<TraceSpan> level;
+    level.emplace("BFS level", "bfs");
 
-    MarkingSet visited;
-    queue<Marking> q;
-    visited.insert(M0);
-    q.push(M0);
+    // Heartbeat counters (plain relaxed stores, read by a ProgressReporter)
+    ProgressCounters& progress = progressCounters();
+    int64_t stored = 1;
+    progress.states.store(stored, memory_order_relaxed);
+    progress.depth.store(0, memory_order_relaxed);
 
     while(!q.empty()){
         Marking M = q.front(); q.pop();
-        for(int j=0;j<n_trans;++j){
-            if(enabled(M,j)){
-                Marking Mnew = fire(M,j);
-                if(visited.find(Mnew) == visited.end()){
-                    visited.insert(Mnew);
-                    q.push(Mnew);
-                }
+        bool any = false;
+        for(int j=0;safe_start && j<net.n_trans;++j){
+            if(is_enabled(net,M,j)){
+                any = true;
+                stats.edges++;
+                Marking Mnew = fire(net,M,j);
+                if(store.insert(Mnew)){ q.push(Mnew); next_level++; stored++; }
             }
         }
+        if(!any) stats.deadlocks++;
+        progress.states.store(stored, memory_order_relaxed);
+        progress.frontier.store((int64_t)q.size(), memory_order_relaxed);
+
+        if(--level_left == 0){
+            level->arg("depth", depth);
+            level->arg("new_states", next_level);
+            level.reset();
+            traceCounter("frontier", next_level);
+            traceCounter("states", store.size());
+            if(next_level > 0) level.emplace("BFS level", "bfs");
+            depth++; level_left = next_level; next_level = 0;
+            progress.depth.store((int64_t)depth, memory_order_relaxed);
+        }
     }
-    return visited;
+    stats.states = store.size();
+    stats.omission_probability = store.omission_probability();
+    return stats;
 }
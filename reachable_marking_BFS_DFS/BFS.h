@@ -2,10 +2,14 @@
 #define BFS_H
 
 #include "PetriNet.h"
+#include "StateStore.h"
 #include <set>
 
 using MarkingSet = std::set<Marking>;
 
 MarkingSet bfs_reachable(const PetriNet& pn);
 
+// Same exploration with any visited-state store (exact, hash compaction, bitstate)
+ExplorationStats bfs_reachable(const PetriNet& pn, StateStore& store);
+
 #endif // BFS_H
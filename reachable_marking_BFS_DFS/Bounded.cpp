@@ -0,0 +1,179 @@
+#include "Bounded.h"
+#include "CompiledNet.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+using namespace std;
+
+// --- SWAR on b-bit fields; H holds the top bit of every field ---
+
+// field-wise x - y, no borrow across fields
+static inline uint64_t swar_sub(uint64_t x, uint64_t y, uint64_t H) {
+    return ((x | H) - (y & ~H)) ^ ((x ^ ~y) & H);
+}
+
+// top bit of every field where x < y
+static inline uint64_t swar_borrow(uint64_t x, uint64_t y, uint64_t diff, uint64_t H) {
+    return ((~x & y) | (~(x ^ y) & diff)) & H;
+}
+
+// field-wise x + y, no carry across fields
+static inline uint64_t swar_add(uint64_t x, uint64_t y, uint64_t H) {
+    return ((x & ~H) + (y & ~H)) ^ ((x ^ y) & H);
+}
+
+// top bit of every field where x + y wrapped
+static inline uint64_t swar_carry(uint64_t x, uint64_t y, uint64_t sum, uint64_t H) {
+    return ((x & y) | ((x | y) & ~sum)) & H;
+}
+
+// One transition on the words it touches
+struct PackedTransition {
+    vector<uint32_t> words;     // word indices with an input or output
+    vector<uint64_t> in, out;   // packed weights on those words
+};
+
+static uint64_t hash_words(const uint64_t* w, uint32_t n) {
+    uint64_t h = 0x9e3779b97f4a7c15ull;
+    for(uint32_t i = 0; i < n; ++i){
+        h ^= w[i];
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27; h *= 0x94d049bb133111ebull;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+BoundedStats bounded_reachable(const PetriNet& pn, int k, const function<void(const Marking&)>& on_state) {
+    if(k < 1) throw invalid_argument("bounded_reachable: k must be at least 1");
+    CompiledNet net = compile_net(pn);
+
+    // --- STEP 1: Field width and packed transitions ---
+    // output weight = input weight + delta
+    vector<Marking> post(net.n_trans, Marking(net.n_places, 0));
+    int widest = k;
+    for(int t = 0; t < net.n_trans; ++t){
+        for(const auto& a : net.input[t]){ post[t][a.first] += a.second; widest = max(widest, a.second); }
+        for(const auto& d : net.delta[t]) post[t][d.first] += d.second;
+        for(int v : post[t]) widest = max(widest, v);
+    }
+    if(widest > 255) throw invalid_argument("bounded_reachable: bound or arc weight above 255");
+    for(int v : pn.M0) if(v > k) throw invalid_argument("bounded_reachable: M0 exceeds the bound");
+
+    uint32_t bits = 2;
+    while((1 << bits) - 1 < widest) bits *= 2;
+    MarkingPacker packer = make_packer(net.n_places, (1 << bits) - 1);
+    const uint32_t W = packer.words;
+
+    uint64_t H = 0, K = 0;
+    for(uint32_t f = 0; f < packer.per_word; ++f){
+        H |= uint64_t(1) << (f * bits + bits - 1);
+        K |= uint64_t(k) << (f * bits);
+    }
+
+    vector<PackedTransition> trans(net.n_trans);
+    for(int t = 0; t < net.n_trans; ++t){
+        vector<uint64_t> in(W, 0), out(W, 0);
+        vector<bool> touched(W, false);
+        for(const auto& a : net.input[t]){
+            in[a.first / packer.per_word] |= uint64_t(a.second) << ((a.first % packer.per_word) * bits);
+            touched[a.first / packer.per_word] = true;
+        }
+        for(int p = 0; p < net.n_places; ++p){
+            if(post[t][p] == 0) continue;
+            out[p / packer.per_word] |= uint64_t(post[t][p]) << ((p % packer.per_word) * bits);
+            touched[p / packer.per_word] = true;
+        }
+        for(uint32_t w = 0; w < W; ++w){
+            if(!touched[w]) continue;
+            trans[t].words.push_back(w);
+            trans[t].in.push_back(in[w]);
+            trans[t].out.push_back(out[w]);
+        }
+    }
+
+    // --- STEP 2: Packed state array + open addressing index ---
+    BoundedStats stats;
+    stats.bits_per_place = bits;
+    vector<uint64_t> states;             // W words per state, discovery order = BFS queue
+    vector<uint32_t> index(1024, UINT32_MAX);
+    uint64_t n_states = 0;
+    vector<bool> overflowed(net.n_places, false);
+
+    auto lookup_or_add = [&](const uint64_t* w){
+        uint64_t mask = index.size() - 1;
+        for(uint64_t i = hash_words(w, W) & mask;; i = (i + 1) & mask){
+            uint32_t id = index[i];
+            if(id == UINT32_MAX) break;
+            if(memcmp(&states[(size_t)id * W], w, W * 8) == 0) return false;
+        }
+        if(n_states >= UINT32_MAX - 1) throw runtime_error("bounded_reachable: more than 2^32 states");
+        states.insert(states.end(), w, w + W);
+        n_states++;
+        if(n_states * 2 > index.size()){
+            // grow and rehash (the new state is inserted by the rehash)
+            vector<uint32_t> bigger(index.size() * 2, UINT32_MAX);
+            uint64_t m = bigger.size() - 1;
+            for(uint64_t id = 0; id < n_states; ++id){
+                uint64_t i = hash_words(&states[id * W], W) & m;
+                while(bigger[i] != UINT32_MAX) i = (i + 1) & m;
+                bigger[i] = (uint32_t)id;
+            }
+            index.swap(bigger);
+        }
+        else {
+            uint64_t i = hash_words(w, W) & mask;
+            while(index[i] != UINT32_MAX) i = (i + 1) & mask;
+            index[i] = (uint32_t)(n_states - 1);
+        }
+        return true;
+    };
+
+    vector<uint64_t> cur(W), next(W);
+    pack_marking(packer, pn.M0, cur.data());
+    lookup_or_add(cur.data());
+
+    // --- STEP 3: BFS over the state array ---
+    for(uint64_t s = 0; s < n_states; ++s){
+        memcpy(cur.data(), &states[s * W], W * 8);
+        if(on_state) on_state(unpack_marking(packer, cur.data()));
+
+        bool any = false;
+        for(int t = 0; t < net.n_trans; ++t){
+            const PackedTransition& tr = trans[t];
+            bool enabled = true;
+            for(size_t i = 0; i < tr.words.size() && enabled; ++i){
+                uint64_t x = cur[tr.words[i]];
+                uint64_t d = swar_sub(x, tr.in[i], H);
+                enabled = swar_borrow(x, tr.in[i], d, H) == 0;
+            }
+            if(!enabled) continue;
+            any = true;
+
+            next = cur;
+            uint64_t overflow_any = 0;
+            for(size_t i = 0; i < tr.words.size(); ++i){
+                uint32_t w = tr.words[i];
+                uint64_t x = swar_sub(cur[w], tr.in[i], H);
+                uint64_t y = swar_add(x, tr.out[i], H);
+                uint64_t over = swar_carry(x, tr.out[i], y, H) | swar_borrow(K, y, swar_sub(K, y, H), H);
+                if(over){
+                    overflow_any = 1;
+                    for(uint32_t f = 0; f < packer.per_word; ++f){
+                        if(over >> (f * bits + bits - 1) & 1) overflowed[w * packer.per_word + f] = true;
+                    }
+                }
+                next[w] = y;
+            }
+            if(overflow_any){ stats.overflow_firings++; continue; }
+            stats.edges++;
+            lookup_or_add(next.data());
+        }
+        if(!any) stats.deadlocks++;
+    }
+
+    stats.states = n_states;
+    stats.memory_bytes = states.capacity() * 8 + index.size() * 4;
+    for(int p = 0; p < net.n_places; ++p) if(overflowed[p]) stats.overflow_places.push_back(p);
+    return stats;
+}
@@ -0,0 +1,34 @@
+#ifndef BOUNDED_H
+#define BOUNDED_H
+
+#include "PetriNet.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct BoundedStats {
+    uint64_t states = 0;
+    uint64_t edges = 0;
+    uint64_t deadlocks = 0;            // states where no transition has enough tokens
+    uint32_t bits_per_place = 0;       // 2, 4 or 8
+    size_t memory_bytes = 0;           // packed states + hash index
+
+    // Firings that would put more than k tokens on a place. They are counted
+    // here instead of being dropped silently; their targets are not stored.
+    uint64_t overflow_firings = 0;
+    std::vector<int> overflow_places;  // sorted, places that went above k
+    bool within_bound() const { return overflow_firings == 0; }
+};
+
+// BFS for k-bounded nets. Each place is a 2-, 4- or 8-bit counter (the
+// smallest width holding k and every arc weight) packed into 64-bit words,
+// and enabling and firing work on whole words at once (SWAR): borrows of a
+// field-wise subtraction tell a missing token, carries and a compare against
+// k tell an overflow. States live in one packed array indexed by an open
+// addressing table. on_state sees every stored marking.
+// Throws invalid_argument if k or a weight does not fit 8 bits, or M0 exceeds k.
+BoundedStats bounded_reachable(const PetriNet& pn, int k,
+                               const std::function<void(const Marking&)>& on_state = nullptr);
+
+#endif // BOUNDED_H
@@ -0,0 +1,258 @@
+#include "Checkpoint.h"
+#include "CompiledNet.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+using namespace std;
+
+// --- Checkpoint record ---
+struct CheckpointRecord {
+    char magic[8];       // "PNEXCK01"
+    uint64_t net_hash;   // structure and M0 of the net
+    uint32_t n_places;
+    uint32_t n_trans;
+    uint32_t bits_per_place;
+    uint32_t words_per_state;
+    uint64_t n_states;   // valid records in the .states file
+    uint64_t next;       // first state not expanded yet
+    uint64_t edges;
+    uint64_t deadlocks;
+    uint64_t complete;
+};
+
+static const char CHECKPOINT_MAGIC[8] = {'P','N','E','X','C','K','0','1'};
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t hash_net(const CompiledNet& net, const Marking& M0) {
+    uint64_t h = mix64(net.n_places * 1000003ull + net.n_trans);
+    for(int t = 0; t < net.n_trans; ++t){
+        for(const auto& a : net.input[t]) h = mix64(h ^ ((uint64_t)t << 40 ^ (uint64_t)a.first << 8 ^ (uint64_t)a.second));
+        for(const auto& d : net.delta[t]) h = mix64(h ^ ((uint64_t)t << 40 ^ (uint64_t)d.first << 8 ^ (uint64_t)(d.second + 128)) ^ 1);
+    }
+    for(int v : M0) h = mix64(h ^ (uint64_t)v);
+    return h;
+}
+
+static void sync_file(FILE* f) {
+    fflush(f);
+#ifndef _WIN32
+    fsync(fileno(f));
+#endif
+}
+
+// --- Background writer ---
+// Jobs queued while the writer is busy are merged: their appends are
+// concatenated and only the newest record is kept.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(const string& path) : path(path) {
+        states = fopen((path + ".states").c_str(), "ab");
+        if(!states) throw runtime_error("checkpoint: cannot open " + path + ".states");
+        worker = thread([this]{ run(); });
+    }
+    ~CheckpointWriter() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        cv.notify_one();
+        worker.join();
+        fclose(states);
+    }
+
+    void submit(vector<uint64_t>&& words, const CheckpointRecord& rec) {
+        {
+            lock_guard<mutex> lock(m);
+            if(failed) throw runtime_error("checkpoint: " + error);
+            pending_words.insert(pending_words.end(), words.begin(), words.end());
+            pending_rec = rec;
+            has_job = true;
+        }
+        cv.notify_one();
+    }
+
+    // Waits until everything submitted is on disk
+    void drain() {
+        unique_lock<mutex> lock(m);
+        idle_cv.wait(lock, [this]{ return !has_job && !busy; });
+        if(failed) throw runtime_error("checkpoint: " + error);
+    }
+
+private:
+    void run() {
+        unique_lock<mutex> lock(m);
+        while(true){
+            cv.wait(lock, [this]{ return has_job || stopping; });
+            if(!has_job) break;
+            vector<uint64_t> words;
+            words.swap(pending_words);
+            CheckpointRecord rec = pending_rec;
+            has_job = false;
+            busy = true;
+            lock.unlock();
+
+            string err = write(words, rec);
+
+            lock.lock();
+            busy = false;
+            if(!err.empty() && !failed){ failed = true; error = err; }
+            idle_cv.notify_all();
+        }
+    }
+
+    string write(const vector<uint64_t>& words, const CheckpointRecord& rec) {
+        // states first, so a record never points past the data
+        if(!words.empty() && fwrite(words.data(), 8, words.size(), states) != words.size()) return "cannot write " + path + ".states";
+        sync_file(states);
+
+        string tmp = path + ".ckpt.tmp";
+        FILE* f = fopen(tmp.c_str(), "wb");
+        if(!f) return "cannot create " + tmp;
+        bool ok = fwrite(&rec, sizeof(rec), 1, f) == 1;
+        sync_file(f);
+        ok = fclose(f) == 0 && ok;
+        if(!ok) return "cannot write " + tmp;
+        error_code ec;
+        filesystem::rename(tmp, path + ".ckpt", ec);
+        return ec ? "cannot rename " + tmp : "";
+    }
+
+    string path;
+    FILE* states = nullptr;
+    thread worker;
+    mutex m;
+    condition_variable cv, idle_cv;
+    vector<uint64_t> pending_words;
+    CheckpointRecord pending_rec;
+    bool has_job = false, busy = false, stopping = false, failed = false;
+    string error;
+};
+
+// --- Exploration ---
+
+CheckpointedStats bfs_checkpointed(const PetriNet& pn, const CheckpointOptions& opt) {
+    CompiledNet net = compile_net(pn);
+    int max_tokens = net.bound;
+    for(int v : pn.M0) max_tokens = max(max_tokens, v);
+    MarkingPacker packer = make_packer(net.n_places, max_tokens);
+    const uint32_t W = packer.words;
+    const uint64_t net_hash = hash_net(net, pn.M0);
+
+    CheckpointedStats stats;
+    vector<uint64_t> words; // state s is words[s*W .. s*W+W)
+    auto hasher = [&](uint32_t id){
+        uint64_t h = 0;
+        for(uint32_t w = 0; w < W; ++w) h = mix64(h ^ words[size_t(id) * W + w]);
+        return (size_t)h;
+    };
+    auto equal = [&](uint32_t a, uint32_t b){
+        return memcmp(&words[size_t(a) * W], &words[size_t(b) * W], W * 8) == 0;
+    };
+    unordered_set<uint32_t, decltype(hasher), decltype(equal)> index(1024, hasher, equal);
+    uint64_t next = 0;
+
+    // --- STEP 1: Resume, or start from M0 ---
+    CheckpointRecord rec;
+    FILE* f = opt.resume ? fopen((opt.path + ".ckpt").c_str(), "rb") : nullptr;
+    if(f){
+        bool ok = fread(&rec, sizeof(rec), 1, f) == 1;
+        fclose(f);
+        if(!ok || memcmp(rec.magic, CHECKPOINT_MAGIC, 8) != 0) throw runtime_error("checkpoint: bad record " + opt.path + ".ckpt");
+        if(rec.net_hash != net_hash || rec.words_per_state != W || rec.bits_per_place != packer.bits){
+            throw runtime_error("checkpoint: " + opt.path + " was written for another net");
+        }
+        // drop states appended after the record was written
+        filesystem::resize_file(opt.path + ".states", rec.n_states * W * 8);
+        words.resize(rec.n_states * W);
+        FILE* s = fopen((opt.path + ".states").c_str(), "rb");
+        if(!s || fread(words.data(), 8, words.size(), s) != words.size()){
+            if(s) fclose(s);
+            throw runtime_error("checkpoint: cannot read " + opt.path + ".states");
+        }
+        fclose(s);
+        for(uint32_t id = 0; id < rec.n_states; ++id) index.insert(id);
+        next = rec.next;
+        stats.edges = rec.edges;
+        stats.deadlocks = rec.deadlocks;
+        stats.resumed = true;
+    }
+    else {
+        remove((opt.path + ".states").c_str());
+        remove((opt.path + ".ckpt").c_str());
+        words.resize(W);
+        pack_marking(packer, pn.M0, words.data());
+        index.insert(0);
+    }
+
+    CheckpointWriter writer(opt.path);
+    uint64_t saved_states = stats.resumed ? words.size() / W : 0;
+    auto checkpoint = [&](bool complete){
+        memcpy(rec.magic, CHECKPOINT_MAGIC, 8);
+        rec.net_hash = net_hash;
+        rec.n_places = net.n_places;
+        rec.n_trans = net.n_trans;
+        rec.bits_per_place = packer.bits;
+        rec.words_per_state = W;
+        rec.n_states = words.size() / W;
+        rec.next = next;
+        rec.edges = stats.edges;
+        rec.deadlocks = stats.deadlocks;
+        rec.complete = complete;
+        vector<uint64_t> fresh(words.begin() + saved_states * W, words.end());
+        saved_states = rec.n_states;
+        writer.submit(move(fresh), rec);
+        stats.checkpoints++;
+    };
+
+    // --- STEP 2: BFS over the discovery-ordered array ---
+    bool safe_start = within_bound(net, pn.M0); // nothing fires from an unsafe M0
+    auto last = chrono::steady_clock::now();
+    uint64_t run_expansions = 0;
+    vector<uint64_t> packed(W);
+    while(next < words.size() / W){
+        if(opt.max_expansions && run_expansions == opt.max_expansions) break;
+        Marking M = unpack_marking(packer, &words[next * W]);
+        bool any = false;
+        for(int j = 0; safe_start && j < net.n_trans; ++j){
+            if(!is_enabled(net, M, j)) continue;
+            any = true;
+            stats.edges++;
+            pack_marking(packer, fire(net, M, j), packed.data());
+            words.insert(words.end(), packed.begin(), packed.end());
+            if(!index.insert(words.size() / W - 1).second) words.resize(words.size() - W);
+        }
+        if(!any) stats.deadlocks++;
+        next++;
+        run_expansions++;
+
+        if((run_expansions & 1023) == 0 || opt.interval_seconds <= 0){
+            auto now = chrono::steady_clock::now();
+            if(chrono::duration<double>(now - last).count() >= opt.interval_seconds){
+                checkpoint(false);
+                last = now;
+            }
+        }
+    }
+
+    stats.complete = next == words.size() / W;
+    checkpoint(stats.complete);
+    writer.drain();
+    stats.states = words.size() / W;
+    stats.expanded = next;
+    return stats;
+}
@@ -0,0 +1,34 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "PetriNet.h"
+#include <cstdint>
+#include <string>
+
+struct CheckpointOptions {
+    std::string path;              // writes <path>.states (packed markings) and <path>.ckpt
+    double interval_seconds = 60;  // time between checkpoints (0 = after every expansion batch)
+    bool resume = false;           // continue from <path>.ckpt if it exists
+    uint64_t max_expansions = 0;   // stop (with a checkpoint) after this many, 0 = no limit
+};
+
+struct CheckpointedStats {
+    uint64_t states = 0;
+    uint64_t expanded = 0;     // states whose successors are known
+    uint64_t edges = 0;
+    uint64_t deadlocks = 0;
+    uint64_t checkpoints = 0;  // written by this run
+    bool resumed = false;
+    bool complete = false;     // false if stopped by max_expansions
+};
+
+// BFS (1-safe, like bfs_reachable) whose state store and frontier can be
+// saved and restored. States are numbered in discovery order, so the store
+// is an append-only array and the frontier is the suffix not yet expanded:
+// a checkpoint appends the states found since the previous one and then
+// replaces the small .ckpt record (write + rename). Writes happen on a
+// background thread; exploration only copies the new packed states.
+// Throws runtime_error on I/O errors or when the checkpoint belongs to another net.
+CheckpointedStats bfs_checkpointed(const PetriNet& pn, const CheckpointOptions& opt);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,85 @@
+#include "CompiledNet.h"
+#include <stdexcept>
+using namespace std;
+
+CompiledNet compile_net(const PetriNet& pn) {
+    CompiledNet net;
+    net.n_places = (int)pn.M0.size();
+
+    int I_rows = (int)pn.I.size();
+    int I_cols = I_rows>0 ? (int)pn.I[0].size() : 0;
+    int O_rows = (int)pn.O.size();
+    int O_cols = O_rows>0 ? (int)pn.O[0].size() : 0;
+
+    // same orientation rule as _infer_IO: rows are places if they can be
+    bool place_rows;
+    if(I_rows == net.n_places && O_rows == net.n_places){
+        if(I_cols != O_cols) throw invalid_argument("I and O have incompatible trans dimension");
+        place_rows = true;
+        net.n_trans = I_cols;
+    }
+    else if(I_cols == net.n_places && O_cols == net.n_places){
+        place_rows = false;
+        net.n_trans = I_rows;
+    }
+    else throw invalid_argument("Cannot infer I/O matrix orientation");
+
+    net.input.assign(net.n_trans, {});
+    net.delta.assign(net.n_trans, {});
+    for(int j=0;j<net.n_trans;++j){
+        for(int i=0;i<net.n_places;++i){
+            int in  = place_rows ? pn.I[i][j] : pn.I[j][i];
+            int out = place_rows ? pn.O[i][j] : pn.O[j][i];
+            if(in > 0) net.input[j].push_back({i, in});
+            if(out != in) net.delta[j].push_back({i, out - in});
+        }
+    }
+    return net;
+}
+
+bool within_bound(const CompiledNet& net, const Marking& M) {
+    for(int v : M) if(v > net.bound) return false;
+    return true;
+}
+
+bool is_enabled(const CompiledNet& net, const Marking& M, int t) {
+    for(const auto& a : net.input[t]){
+        if(M[a.first] < a.second) return false;
+    }
+    for(const auto& d : net.delta[t]){
+        if(M[d.first] + d.second > net.bound) return false; // 1-safe constraint
+    }
+    return true;
+}
+
+Marking fire(const CompiledNet& net, const Marking& M, int t) {
+    Marking Mnew = M;
+    for(const auto& d : net.delta[t]) Mnew[d.first] += d.second;
+    return Mnew;
+}
+
+MarkingPacker make_packer(int n_places, int max_tokens) {
+    MarkingPacker p;
+    p.n_places = n_places;
+    while(p.bits < 32 && (uint64_t(max_tokens) >> p.bits) != 0) p.bits *= 2;
+    p.per_word = 64 / p.bits;
+    p.words = (n_places + p.per_word - 1) / p.per_word;
+    if(p.words == 0) p.words = 1; // keep records non-empty for nets without places
+    return p;
+}
+
+void pack_marking(const MarkingPacker& p, const Marking& M, uint64_t* out) {
+    for(uint32_t w = 0; w < p.words; ++w) out[w] = 0;
+    for(int i = 0; i < p.n_places; ++i){
+        out[i / p.per_word] |= uint64_t(M[i]) << ((i % p.per_word) * p.bits);
+    }
+}
+
+Marking unpack_marking(const MarkingPacker& p, const uint64_t* in) {
+    uint64_t mask = (uint64_t(1) << p.bits) - 1; // bits <= 32
+    Marking M(p.n_places);
+    for(int i = 0; i < p.n_places; ++i){
+        M[i] = (int)((in[i / p.per_word] >> ((i % p.per_word) * p.bits)) & mask);
+    }
+    return M;
+}
@@ -0,0 +1,45 @@
+#ifndef COMPILED_NET_H
+#define COMPILED_NET_H
+
+#include "PetriNet.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Sparse per-transition view of a PetriNet for the exploration engines.
+// The dense I/O matrices are read once; enabling and firing then only touch
+// the places a transition is connected to.
+struct CompiledNet {
+    int n_places = 0;
+    int n_trans = 0;
+    std::vector<std::vector<std::pair<int,int>>> input; // [t] -> (place, tokens needed)
+    std::vector<std::vector<std::pair<int,int>>> delta; // [t] -> (place, token change), non-zero only
+    int bound = 1;                                      // max tokens per place (1-safe)
+};
+
+// Accepts I/O as places x transitions or transitions x places (like bfs_reachable)
+CompiledNet compile_net(const PetriNet& pn);
+
+// Every place holds at most 'bound' tokens
+bool within_bound(const CompiledNet& net, const Marking& M);
+
+// Enough tokens on the inputs and no place goes above the bound
+bool is_enabled(const CompiledNet& net, const Marking& M, int t);
+
+Marking fire(const CompiledNet& net, const Marking& M, int t);
+
+// Fixed-width packing of markings into 64-bit words, for engines that keep
+// states outside of std::vector (files, hash tables). Places get the fewest
+// power-of-two bits able to hold max_tokens.
+struct MarkingPacker {
+    int n_places = 0;
+    uint32_t bits = 1;     // 1, 2, 4, 8, 16 or 32
+    uint32_t per_word = 64;
+    uint32_t words = 0;    // words per packed marking
+};
+
+MarkingPacker make_packer(int n_places, int max_tokens);
+void pack_marking(const MarkingPacker& p, const Marking& M, uint64_t* out);
+Marking unpack_marking(const MarkingPacker& p, const uint64_t* in);
+
+#endif // COMPILED_NET_H
@@ -0,0 +1,130 @@
+#include "Coverability.h"
+#include "CompiledNet.h"
+#include <algorithm>
+#include <deque>
+using namespace std;
+
+// a <= b place-wise (OMEGA is above every number)
+static bool covered_by(const Marking& a, const Marking& b) {
+    for(size_t p = 0; p < a.size(); ++p) if(a[p] > b[p]) return false;
+    return true;
+}
+
+struct CoverNode {
+    Marking M;
+    int parent = -1;
+    vector<int> children;
+    bool active = true;
+    bool processed = false;
+};
+
+CoverabilityResult minimal_coverability_set(const PetriNet& pn) {
+    CompiledNet net = compile_net(pn);
+    CoverabilityResult r;
+
+    vector<CoverNode> tree;
+    vector<int> act;        // active node ids; compacted lazily
+    deque<int> wait;
+
+    auto add_node = [&](Marking M, int parent){
+        tree.push_back(CoverNode());
+        tree.back().M = move(M);
+        tree.back().parent = parent;
+        int id = (int)tree.size() - 1;
+        if(parent >= 0) tree[parent].children.push_back(id);
+        act.push_back(id);
+        wait.push_back(id);
+        r.nodes++;
+        return id;
+    };
+
+    // deactivate the subtree of n (n included when with_root)
+    vector<int> stack;
+    auto deactivate = [&](int n, bool with_root){
+        stack.assign(1, n);
+        while(!stack.empty()){
+            int x = stack.back(); stack.pop_back();
+            if(x != n || with_root){
+                if(tree[x].active) r.pruned++;
+                tree[x].active = false;
+            }
+            for(int c : tree[x].children) stack.push_back(c);
+            if(x != n || with_root) tree[x].children.clear();
+        }
+        tree[n].children.clear();
+    };
+    auto compact = [&](){
+        act.erase(remove_if(act.begin(), act.end(), [&](int x){ return !tree[x].active; }), act.end());
+    };
+
+    add_node(pn.M0, -1);
+
+    while(!wait.empty()){
+        int n = wait.front(); wait.pop_front();
+        if(!tree[n].active || tree[n].processed) continue;
+        const Marking& M = tree[n].M;
+
+        // --- STEP 1: Covered by another active node -> drop ---
+        bool covered = false;
+        for(int x : act){
+            if(x != n && tree[x].active && covered_by(M, tree[x].M)){ covered = true; break; }
+        }
+        if(covered){
+            deactivate(n, true);
+            compact();
+            continue;
+        }
+
+        // --- STEP 2: Strictly above an ancestor -> accelerate into the oldest one ---
+        Marking acc = M;
+        int target = -1;
+        for(int a = tree[n].parent; a >= 0; a = tree[a].parent){
+            const Marking& A = tree[a].M;
+            if(A != M && covered_by(A, M)){
+                target = a;
+                for(size_t p = 0; p < M.size(); ++p) if(A[p] < M[p]) acc[p] = OMEGA;
+            }
+        }
+        if(target >= 0){
+            r.accelerations++;
+            deactivate(target, false);
+            tree[target].M = move(acc);
+            tree[target].processed = false;
+            wait.push_back(target);
+            compact();
+            continue;
+        }
+
+        // --- STEP 3: Remove active nodes strictly below, then expand ---
+        for(int x : act){
+            if(x != n && tree[x].active && tree[x].M != M && covered_by(tree[x].M, M)) deactivate(x, true);
+        }
+        compact();
+        tree[n].processed = true;
+        for(int t = 0; t < net.n_trans; ++t){
+            bool enabled = true;
+            for(const auto& a : net.input[t]) if(tree[n].M[a.first] < a.second){ enabled = false; break; }
+            if(!enabled) continue;
+            Marking next = tree[n].M;
+            for(const auto& d : net.delta[t]) if(next[d.first] != OMEGA) next[d.first] += d.second;
+            add_node(move(next), n);
+        }
+    }
+
+    // --- STEP 4: Collect the antichain ---
+    r.place_bounds.assign(net.n_places, 0);
+    for(int x : act){
+        if(!tree[x].active) continue;
+        r.basis.push_back(tree[x].M);
+        for(int p = 0; p < net.n_places; ++p) r.place_bounds[p] = max(r.place_bounds[p], tree[x].M[p]);
+    }
+    sort(r.basis.begin(), r.basis.end());
+    for(int p = 0; p < net.n_places; ++p) if(r.place_bounds[p] == OMEGA) r.unbounded_places.push_back(p);
+    r.bounded = r.unbounded_places.empty();
+    return r;
+}
+
+bool is_coverable(const CoverabilityResult& r, const Marking& M) {
+    for(const auto& B : r.basis) if(covered_by(M, B)) return true;
+    return false;
+}
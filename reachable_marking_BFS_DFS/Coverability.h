@@ -0,0 +1,37 @@
+#ifndef COVERABILITY_H
+#define COVERABILITY_H
+
+#include "PetriNet.h"
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// Token count standing for "arbitrarily many" in an omega-marking
+const int OMEGA = INT_MAX;
+
+struct CoverabilityResult {
+    // Minimal coverability set: an antichain of omega-markings such that a
+    // marking is coverable iff it is below one of them
+    std::vector<Marking> basis;
+    std::vector<int> unbounded_places;  // sorted
+    std::vector<int> place_bounds;      // [place] largest count over the basis, OMEGA if unbounded
+    bool bounded = true;
+
+    uint64_t nodes = 0;                 // tree nodes created
+    uint64_t accelerations = 0;
+    uint64_t pruned = 0;                // nodes deactivated by covering
+};
+
+// Karp-Miller tree with pruning (Reynier & Servais' MP algorithm): a node
+// covered by an active node is dropped, a node strictly covering an active
+// one removes that node's whole subtree, and a node strictly above one of
+// its ancestors accelerates (omega on the growing places) and replaces that
+// ancestor, whose subtree is discarded. The active nodes at the end are the
+// minimal coverability set. No token bound is applied here: arc weights and
+// the plain firing rule only.
+CoverabilityResult minimal_coverability_set(const PetriNet& pn);
+
+// M <= some element of the basis
+bool is_coverable(const CoverabilityResult& r, const Marking& M);
+
+#endif // COVERABILITY_H
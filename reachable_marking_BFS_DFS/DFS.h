@@ -2,10 +2,14 @@
 #define DFS_H
 
 #include "PetriNet.h"
+#include "StateStore.h"
 #include <set>
 
 using MarkingSet = std::set<Marking>;
 
 MarkingSet dfs_reachable(const PetriNet& pn);
 
+// Same exploration with any visited-state store (exact, hash compaction, bitstate)
+ExplorationStats dfs_reachable(const PetriNet& pn, StateStore& store);
+
 #endif // DFS_H
@@ -0,0 +1,447 @@
+#include "Distributed.h"
+#include "CompiledNet.h"
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+#ifdef _WIN32
+
+DistributedStats distributed_reachable(const PetriNet&, const DistributedOptions&) {
+    throw runtime_error("distributed mode needs POSIX sockets and fork");
+}
+
+DistributedStats run_distributed_worker(const PetriNet&, int, const vector<pair<string,int>>&, const DistributedOptions&) {
+    throw runtime_error("distributed mode needs POSIX sockets");
+}
+
+#else
+
+// --- Wire format ---
+// Every message is a 16-byte header followed by 'bytes' of payload.
+enum MessageType : uint32_t {
+    MSG_HELLO = 1,     // count = sender rank
+    MSG_STATES,        // count packed markings
+    MSG_PROBE,         // count = wave number
+    MSG_REPLY,         // count = wave number, payload: idle, sent, received
+    MSG_TERMINATE,
+    MSG_STATS          // payload: states, edges, deadlocks, batches, bytes
+};
+
+struct FrameHeader {
+    uint32_t type;
+    uint32_t count;
+    uint64_t bytes;
+};
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static void append_frame(string& out, uint32_t type, uint32_t count, const void* payload, size_t bytes) {
+    FrameHeader h{type, count, bytes};
+    out.append((const char*)&h, sizeof(h));
+    if(bytes) out.append((const char*)payload, bytes);
+}
+
+static void write_blocking(int fd, const void* data, size_t n) {
+    const char* p = (const char*)data;
+    while(n > 0){
+        ssize_t k = send(fd, p, n, MSG_NOSIGNAL);
+        if(k < 0){
+            if(errno == EINTR) continue;
+            throw runtime_error("distributed: send failed");
+        }
+        p += k;
+        n -= k;
+    }
+}
+
+static void read_blocking(int fd, void* data, size_t n) {
+    char* p = (char*)data;
+    while(n > 0){
+        ssize_t k = recv(fd, p, n, 0);
+        if(k < 0 && errno == EINTR) continue;
+        if(k <= 0) throw runtime_error("distributed: connection closed during setup");
+        p += k;
+        n -= k;
+    }
+}
+
+// Listens on 'host' (resolved like connect_to), or on all interfaces when
+// host is null; port 0 picks a free port, returned in bound_port
+static int listen_on(const char* host, int port, int backlog, int& bound_port) {
+    addrinfo hints{}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    if(getaddrinfo(host, to_string(port).c_str(), &hints, &res) != 0 || !res){
+        throw runtime_error(string("distributed: cannot resolve ") + (host ? host : "the wildcard address"));
+    }
+    int fd = -1;
+    for(addrinfo* a = res; a && fd < 0; a = a->ai_next){
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if(fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if(bind(fd, a->ai_addr, a->ai_addrlen) < 0 || listen(fd, backlog) < 0){
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if(fd < 0) throw runtime_error("distributed: cannot listen on port " + to_string(port));
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    getsockname(fd, (sockaddr*)&addr, &len);
+    bound_port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static int connect_to(const string& host, int port) {
+    addrinfo hints{}, *res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if(getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &res) != 0 || !res){
+        throw runtime_error("distributed: cannot resolve " + host);
+    }
+    // the peer may still be starting: retry for a while
+    for(int attempt = 0; attempt < 200; ++attempt){
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if(fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) == 0){
+            freeaddrinfo(res);
+            return fd;
+        }
+        if(fd >= 0) close(fd);
+        this_thread::sleep_for(chrono::milliseconds(50));
+    }
+    freeaddrinfo(res);
+    throw runtime_error("distributed: cannot connect to " + host + ":" + to_string(port));
+}
+
+// --- One worker ---
+
+struct Peer {
+    int fd = -1;
+    string in;          // received bytes not parsed yet
+    string out;         // bytes not sent yet
+    size_t out_pos = 0;
+};
+
+static DistributedStats run_worker(const PetriNet& pn, int rank, int listen_fd,
+                                   const vector<pair<string,int>>& addrs, const DistributedOptions& opt) {
+    CompiledNet net = compile_net(pn);
+    int max_tokens = net.bound;
+    for(int v : pn.M0) max_tokens = max(max_tokens, v);
+    MarkingPacker packer = make_packer(net.n_places, max_tokens);
+    const size_t state_bytes = packer.words * 8;
+    const int n = (int)addrs.size();
+    bool safe_start = within_bound(net, pn.M0); // nothing fires from an unsafe M0
+
+    // --- STEP 1: Full mesh (connect to lower ranks, accept higher ones) ---
+    vector<Peer> peers(n);
+    for(int j = 0; j < rank; ++j){
+        int fd = connect_to(addrs[j].first, addrs[j].second);
+        FrameHeader h{MSG_HELLO, (uint32_t)rank, 0};
+        write_blocking(fd, &h, sizeof(h));
+        peers[j].fd = fd;
+    }
+    for(int k = rank + 1; k < n; ++k){
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if(fd < 0) throw runtime_error("distributed: accept failed");
+        FrameHeader h;
+        read_blocking(fd, &h, sizeof(h));
+        if(h.type != MSG_HELLO || (int)h.count <= rank || (int)h.count >= n) throw runtime_error("distributed: bad hello");
+        peers[h.count].fd = fd;
+    }
+    close(listen_fd);
+    for(auto& p : peers){
+        if(p.fd < 0) continue;
+        int one = 1;
+        setsockopt(p.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(p.fd, F_SETFL, fcntl(p.fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    // --- STEP 2: Local state ---
+    DistributedStats stats;
+    unordered_set<string> visited;
+    deque<string> queue;
+    vector<string> batch(n);
+    vector<uint32_t> batch_count(n, 0);
+    uint64_t sent = 0, received = 0; // STATES messages
+
+    auto owner = [&](const string& key){
+        uint64_t h = 0;
+        for(size_t w = 0; w < key.size(); w += 8){
+            uint64_t word;
+            memcpy(&word, key.data() + w, 8);
+            h = mix64(h ^ word);
+        }
+        return (int)(h % (uint64_t)n);
+    };
+    auto add_local = [&](const string& key){
+        if(visited.insert(key).second) queue.push_back(key);
+    };
+    auto flush_batch = [&](int j){
+        if(batch_count[j] == 0) return;
+        append_frame(peers[j].out, MSG_STATES, batch_count[j], batch[j].data(), batch[j].size());
+        stats.batches_sent++;
+        stats.bytes_sent += sizeof(FrameHeader) + batch[j].size();
+        sent++;
+        batch[j].clear();
+        batch_count[j] = 0;
+    };
+    auto is_idle = [&](){
+        if(!queue.empty()) return false;
+        for(int j = 0; j < n; ++j){
+            if(batch_count[j] || peers[j].out_pos < peers[j].out.size()) return false;
+        }
+        return true;
+    };
+
+    string key(state_bytes, '\0');
+    pack_marking(packer, pn.M0, (uint64_t*)&key[0]);
+    if(owner(key) == rank) add_local(key);
+
+    // termination waves (rank 0)
+    uint32_t wave = 0;
+    bool wave_active = false, have_previous = false;
+    int replies = 0;
+    bool wave_idle = true;
+    uint64_t wave_sent = 0, wave_received = 0, prev_sent = 0, prev_received = 0;
+    auto last_wave = chrono::steady_clock::now();
+    bool terminated = false;
+    int stats_pending = n - 1;
+    vector<bool> stats_done(n, false);
+    stats.states_per_worker.assign(rank == 0 ? n : 0, 0);
+
+    auto handle = [&](int from, const FrameHeader& h, const char* payload){
+        switch(h.type){
+        case MSG_STATES:
+            for(uint32_t k = 0; k < h.count; ++k) add_local(string(payload + k * state_bytes, state_bytes));
+            received++;
+            break;
+        case MSG_PROBE: {
+            uint64_t r[3] = {is_idle() ? 1u : 0u, sent, received};
+            append_frame(peers[0].out, MSG_REPLY, h.count, r, sizeof(r));
+            break;
+        }
+        case MSG_REPLY: {
+            uint64_t r[3];
+            memcpy(r, payload, sizeof(r));
+            if(h.count != wave) break;
+            wave_idle = wave_idle && r[0];
+            wave_sent += r[1];
+            wave_received += r[2];
+            replies++;
+            break;
+        }
+        case MSG_TERMINATE:
+            terminated = true;
+            break;
+        case MSG_STATS: {
+            uint64_t r[5];
+            memcpy(r, payload, sizeof(r));
+            stats.states += r[0];
+            stats.edges += r[1];
+            stats.deadlocks += r[2];
+            stats.batches_sent += r[3];
+            stats.bytes_sent += r[4];
+            stats.states_per_worker[from] = r[0];
+            stats_done[from] = true;
+            stats_pending--;
+            break;
+        }
+        default:
+            throw runtime_error("distributed: unknown message");
+        }
+    };
+
+    // --- STEP 3: Event loop ---
+    vector<pollfd> fds;
+    vector<int> fd_rank;
+    char buf[1 << 16];
+    bool stats_sent = false;
+    while(true){
+        // expand a slice of the local queue
+        for(int k = 0; k < 256 && !queue.empty() && !terminated; ++k){
+            Marking M = unpack_marking(packer, (const uint64_t*)queue.front().data());
+            queue.pop_front();
+            bool any = false;
+            for(int j = 0; safe_start && j < net.n_trans; ++j){
+                if(!is_enabled(net, M, j)) continue;
+                any = true;
+                stats.edges++;
+                pack_marking(packer, fire(net, M, j), (uint64_t*)&key[0]);
+                int o = owner(key);
+                if(o == rank) add_local(key);
+                else {
+                    batch[o] += key;
+                    if(++batch_count[o] >= opt.batch_states) flush_batch(o);
+                }
+            }
+            if(!any) stats.deadlocks++;
+        }
+        if(queue.empty()) for(int j = 0; j < n; ++j) flush_batch(j);
+
+        // rank 0: start / finish termination waves
+        if(rank == 0 && !terminated){
+            auto now = chrono::steady_clock::now();
+            if(!wave_active && is_idle() && now - last_wave >= chrono::milliseconds(2)){
+                wave++;
+                wave_active = true;
+                replies = 0;
+                wave_idle = true;
+                wave_sent = sent;
+                wave_received = received;
+                last_wave = now;
+                for(int j = 1; j < n; ++j) append_frame(peers[j].out, MSG_PROBE, wave, nullptr, 0);
+            }
+            if(wave_active && replies == n - 1){
+                wave_active = false;
+                bool consistent = wave_idle && wave_sent == wave_received;
+                if(consistent && have_previous && prev_sent == wave_sent && prev_received == wave_received){
+                    terminated = true;
+                    for(int j = 1; j < n; ++j) append_frame(peers[j].out, MSG_TERMINATE, 0, nullptr, 0);
+                }
+                have_previous = consistent;
+                prev_sent = wave_sent;
+                prev_received = wave_received;
+            }
+        }
+        if(terminated && rank != 0 && !stats_sent){
+            uint64_t r[5] = {visited.size(), stats.edges, stats.deadlocks, stats.batches_sent, stats.bytes_sent};
+            append_frame(peers[0].out, MSG_STATS, 0, r, sizeof(r));
+            stats_sent = true;
+        }
+
+        bool pending_out = false;
+        for(const auto& p : peers) if(p.out_pos < p.out.size()) pending_out = true;
+        if(terminated && !pending_out && (rank != 0 || stats_pending == 0)) break;
+
+        // socket I/O
+        fds.clear();
+        fd_rank.clear();
+        for(int j = 0; j < n; ++j){
+            if(peers[j].fd < 0) continue;
+            short ev = POLLIN;
+            if(peers[j].out_pos < peers[j].out.size()) ev |= POLLOUT;
+            fds.push_back({peers[j].fd, ev, 0});
+            fd_rank.push_back(j);
+        }
+        int timeout = queue.empty() ? 1 : 0;
+        if(!fds.empty() && poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR){
+            throw runtime_error("distributed: poll failed");
+        }
+        for(size_t k = 0; k < fds.size(); ++k){
+            Peer& p = peers[fd_rank[k]];
+            if(fds[k].revents & POLLOUT){
+                ssize_t w = send(p.fd, p.out.data() + p.out_pos, p.out.size() - p.out_pos, MSG_NOSIGNAL);
+                if(w > 0) p.out_pos += w;
+                if(p.out_pos == p.out.size()){ p.out.clear(); p.out_pos = 0; }
+            }
+            if(fds[k].revents & (POLLIN | POLLHUP | POLLERR)){
+                ssize_t r = recv(p.fd, buf, sizeof(buf), 0);
+                if(r < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+                if(r <= 0){
+                    // Peers hang up once they are told to terminate; before
+                    // that (or before its stats reached rank 0) it is a crash
+                    bool expected = rank == 0 ? stats_done[fd_rank[k]] : terminated || fd_rank[k] != 0;
+                    if(!expected) throw runtime_error("distributed: peer " + to_string(fd_rank[k]) + " disconnected");
+                    close(p.fd);
+                    p.fd = -1;
+                    continue;
+                }
+                p.in.append(buf, r);
+                size_t pos = 0;
+                while(p.in.size() - pos >= sizeof(FrameHeader)){
+                    FrameHeader h;
+                    memcpy(&h, p.in.data() + pos, sizeof(h));
+                    if(p.in.size() - pos - sizeof(h) < h.bytes) break;
+                    handle(fd_rank[k], h, p.in.data() + pos + sizeof(h));
+                    pos += sizeof(h) + h.bytes;
+                }
+                p.in.erase(0, pos);
+            }
+        }
+    }
+
+    for(auto& p : peers) if(p.fd >= 0) close(p.fd);
+    if(rank == 0){
+        stats.states += visited.size();
+        stats.states_per_worker[0] = visited.size();
+    }
+    else stats.states = visited.size();
+    return stats;
+}
+
+// --- Entry points ---
+
+DistributedStats run_distributed_worker(const PetriNet& pn, int rank, const vector<pair<string,int>>& peers,
+                                        const DistributedOptions& opt) {
+    if(rank < 0 || rank >= (int)peers.size()) throw invalid_argument("distributed: rank out of range");
+    int port;
+    int fd = listen_on(nullptr, peers[rank].second, (int)peers.size(), port);
+    return run_worker(pn, rank, fd, peers, opt);
+}
+
+DistributedStats distributed_reachable(const PetriNet& pn, const DistributedOptions& opt) {
+    int n = max(1, opt.workers);
+
+    // Listening sockets exist before the fork, so every port is known and
+    // every connect succeeds at once
+    vector<int> listeners(n);
+    vector<pair<string,int>> addrs(n);
+    for(int r = 0; r < n; ++r){
+        int port;
+        listeners[r] = listen_on("127.0.0.1", 0, n, port);
+        addrs[r] = {"127.0.0.1", port};
+    }
+
+    vector<pid_t> children;
+    for(int r = 1; r < n; ++r){
+        pid_t pid = fork();
+        if(pid < 0) throw runtime_error("distributed: fork failed");
+        if(pid == 0){
+            for(int k = 0; k < n; ++k) if(k != r) close(listeners[k]);
+            int code = 0;
+            try { run_worker(pn, r, listeners[r], addrs, opt); }
+            catch(...) { code = 1; }
+            _exit(code); // no atexit handlers or stdio flushes in the child
+        }
+        children.push_back(pid);
+    }
+    for(int k = 1; k < n; ++k) close(listeners[k]);
+
+    DistributedStats stats;
+    string error;
+    try { stats = run_worker(pn, 0, listeners[0], addrs, opt); }
+    catch(const exception& e) { error = e.what(); }
+
+    for(pid_t pid : children){
+        int status = 0;
+        if(!error.empty()) kill(pid, SIGTERM);
+        waitpid(pid, &status, 0);
+        if(error.empty() && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) error = "distributed: a worker failed";
+    }
+    if(!error.empty()) throw runtime_error(error);
+    return stats;
+}
+
+#endif
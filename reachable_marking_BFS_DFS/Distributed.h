@@ -0,0 +1,42 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include "PetriNet.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct DistributedOptions {
+    int workers = 4;              // processes for distributed_reachable
+    size_t batch_states = 1024;   // successors buffered per destination before sending
+};
+
+struct DistributedStats {
+    uint64_t states = 0;
+    uint64_t edges = 0;
+    uint64_t deadlocks = 0;
+    uint64_t batches_sent = 0;
+    uint64_t bytes_sent = 0;
+    std::vector<uint64_t> states_per_worker; // filled on rank 0
+};
+
+// Hash-partitioned explicit exploration (1-safe, like bfs_reachable).
+// Worker r owns the markings whose hash is r mod N, stores and expands only
+// those, and sends the other successors to their owner in batches over TCP.
+// Rank 0 detects termination with counting waves: all workers idle and
+// sent == received in two consecutive waves with the same counts.
+
+// Forks workers - 1 processes on this host (localhost sockets); the calling
+// process is rank 0 and returns the totals. POSIX only (throws elsewhere).
+DistributedStats distributed_reachable(const PetriNet& pn, const DistributedOptions& opt = DistributedOptions());
+
+// One worker of a multi-host run. peers[r] = (host, port) of rank r; this
+// process listens on peers[rank].second on all interfaces. Rank 0 returns the
+// totals, other ranks their own counts.
+DistributedStats run_distributed_worker(const PetriNet& pn, int rank,
+                                        const std::vector<std::pair<std::string,int>>& peers,
+                                        const DistributedOptions& opt = DistributedOptions());
+
+#endif // DISTRIBUTED_H
@@ -0,0 +1,315 @@
+#include "ExternalBFS.h"
+#include "CompiledNet.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+// --- Sequential record files ---
+// A file is a flat array of packed markings, 'words' uint64 per record,
+// always sorted and duplicate-free except while a run is being built.
+
+class RecordWriter {
+public:
+    RecordWriter(const string& path, uint32_t words, size_t block_bytes, uint64_t& bytes)
+        : path(path), words(words), bytes(bytes) {
+        f = fopen(path.c_str(), "wb");
+        if(!f) throw runtime_error("external_bfs: cannot create " + path);
+        buf.reserve(max<size_t>(words, block_bytes / 8));
+    }
+    ~RecordWriter() { if(f) fclose(f); }
+
+    void write(const uint64_t* rec) {
+        buf.insert(buf.end(), rec, rec + words);
+        if(buf.size() + words > buf.capacity()) flush();
+        count++;
+    }
+    uint64_t size() const { return count; }
+    void close() {
+        flush();
+        if(fclose(f) != 0){ f = nullptr; throw runtime_error("external_bfs: cannot write " + path); }
+        f = nullptr;
+    }
+
+private:
+    void flush() {
+        if(buf.empty()) return;
+        if(fwrite(buf.data(), 8, buf.size(), f) != buf.size()) throw runtime_error("external_bfs: cannot write " + path);
+        bytes += buf.size() * 8;
+        buf.clear();
+    }
+
+    string path;
+    uint32_t words;
+    uint64_t& bytes;
+    FILE* f = nullptr;
+    vector<uint64_t> buf;
+    uint64_t count = 0;
+};
+
+class RecordReader {
+public:
+    RecordReader(const string& path, uint32_t words, size_t block_bytes, uint64_t& bytes)
+        : path(path), words(words), bytes(bytes) {
+        f = fopen(path.c_str(), "rb");
+        if(!f) throw runtime_error("external_bfs: cannot open " + path);
+        buf.resize(max<size_t>(1, block_bytes / 8 / words) * words);
+        advance();
+    }
+    ~RecordReader() { if(f) fclose(f); }
+
+    bool done() const { return pos >= len; }
+    const uint64_t* current() const { return buf.data() + pos; }
+    void advance() {
+        pos += words;
+        if(pos < len) return;
+        len = fread(buf.data(), 8, buf.size(), f);
+        if(len % words != 0) throw runtime_error("external_bfs: truncated " + path);
+        bytes += len * 8;
+        pos = 0;
+    }
+
+private:
+    string path;
+    uint32_t words;
+    uint64_t& bytes;
+    FILE* f = nullptr;
+    vector<uint64_t> buf;
+    size_t pos = 0;
+    size_t len = 0;
+};
+
+// --- K-way merge of sorted files, duplicates dropped ---
+class MergeStream {
+public:
+    MergeStream(const vector<string>& paths, uint32_t words, size_t block_bytes, uint64_t& bytes)
+        : words(words), heap(Later{this}) {
+        for(const auto& p : paths){
+            readers.emplace_back(new RecordReader(p, words, block_bytes, bytes));
+            if(!readers.back()->done()) heap.push(readers.size() - 1);
+        }
+        if(!heap.empty()) pull();
+    }
+
+    bool done() const { return !has_current; }
+    const uint64_t* current() const { return cur.data(); }
+    void advance() {
+        has_current = false;
+        while(!heap.empty()){
+            const uint64_t* top = readers[heap.top()]->current();
+            if(!equal(top, top + words, cur.begin())){ pull(); return; }
+            step(); // duplicate of the record just consumed
+        }
+    }
+
+private:
+    struct Later {
+        const MergeStream* m;
+        bool operator()(size_t a, size_t b) const {
+            const uint64_t* x = m->readers[a]->current();
+            const uint64_t* y = m->readers[b]->current();
+            return lexicographical_compare(y, y + m->words, x, x + m->words);
+        }
+    };
+
+    void pull() {
+        const uint64_t* top = readers[heap.top()]->current();
+        cur.assign(top, top + words);
+        has_current = true;
+        step();
+    }
+    void step() {
+        size_t r = heap.top();
+        heap.pop();
+        readers[r]->advance();
+        if(!readers[r]->done()) heap.push(r);
+    }
+
+    uint32_t words;
+    vector<unique_ptr<RecordReader>> readers;
+    priority_queue<size_t, vector<size_t>, Later> heap;
+    vector<uint64_t> cur;
+    bool has_current = false;
+};
+
+// Temporary files of one run. Every level, run and visited file is created
+// through here; whatever is still listed when the run unwinds (an I/O error,
+// an exception from on_state) is deleted by the destructor.
+class TempFiles {
+public:
+    TempFiles(const string& dir, const string& prefix) : dir(dir), prefix(prefix) {}
+    ~TempFiles() { for(const auto& p : live) std::remove(p.c_str()); }
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+
+    string create() {
+        live.push_back(dir + "/" + prefix + "_" + to_string(counter++) + ".tmp");
+        return live.back();
+    }
+    // Deletes the file now
+    void remove(const string& path) {
+        std::remove(path.c_str());
+        release(path);
+    }
+    // The file outlives the run (renamed to the output path)
+    void release(const string& path) {
+        auto it = find(live.begin(), live.end(), path);
+        if(it != live.end()) live.erase(it);
+    }
+
+private:
+    string dir, prefix;
+    uint64_t counter = 0;
+    vector<string> live;
+};
+
+static int compare_records(const uint64_t* a, const uint64_t* b, uint32_t words) {
+    for(uint32_t w = 0; w < words; ++w){
+        if(a[w] != b[w]) return a[w] < b[w] ? -1 : 1;
+    }
+    return 0;
+}
+
+ExternalBfsStats external_bfs(const PetriNet& pn, const ExternalBfsOptions& opt,
+                              const function<void(const Marking&)>& on_state) {
+    CompiledNet net = compile_net(pn);
+    int max_tokens = net.bound;
+    for(int v : pn.M0) max_tokens = max(max_tokens, v);
+    MarkingPacker packer = make_packer(net.n_places, max_tokens);
+    const uint32_t W = packer.words;
+    const size_t fan_in = max<size_t>(2, opt.merge_fan_in);
+
+    ExternalBfsStats stats;
+    TempFiles files(opt.work_dir, opt.file_prefix);
+
+    // --- STEP 1: Level 0 ---
+    vector<uint64_t> rec(W);
+    pack_marking(packer, pn.M0, rec.data());
+    string visited_path = files.create(), frontier_path = files.create();
+    for(const string& p : {visited_path, frontier_path}){
+        RecordWriter w(p, W, opt.block_bytes, stats.bytes_written);
+        w.write(rec.data());
+        w.close();
+    }
+    if(on_state) on_state(pn.M0);
+    stats.states = 1;
+    // no transition fires from an unsafe M0, as in bfs_reachable
+    uint64_t frontier_size = within_bound(net, pn.M0) ? 1 : 0;
+    if(frontier_size == 0) stats.levels = 1;
+
+    // successor buffer: packed words plus a sort index per record, allocated
+    // once at full size and flushed before it would have to grow
+    size_t buffer_records = max<size_t>(1, opt.memory_bytes / (W * 8 + 4));
+    vector<uint64_t> buffer;
+    vector<uint32_t> order;
+    buffer.reserve(buffer_records * W);
+    order.reserve(buffer_records);
+
+    while(frontier_size > 0){
+        stats.levels++;
+
+        // --- STEP 2: Expand the frontier into sorted runs ---
+        vector<string> runs;
+        auto flush_run = [&](){
+            size_t n = buffer.size() / W;
+            if(n == 0) return;
+            order.resize(n);
+            for(size_t k = 0; k < n; ++k) order[k] = (uint32_t)k;
+            sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){
+                return compare_records(&buffer[size_t(a) * W], &buffer[size_t(b) * W], W) < 0;
+            });
+            runs.push_back(files.create());
+            RecordWriter w(runs.back(), W, opt.block_bytes, stats.bytes_written);
+            const uint64_t* last = nullptr;
+            for(uint32_t k : order){
+                const uint64_t* r = &buffer[size_t(k) * W];
+                if(last && compare_records(last, r, W) == 0) continue;
+                w.write(r);
+                last = r;
+            }
+            w.close();
+            stats.runs_written++;
+            buffer.clear();
+        };
+
+        {
+            RecordReader in(frontier_path, W, opt.block_bytes, stats.bytes_read);
+            for(; !in.done(); in.advance()){
+                Marking M = unpack_marking(packer, in.current());
+                for(int j = 0; j < net.n_trans; ++j){
+                    if(!is_enabled(net, M, j)) continue;
+                    if(buffer.size() + W > buffer_records * W) flush_run();
+                    buffer.resize(buffer.size() + W);
+                    pack_marking(packer, fire(net, M, j), buffer.data() + buffer.size() - W);
+                }
+            }
+        }
+        flush_run();
+        files.remove(frontier_path);
+
+        // --- STEP 3: Reduce the runs to at most fan_in - 1 files ---
+        // (one input of the final merge is the visited file)
+        while(runs.size() > fan_in - 1){
+            vector<string> next;
+            for(size_t first = 0; first < runs.size(); first += fan_in){
+                vector<string> group(runs.begin() + first, runs.begin() + min(runs.size(), first + fan_in));
+                if(group.size() == 1){ next.push_back(group[0]); continue; }
+                next.push_back(files.create());
+                {
+                    MergeStream m(group, W, opt.block_bytes, stats.bytes_read);
+                    RecordWriter w(next.back(), W, opt.block_bytes, stats.bytes_written);
+                    for(; !m.done(); m.advance()) w.write(m.current());
+                    w.close();
+                }
+                for(const auto& p : group) files.remove(p);
+            }
+            runs.swap(next);
+        }
+
+        // --- STEP 4: Delayed duplicate detection ---
+        // One pass over candidates and visited: new states go to the next
+        // frontier, the union becomes the next visited file.
+        string next_visited = files.create(), next_frontier = files.create();
+        {
+            MergeStream cand(runs, W, opt.block_bytes, stats.bytes_read);
+            RecordReader old(visited_path, W, opt.block_bytes, stats.bytes_read);
+            RecordWriter vis(next_visited, W, opt.block_bytes, stats.bytes_written);
+            RecordWriter fr(next_frontier, W, opt.block_bytes, stats.bytes_written);
+            while(!cand.done() || !old.done()){
+                int c = cand.done() ? 1 : old.done() ? -1 : compare_records(cand.current(), old.current(), W);
+                if(c < 0){
+                    vis.write(cand.current());
+                    fr.write(cand.current());
+                    if(on_state) on_state(unpack_marking(packer, cand.current()));
+                    cand.advance();
+                }
+                else {
+                    vis.write(old.current());
+                    if(c == 0) cand.advance();
+                    old.advance();
+                }
+            }
+            vis.close();
+            fr.close();
+            frontier_size = fr.size();
+        }
+        for(const auto& p : runs) files.remove(p);
+        files.remove(visited_path);
+        visited_path = next_visited;
+        frontier_path = next_frontier;
+        stats.states += frontier_size;
+    }
+
+    files.remove(frontier_path);
+    if(!opt.output_path.empty()){
+        remove(opt.output_path.c_str());
+        if(rename(visited_path.c_str(), opt.output_path.c_str()) != 0){
+            throw runtime_error("external_bfs: cannot move result to " + opt.output_path);
+        }
+        files.release(visited_path);
+    }
+    return stats;
+}
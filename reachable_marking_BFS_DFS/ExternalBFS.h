@@ -0,0 +1,38 @@
+#ifndef EXTERNAL_BFS_H
+#define EXTERNAL_BFS_H
+
+#include "PetriNet.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+struct ExternalBfsOptions {
+    std::string work_dir = ".";          // where the level and run files go
+    std::string file_prefix = "ebfs";    // use different prefixes for concurrent runs
+    size_t memory_bytes = size_t(256) << 20; // successor buffer before a sorted run is flushed
+    size_t block_bytes = size_t(1) << 20;    // size of each sequential read/write
+    size_t merge_fan_in = 64;            // max files merged at once
+    std::string output_path;             // if set, the sorted reachable set is kept there
+};
+
+struct ExternalBfsStats {
+    uint64_t states = 0;
+    uint64_t levels = 0;        // BFS depth + 1
+    uint64_t runs_written = 0;
+    uint64_t bytes_written = 0;
+    uint64_t bytes_read = 0;
+};
+
+// Disk-backed BFS with delayed duplicate detection (1-safe, like bfs_reachable).
+// Each level's successors are buffered, sorted and written as runs; the runs
+// are then merged and subtracted from the sorted visited file in one
+// sequential pass, which also produces the next visited file. RAM use is
+// bounded by memory_bytes plus one block per open file.
+// on_state is called once per reachable marking, in BFS level order.
+// Throws runtime_error if a file cannot be written or read; the temporary
+// files are removed on every exit, including exceptions from on_state.
+ExternalBfsStats external_bfs(const PetriNet& pn, const ExternalBfsOptions& opt = ExternalBfsOptions(),
+                              const std::function<void(const Marking&)>& on_state = nullptr);
+
+#endif // EXTERNAL_BFS_H
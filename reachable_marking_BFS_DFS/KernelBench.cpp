@@ -0,0 +1,141 @@
+#include "KernelBench.h"
+#include "CompiledNet.h"
+#include "StateStore.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <queue>
+using namespace std;
+
+using Clock = chrono::steady_clock;
+
+// Keeps the timed results alive so the loops are not optimised away
+static volatile uint64_t bench_sink;
+
+// Runs setup (untimed) and body (timed) until min_seconds of body time, or
+// ten times that in total when setup dominates. Without setup, short bodies
+// are repeated inside one timed region so the clock reads stay negligible.
+template <class Setup, class Body>
+static KernelTiming measure(const char* name, double min_seconds, uint64_t ops_per_round, bool has_setup,
+                            Setup setup, Body body) {
+    KernelTiming k;
+    k.kernel = name;
+    if(ops_per_round == 0) return k;
+    uint64_t passes = has_setup ? 1 : max<uint64_t>(1, 4096 / ops_per_round);
+    double seconds = 0;
+    Clock::time_point begin = Clock::now();
+    do{
+        setup();
+        Clock::time_point start = Clock::now();
+        for(uint64_t p = 0; p < passes; ++p) bench_sink = bench_sink + body();
+        seconds += chrono::duration<double>(Clock::now() - start).count();
+        k.ops += ops_per_round * passes;
+    } while(seconds < min_seconds && chrono::duration<double>(Clock::now() - begin).count() < 10 * min_seconds);
+    k.ns_per_op = seconds * 1e9 / k.ops;
+    return k;
+}
+
+// Up to 'limit' reachable markings in BFS order, with the firing rule of bfs_reachable
+static vector<Marking> sample_markings(const CompiledNet& net, const Marking& M0, size_t limit) {
+    vector<Marking> sample{M0};
+    MarkingSet seen{M0};
+    if(!within_bound(net, M0)) return sample;
+    for(size_t i = 0; i < sample.size() && sample.size() < limit; ++i){
+        for(int t = 0; t < net.n_trans && sample.size() < limit; ++t){
+            if(!is_enabled(net, sample[i], t)) continue;
+            Marking M = fire(net, sample[i], t);
+            if(seen.insert(M).second) sample.push_back(move(M));
+        }
+    }
+    return sample;
+}
+
+KernelBenchResult benchmark_kernels(const PetriNet& pn, const KernelBenchOptions& opt) {
+    CompiledNet net = compile_net(pn);
+    KernelBenchResult r;
+    r.places = net.n_places;
+    r.transitions = net.n_trans;
+
+    size_t limit = min(opt.sample_states, opt.sample_bytes / (sizeof(int) * max(1, net.n_places)));
+    const vector<Marking> sample = sample_markings(net, pn.M0, max<size_t>(1, limit));
+    const vector<Marking> copies = sample;
+    const uint64_t n = sample.size();
+    r.sample = sample.size();
+
+    vector<pair<uint32_t,int>> enabled; // (sample index, transition)
+    for(uint32_t i = 0; i < n; ++i)
+        for(int t = 0; t < net.n_trans; ++t) if(is_enabled(net, sample[i], t)) enabled.push_back({i, t});
+    r.enabled_pairs = enabled.size();
+
+    auto nothing = []{};
+    const double secs = opt.min_seconds;
+
+    // --- Successor generation ---
+    r.kernels.push_back(measure("enabled", secs, n * net.n_trans, false, nothing, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : sample) for(int t = 0; t < net.n_trans; ++t) c += is_enabled(net, M, t);
+        return c;
+    }));
+    r.kernels.push_back(measure("fire", secs, enabled.size(), false, nothing, [&]{
+        uint64_t c = 0;
+        for(const auto& e : enabled) c += fire(net, sample[e.first], e.second).size();
+        return c;
+    }));
+
+    // --- Hash and equality ---
+    r.kernels.push_back(measure("hash", secs, n, false, nothing, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : sample) c ^= hash_marking(M, 0x9e3779b97f4a7c15ull);
+        return c;
+    }));
+    r.kernels.push_back(measure("equal", secs, n, false, nothing, [&]{
+        uint64_t c = 0;
+        for(uint64_t i = 0; i < n; ++i) c += sample[i] == copies[i];
+        return c;
+    }));
+
+    // --- Visited sets ---
+    ExactStore exact;
+    r.kernels.push_back(measure("exact_insert", secs, n, true, [&]{ exact = ExactStore(); }, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : sample) c += exact.insert(M);
+        return c;
+    }));
+    r.kernels.push_back(measure("exact_lookup", secs, n, false, nothing, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : copies) c += exact.markings().count(M);
+        return c;
+    }));
+
+    HashCompactionStore hashcompact;
+    r.kernels.push_back(measure("hashcompact_insert", secs, n, true, [&]{ hashcompact = HashCompactionStore(); }, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : sample) c += hashcompact.insert(M);
+        return c;
+    }));
+
+    // Room for the first marking plus a few levels of new nodes per further state
+    size_t tree_memory = max<size_t>(size_t(1) << 20, 128 * (r.places + 32 * n));
+    unique_ptr<TreeStore> tree;
+    r.kernels.push_back(measure("tree_insert", secs, n, true, [&]{ tree.reset(new TreeStore(r.places, tree_memory)); }, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : sample) c += tree->insert(M);
+        return c;
+    }));
+
+    // --- Frontier ---
+    queue<Marking> frontier;
+    r.kernels.push_back(measure("push_pop", secs, n, false, nothing, [&]{
+        uint64_t c = 0;
+        for(const Marking& M : sample) frontier.push(M);
+        while(!frontier.empty()){ c += frontier.front().size(); frontier.pop(); }
+        return c;
+    }));
+
+    // --- Memory per state, from the last filled stores ---
+    r.marking_bytes = sizeof(Marking) + r.places * sizeof(int);
+    r.exact_bytes_per_state = (double)exact.memory_bytes() / n;
+    r.hashcompact_bytes_per_state = (double)hashcompact.memory_bytes() / n;
+    r.tree_bytes_per_state = (double)tree->nodes() * sizeof(uint64_t) / n; // used slots, not the table
+    return r;
+}
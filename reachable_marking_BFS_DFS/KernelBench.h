@@ -0,0 +1,49 @@
+#ifndef KERNEL_BENCH_H
+#define KERNEL_BENCH_H
+
+#include "PetriNet.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct KernelBenchOptions {
+    size_t sample_states = 4096;  // reachable markings measured on, in BFS order from M0
+    size_t sample_bytes = size_t(16) << 20; // fewer markings on wide nets: the sample is copied per store
+    double min_seconds = 0.1;     // per kernel: the sample is repeated until this much time is measured
+};
+
+struct KernelTiming {
+    std::string kernel;
+    double ns_per_op = 0.0;
+    uint64_t ops = 0;             // operations timed over all rounds, 0 if there was nothing to time
+};
+
+struct KernelBenchResult {
+    int places = 0;
+    int transitions = 0;
+    size_t sample = 0;                      // markings in the sample
+    uint64_t enabled_pairs = 0;             // (marking, transition) pairs of the sample that are enabled
+    std::vector<KernelTiming> kernels;
+
+    // Memory per state
+    double marking_bytes = 0.0;             // one Marking: vector header and buffer
+    double exact_bytes_per_state = 0.0;     // ExactStore (MarkingSet)
+    double hashcompact_bytes_per_state = 0.0;
+    double tree_bytes_per_state = 0.0;
+};
+
+// Micro-benchmarks of the innermost loops of bfs_reachable on markings of
+// this net. Kernels, one operation each:
+//   enabled         is_enabled for one (marking, transition)
+//   fire            fire of one enabled (marking, transition)
+//   hash            hash_marking of one marking
+//   equal           comparison of a marking with an equal copy (full scan)
+//   exact_insert    insert of a new marking into an ExactStore
+//   exact_lookup    find of a stored marking in the MarkingSet
+//   hashcompact_insert / tree_insert   insert of a new marking
+//   push_pop        one marking through the BFS queue (push, later pop)
+// Store construction is not timed. fire is not timed on nets where nothing is enabled.
+KernelBenchResult benchmark_kernels(const PetriNet& pn, const KernelBenchOptions& opt = KernelBenchOptions());
+
+#endif // KERNEL_BENCH_H
@@ -0,0 +1,111 @@
+#include "Liveness.h"
+#include <algorithm>
+#include <limits>
+using namespace std;
+
+static const uint32_t NONE = numeric_limits<uint32_t>::max();
+
+LivenessResult analyze_liveness(const CsrView& g, int n_trans) {
+    LivenessResult res;
+    uint64_t n = g.n_states;
+
+    // --- STEP 1: Tarjan with an explicit call stack ---
+    // A visited state that has no component yet is still on the Tarjan stack.
+    vector<uint32_t> index(n, NONE), low(n, 0);
+    res.scc_of.assign(n, NONE);
+    vector<uint32_t> stack;
+    struct Frame { uint32_t v; uint64_t next_edge; };
+    vector<Frame> calls;
+    uint32_t counter = 0;
+
+    for(uint64_t root = 0; root < n; ++root){
+        if(index[root] != NONE) continue;
+        index[root] = low[root] = counter++;
+        stack.push_back(root);
+        calls.push_back({(uint32_t)root, g.offsets[root]});
+
+        while(!calls.empty()){
+            Frame& f = calls.back();
+            uint32_t v = f.v;
+            if(f.next_edge < g.offsets[v + 1]){
+                uint32_t w = g.targets[f.next_edge++];
+                if(index[w] == NONE){
+                    index[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    calls.push_back({w, g.offsets[w]}); // f is invalid from here
+                }
+                else if(res.scc_of[w] == NONE){
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            // all successors done: v closes a component if it is its root
+            calls.pop_back();
+            if(low[v] == index[v]){
+                uint32_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    res.scc_of[w] = res.n_sccs;
+                } while(w != v);
+                res.n_sccs++;
+            }
+            if(!calls.empty()){
+                uint32_t u = calls.back().v;
+                low[u] = min(low[u], low[v]);
+            }
+        }
+    }
+    vector<uint32_t>().swap(index);
+    vector<uint32_t>().swap(low);
+
+    // --- STEP 2: Terminal components (no edge leaves them) ---
+    vector<bool> terminal(res.n_sccs, true);
+    for(uint64_t s = 0; s < n; ++s){
+        for(uint64_t e = g.offsets[s]; e < g.offsets[s + 1]; ++e){
+            if(res.scc_of[g.targets[e]] != res.scc_of[s]) terminal[res.scc_of[s]] = false;
+        }
+    }
+    for(uint32_t c = 0; c < res.n_sccs; ++c) if(terminal[c]) res.terminal_sccs.push_back(c);
+
+    // --- STEP 3: Live transitions ---
+    // Group the states of terminal components (counting sort by component),
+    // then count in how many terminal components each transition fires.
+    vector<uint32_t> first(res.n_sccs + 1, 0);
+    for(uint64_t s = 0; s < n; ++s) if(terminal[res.scc_of[s]]) first[res.scc_of[s] + 1]++;
+    for(uint32_t c = 0; c < res.n_sccs; ++c) first[c + 1] += first[c];
+    vector<uint32_t> members(first[res.n_sccs]);
+    vector<uint32_t> fill(first.begin(), first.end() - 1);
+    for(uint64_t s = 0; s < n; ++s) if(terminal[res.scc_of[s]]) members[fill[res.scc_of[s]]++] = s;
+
+    vector<uint64_t> fired_in(n_trans, 0);
+    vector<uint32_t> last_seen(n_trans, NONE);
+    for(uint32_t c : res.terminal_sccs){
+        bool has_edge = false;
+        for(uint32_t k = first[c]; k < first[c + 1]; ++k){
+            uint32_t s = members[k];
+            for(uint64_t e = g.offsets[s]; e < g.offsets[s + 1]; ++e){
+                has_edge = true;
+                uint32_t t = g.labels[e];
+                if(last_seen[t] != c){ last_seen[t] = c; fired_in[t]++; }
+            }
+        }
+        if(!has_edge) res.deadlocks++;
+    }
+    res.live.assign(n_trans, false);
+    for(int t = 0; t < n_trans; ++t){
+        res.live[t] = !res.terminal_sccs.empty() && fired_in[t] == res.terminal_sccs.size();
+    }
+
+    // --- STEP 4: Home states ---
+    // Every state reaches a terminal component; with only one, its states
+    // are exactly the home states.
+    if(res.terminal_sccs.size() == 1){
+        uint32_t c = res.terminal_sccs[0];
+        for(uint32_t k = first[c]; k < first[c + 1]; ++k) res.home_states.push_back(members[k]);
+        sort(res.home_states.begin(), res.home_states.end());
+        res.reversible = n > 0 && res.scc_of[0] == c;
+    }
+    return res;
+}
@@ -0,0 +1,22 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "ReachabilityGraph.h"
+#include <cstdint>
+#include <vector>
+
+struct LivenessResult {
+    std::vector<uint32_t> scc_of;        // [state] -> strongly connected component
+    uint32_t n_sccs = 0;
+    std::vector<uint32_t> terminal_sccs; // components no edge leaves (bottom SCCs)
+    std::vector<bool> live;              // [transition] fired inside every terminal SCC
+    std::vector<uint64_t> home_states;   // reachable from every reachable state
+    bool reversible = false;             // M0 (state 0) is a home state
+    uint64_t deadlocks = 0;              // terminal SCCs made of one state without edges
+};
+
+// Iterative Tarjan: no recursion, about 12 bytes per state plus the stacks,
+// so it works on graphs with tens of millions of states.
+LivenessResult analyze_liveness(const CsrView& g, int n_trans);
+
+#endif // LIVENESS_H
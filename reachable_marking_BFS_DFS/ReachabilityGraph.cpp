@@ -0,0 +1,234 @@
+#include "ReachabilityGraph.h"
+#include "CompiledNet.h"
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+// --- File layout ---
+struct GraphFileHeader {
+    char magic[8];            // "PNRGCSR1"
+    uint64_t n_states;
+    uint64_t n_edges;
+    uint32_t n_places;
+    uint32_t n_trans;
+    uint32_t bits_per_place;  // 1, 2, 4, 8, 16 or 32
+    uint32_t words_per_state; // uint64 words per packed marking
+    uint64_t markings_pos;    // byte offset of the packed markings
+};
+static_assert(sizeof(GraphFileHeader) == 48, "graph file header must stay 48 bytes");
+
+static const char GRAPH_MAGIC[8] = {'P','N','R','G','C','S','R','1'};
+
+static size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+CsrView ReachabilityGraph::view() const {
+    CsrView v;
+    v.n_states = states.size();
+    v.n_edges = targets.size();
+    v.offsets = offsets.data();
+    v.targets = targets.data();
+    v.labels = labels.data();
+    return v;
+}
+
+// --- Building ---
+
+static size_t hash_marking(const Marking& M) {
+    size_t h = 1469598103934665603ull;
+    for(int v : M){ h ^= (size_t)v; h *= 1099511628211ull; }
+    return h;
+}
+
+ReachabilityGraph build_reachability_graph(const PetriNet& pn) {
+    CompiledNet net = compile_net(pn);
+
+    ReachabilityGraph g;
+    g.n_places = net.n_places;
+    g.n_trans = net.n_trans;
+
+    // The index only stores state numbers; markings live once, in g.states
+    auto hasher = [&](uint32_t id){ return hash_marking(g.states[id]); };
+    auto equal = [&](uint32_t a, uint32_t b){ return g.states[a] == g.states[b]; };
+    unordered_set<uint32_t, decltype(hasher), decltype(equal)> index(1024, hasher, equal);
+
+    g.states.push_back(pn.M0);
+    index.insert(0);
+    g.offsets.push_back(0);
+    bool safe_start = within_bound(net, pn.M0);
+
+    // States are numbered in discovery order, so processing them by number
+    // is the BFS queue and the edges come out already grouped by source.
+    for(size_t s = 0; s < g.states.size(); ++s){
+        for(int j = 0; safe_start && j < net.n_trans; ++j){
+            if(!is_enabled(net, g.states[s], j)) continue;
+            g.states.push_back(fire(net, g.states[s], j));
+            uint32_t candidate = g.states.size() - 1;
+            auto ins = index.insert(candidate);
+            if(!ins.second) g.states.pop_back();
+            g.targets.push_back(*ins.first);
+            g.labels.push_back(j);
+        }
+        g.offsets.push_back(g.targets.size());
+    }
+    return g;
+}
+
+// --- Writing ---
+
+bool write_reachability_graph(const ReachabilityGraph& g, const string& path) {
+    int max_tokens = 1;
+    for(const auto& M : g.states) for(int v : M) if(v > max_tokens) max_tokens = v;
+    MarkingPacker packer = make_packer(g.n_places, max_tokens);
+
+    GraphFileHeader h;
+    memcpy(h.magic, GRAPH_MAGIC, 8);
+    h.n_states = g.states.size();
+    h.n_edges = g.targets.size();
+    h.n_places = g.n_places;
+    h.n_trans = g.n_trans;
+    h.bits_per_place = packer.bits;
+    h.words_per_state = packer.words;
+    size_t after_labels = sizeof(h) + (h.n_states + 1) * 8 + h.n_edges * 8;
+    h.markings_pos = align8(after_labels);
+
+    ofstream out(path, ios::binary);
+    if(!out) return false;
+
+    // Large sequential writes: each array goes out in one call
+    out.write((const char*)&h, sizeof(h));
+    out.write((const char*)g.offsets.data(), g.offsets.size() * sizeof(uint64_t));
+    out.write((const char*)g.targets.data(), g.targets.size() * sizeof(uint32_t));
+    out.write((const char*)g.labels.data(), g.labels.size() * sizeof(uint32_t));
+    static const char zeros[8] = {0};
+    out.write(zeros, h.markings_pos - after_labels);
+
+    const size_t batch = size_t(1) << 16; // words per write
+    vector<uint64_t> packed;
+    packed.reserve(batch + packer.words);
+    for(const auto& M : g.states){
+        packed.resize(packed.size() + packer.words);
+        pack_marking(packer, M, packed.data() + packed.size() - packer.words);
+        if(packed.size() >= batch){
+            out.write((const char*)packed.data(), packed.size() * sizeof(uint64_t));
+            packed.clear();
+        }
+    }
+    out.write((const char*)packed.data(), packed.size() * sizeof(uint64_t));
+    return (bool)out;
+}
+
+// --- Mapping ---
+
+// a + b and a * b, false on uint64 overflow
+static bool add_u64(uint64_t a, uint64_t b, uint64_t& r) { r = a + b; return r >= a; }
+static bool mul_u64(uint64_t a, uint64_t b, uint64_t& r) {
+    if(a != 0 && b > UINT64_MAX / a) return false;
+    r = a * b;
+    return true;
+}
+
+// Header fields consistent with each other and every section inside the file
+static bool valid_layout(const GraphFileHeader& h, uint64_t file_size) {
+    uint32_t bits = h.bits_per_place;
+    if(bits == 0 || bits > 32 || (bits & (bits - 1)) != 0) return false;
+    if(h.n_places > (uint32_t)INT32_MAX || h.n_trans > (uint32_t)INT32_MAX) return false;
+    uint32_t per_word = 64 / bits;
+    uint64_t expected_words = (uint64_t(h.n_places) + per_word - 1) / per_word;
+    if(h.words_per_state != expected_words && !(h.n_places == 0 && h.words_per_state <= 1)) return false;
+    if(h.n_states == 0 || h.n_states - 1 > UINT32_MAX) return false; // targets are uint32 state numbers
+
+    uint64_t offsets_bytes, edge_bytes, end, markings_bytes;
+    if(!mul_u64(h.n_states + 1, 8, offsets_bytes)) return false;
+    if(!mul_u64(h.n_edges, 8, edge_bytes)) return false; // targets and labels
+    if(!add_u64(sizeof(GraphFileHeader), offsets_bytes, end) || !add_u64(end, edge_bytes, end)) return false;
+    if(h.markings_pos % 8 != 0 || h.markings_pos < end) return false;
+    if(!mul_u64(h.n_states, h.words_per_state, markings_bytes) || !mul_u64(markings_bytes, 8, markings_bytes)) return false;
+    if(!add_u64(h.markings_pos, markings_bytes, end)) return false;
+    return end <= file_size;
+}
+
+bool MappedGraph::open(const string& path) {
+    close();
+#ifdef _WIN32
+    ifstream in(path, ios::binary | ios::ate);
+    if(!in) return false;
+    buffer.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char*)buffer.data(), buffer.size());
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(GraphFileHeader)){ ::close(fd); return false; }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(p == MAP_FAILED) return false;
+    data = (const unsigned char*)p;
+    size = st.st_size;
+#endif
+    if(size < sizeof(GraphFileHeader)){ close(); return false; }
+    const GraphFileHeader* h = (const GraphFileHeader*)data;
+    if(memcmp(h->magic, GRAPH_MAGIC, 8) != 0 || !valid_layout(*h, size)){
+        close();
+        return false;
+    }
+    n_places = h->n_places;
+    n_trans = h->n_trans;
+    packer.n_places = n_places;
+    packer.bits = h->bits_per_place;
+    packer.per_word = 64 / packer.bits;
+    packer.words = h->words_per_state;
+
+    csr.n_states = h->n_states;
+    csr.n_edges = h->n_edges;
+    csr.offsets = (const uint64_t*)(data + sizeof(GraphFileHeader));
+    csr.targets = (const uint32_t*)(csr.offsets + h->n_states + 1);
+    csr.labels = csr.targets + h->n_edges;
+    words = (const uint64_t*)(data + h->markings_pos);
+    // successor iteration trusts these: offsets rise from 0 to n_edges,
+    // targets are states and labels are transitions
+    bool ok = csr.offsets[0] == 0 && csr.offsets[csr.n_states] == csr.n_edges;
+    for(uint64_t s = 0; ok && s < csr.n_states; ++s) ok = csr.offsets[s] <= csr.offsets[s + 1];
+    for(uint64_t e = 0; ok && e < csr.n_edges; ++e) ok = csr.targets[e] < csr.n_states && csr.labels[e] < (uint32_t)n_trans;
+    if(!ok){
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedGraph::close() {
+#ifndef _WIN32
+    if(data) munmap((void*)data, size);
+#else
+    buffer.clear();
+#endif
+    data = nullptr;
+    size = 0;
+    csr = CsrView();
+}
+
+MappedGraph::~MappedGraph() { close(); }
+
+Marking MappedGraph::marking(uint64_t s) const {
+    return unpack_marking(packer, words + s * packer.words);
+}
+
+// --- Queries ---
+
+vector<uint64_t> deadlock_states(const CsrView& g) {
+    vector<uint64_t> dead;
+    for(uint64_t s = 0; s < g.n_states; ++s){
+        if(g.offsets[s] == g.offsets[s + 1]) dead.push_back(s);
+    }
+    return dead;
+}
@@ -0,0 +1,74 @@
+#ifndef REACHABILITY_GRAPH_H
+#define REACHABILITY_GRAPH_H
+
+#include "CompiledNet.h"
+#include "PetriNet.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Plain CSR arrays of a reachability graph, shared by the in-memory graph and
+// a mapped graph file. Successors of state s are targets[offsets[s] .. offsets[s+1]),
+// reached by firing transition labels[...].
+struct CsrView {
+    uint64_t n_states = 0;
+    uint64_t n_edges = 0;
+    const uint64_t* offsets = nullptr; // n_states + 1 entries
+    const uint32_t* targets = nullptr;
+    const uint32_t* labels = nullptr;
+};
+
+// Full reachability graph. States are numbered in BFS discovery order,
+// state 0 is M0.
+struct ReachabilityGraph {
+    int n_places = 0;
+    int n_trans = 0;
+    std::vector<Marking> states;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> labels;
+
+    CsrView view() const;
+};
+
+// BFS like bfs_reachable, but keeps every edge
+ReachabilityGraph build_reachability_graph(const PetriNet& pn);
+
+// Binary file: header, offsets, targets, labels, then the markings packed
+// with the fewest bits per place (1 for 1-safe nets). Sections are 8-byte
+// aligned so the file can be mapped and used in place.
+bool write_reachability_graph(const ReachabilityGraph& g, const std::string& path);
+
+// Read-only graph file mapped into memory (no copy of the arrays)
+class MappedGraph {
+public:
+    MappedGraph() = default;
+    ~MappedGraph();
+    MappedGraph(const MappedGraph&) = delete;
+    MappedGraph& operator=(const MappedGraph&) = delete;
+
+    // false for a missing or damaged file; checks the header, that the offsets
+    // rise, and that every target is a state and every label a transition
+    bool open(const std::string& path);
+    void close();
+
+    CsrView view() const { return csr; }
+    int num_places() const { return n_places; }
+    int num_trans() const { return n_trans; }
+    Marking marking(uint64_t s) const;
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    CsrView csr;
+    int n_places = 0;
+    int n_trans = 0;
+    MarkingPacker packer; // bits per place and words per state of the file
+    const uint64_t* words = nullptr;
+    std::vector<unsigned char> buffer; // file contents where mmap is not available
+};
+
+// States without successors
+std::vector<uint64_t> deadlock_states(const CsrView& g);
+
+#endif // REACHABILITY_GRAPH_H
@@ -0,0 +1,155 @@
+#include "Simulation.h"
+#include "CompiledNet.h"
+#include <algorithm>
+#include <thread>
+using namespace std;
+
+// --- xoshiro256**, seeded through splitmix64 ---
+struct Xoshiro256 {
+    uint64_t s[4];
+
+    explicit Xoshiro256(uint64_t seed) {
+        for(auto& w : s){
+            seed += 0x9e3779b97f4a7c15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            w = z ^ (z >> 31);
+        }
+    }
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t next() {
+        uint64_t r = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return r;
+    }
+
+    // uniform in [0, n) (Lemire's multiply-shift, bias below 2^-32 for small n)
+    uint32_t below(uint32_t n) { return (uint32_t)(((next() >> 32) * n) >> 32); }
+};
+
+// --- Per-thread state ---
+
+struct SimAccumulator {
+    uint64_t runs = 0, steps = 0, deadlocked = 0, deadlock_depth = 0;
+    uint64_t markings = 0;           // markings visited (steps + 1 per run)
+    vector<uint64_t> token_time;     // [place] sum of tokens over visited markings
+    vector<uint64_t> fire_count;
+};
+
+// Transitions whose enabling may change when t fires: those reading or
+// writing a place t changes (inputs for the token test, outputs for the bound)
+static vector<vector<int>> affected_transitions(const CompiledNet& net) {
+    vector<vector<int>> users(net.n_places);
+    for(int u = 0; u < net.n_trans; ++u){
+        for(const auto& a : net.input[u]) users[a.first].push_back(u);
+        for(const auto& d : net.delta[u]) users[d.first].push_back(u);
+    }
+    vector<vector<int>> affected(net.n_trans);
+    vector<int> mark(net.n_trans, -1);
+    for(int t = 0; t < net.n_trans; ++t){
+        for(const auto& d : net.delta[t]){
+            for(int u : users[d.first]){
+                if(mark[u] != t){ mark[u] = t; affected[t].push_back(u); }
+            }
+        }
+    }
+    return affected;
+}
+
+static void simulate_runs(const CompiledNet& net, const vector<vector<int>>& affected, const Marking& M0,
+                          uint64_t runs, uint64_t max_steps, uint64_t seed, SimAccumulator& acc) {
+    Xoshiro256 rng(seed);
+    acc.token_time.assign(net.n_places, 0);
+    acc.fire_count.assign(net.n_trans, 0);
+
+    // enabled set as a dense list plus positions for O(1) add / remove
+    vector<int> enabled;
+    vector<int> pos(net.n_trans, -1);
+    auto set_enabled = [&](int t, bool on){
+        if(on && pos[t] < 0){ pos[t] = (int)enabled.size(); enabled.push_back(t); }
+        else if(!on && pos[t] >= 0){
+            int last = enabled.back();
+            enabled[pos[t]] = last;
+            pos[last] = pos[t];
+            enabled.pop_back();
+            pos[t] = -1;
+        }
+    };
+
+    // token sums are settled lazily: a place adds value * duration when it changes
+    vector<uint64_t> since(net.n_places);
+    bool safe_start = within_bound(net, M0); // nothing fires from an unsafe M0
+    Marking M;
+
+    for(uint64_t r = 0; r < runs; ++r){
+        M = M0;
+        for(int t : enabled) pos[t] = -1;
+        enabled.clear();
+        for(int t = 0; safe_start && t < net.n_trans; ++t) set_enabled(t, is_enabled(net, M, t));
+        fill(since.begin(), since.end(), 0);
+
+        uint64_t step = 0;
+        while(step < max_steps && !enabled.empty()){
+            int t = enabled[rng.below((uint32_t)enabled.size())];
+            for(const auto& d : net.delta[t]){
+                acc.token_time[d.first] += (uint64_t)M[d.first] * (step + 1 - since[d.first]);
+                since[d.first] = step + 1;
+                M[d.first] += d.second;
+            }
+            for(int u : affected[t]) set_enabled(u, is_enabled(net, M, u));
+            acc.fire_count[t]++;
+            step++;
+        }
+        for(int p = 0; p < net.n_places; ++p) acc.token_time[p] += (uint64_t)M[p] * (step + 1 - since[p]);
+
+        acc.runs++;
+        acc.steps += step;
+        acc.markings += step + 1;
+        if(enabled.empty()){
+            acc.deadlocked++;
+            acc.deadlock_depth += step;
+        }
+    }
+}
+
+SimulationStats simulate(const PetriNet& pn, const SimulationOptions& opt) {
+    CompiledNet net = compile_net(pn);
+    vector<vector<int>> affected = affected_transitions(net);
+    int threads = opt.threads > 0 ? opt.threads : max(1u, thread::hardware_concurrency());
+    threads = (int)max<uint64_t>(1, min<uint64_t>(threads, opt.runs));
+
+    vector<SimAccumulator> acc(threads);
+    vector<thread> pool;
+    for(int i = 0; i < threads; ++i){
+        uint64_t runs = opt.runs / threads + ((uint64_t)i < opt.runs % threads ? 1 : 0);
+        uint64_t seed = opt.seed * 0x9e3779b97f4a7c15ull + i;
+        pool.emplace_back(simulate_runs, cref(net), cref(affected), cref(pn.M0), runs, opt.max_steps, seed, ref(acc[i]));
+    }
+    for(auto& th : pool) th.join();
+
+    // --- Merge ---
+    SimulationStats s;
+    s.fire_count.assign(net.n_trans, 0);
+    vector<uint64_t> token_time(net.n_places, 0);
+    uint64_t markings = 0, depth = 0;
+    for(const auto& a : acc){
+        s.runs += a.runs;
+        s.steps += a.steps;
+        s.deadlocked_runs += a.deadlocked;
+        depth += a.deadlock_depth;
+        markings += a.markings;
+        for(int p = 0; p < net.n_places; ++p) token_time[p] += a.token_time[p];
+        for(int t = 0; t < net.n_trans; ++t) s.fire_count[t] += a.fire_count[t];
+    }
+    if(s.runs) s.deadlock_probability = (double)s.deadlocked_runs / s.runs;
+    if(s.deadlocked_runs) s.mean_deadlock_depth = (double)depth / s.deadlocked_runs;
+    s.mean_tokens.assign(net.n_places, 0.0);
+    for(int p = 0; p < net.n_places && markings; ++p) s.mean_tokens[p] = (double)token_time[p] / markings;
+    return s;
+}
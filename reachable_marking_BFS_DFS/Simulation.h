@@ -0,0 +1,33 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "PetriNet.h"
+#include <cstdint>
+#include <vector>
+
+struct SimulationOptions {
+    uint64_t runs = 100000;      // random firing sequences
+    uint64_t max_steps = 1000;   // firings per run (k)
+    int threads = 0;             // 0 = one per hardware thread
+    uint64_t seed = 1;           // same seed and thread count -> same result
+};
+
+struct SimulationStats {
+    uint64_t runs = 0;
+    uint64_t steps = 0;                  // firings over all runs
+    uint64_t deadlocked_runs = 0;        // runs that reached a deadlock within max_steps
+    double deadlock_probability = 0.0;   // deadlocked_runs / runs
+    double mean_deadlock_depth = 0.0;    // firings before the deadlock, over deadlocked runs
+    std::vector<double> mean_tokens;     // [place] average over every marking visited
+    std::vector<uint64_t> fire_count;    // [transition] firings over all runs
+};
+
+// Monte Carlo token game: each run starts at M0 and fires a uniformly chosen
+// enabled transition (1-safe rule of bfs_reachable) until a deadlock or
+// max_steps. The enabled set is kept incrementally: after a firing only the
+// transitions sharing a changed place are re-checked. Runs are split over
+// threads with their own xoshiro256** generator and accumulators, merged at
+// the end.
+SimulationStats simulate(const PetriNet& pn, const SimulationOptions& opt = SimulationOptions());
+
+#endif // SIMULATION_H
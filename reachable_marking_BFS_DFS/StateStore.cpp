@@ -0,0 +1,212 @@
+#include "StateStore.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+using namespace std;
+
+// --- Hashing ---
+// splitmix64 finalizer over the place counts; different seeds give
+// independent enough hashes for fingerprints and double hashing.
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t hash_marking(const Marking& M, uint64_t seed) {
+    uint64_t h = mix64(seed ^ M.size());
+    for(int v : M) h = mix64(h ^ (uint64_t)(uint32_t)v);
+    return h;
+}
+
+// --- ExactStore ---
+
+size_t ExactStore::memory_bytes() const {
+    // tree node (3 pointers + color) plus the vector and its buffer
+    size_t per_state = 4 * sizeof(void*) + sizeof(Marking);
+    if(!states.empty()) per_state += states.begin()->size() * sizeof(int);
+    return states.size() * per_state;
+}
+
+// --- HashCompactionStore ---
+
+bool HashCompactionStore::insert(const Marking& M) {
+    uint64_t h = hash_marking(M, 0x9e3779b97f4a7c15ull);
+    if(h == 0) h = 1; // 0 is the empty slot
+    for(size_t i = slot_of(h);; i = i + 1 == table.size() ? 0 : i + 1){
+        if(table[i] == h) return false;
+        if(table[i] != 0) continue;
+        table[i] = h;
+        if(++count * 4 >= table.size() * 3) grow();
+        return true;
+    }
+}
+
+void HashCompactionStore::grow() {
+    // 1.5 times the slots: the load drops from 75% to 50%
+    vector<uint64_t> old(table.size() + table.size() / 2, 0);
+    old.swap(table);
+    for(uint64_t h : old){
+        if(h == 0) continue;
+        size_t i = slot_of(h);
+        while(table[i] != 0) i = i + 1 == table.size() ? 0 : i + 1;
+        table[i] = h;
+    }
+}
+
+double HashCompactionStore::omission_probability() const {
+    // birthday bound: P(some collision among n fingerprints of 64 bits)
+    double n = (double)count;
+    return -expm1(-n * (n - 1) / 2 / 18446744073709551616.0);
+}
+
+// --- BitstateStore ---
+
+BitstateStore::BitstateStore(size_t memory_bytes, int hashes, uint64_t seed)
+    : table(max<size_t>(1, memory_bytes / sizeof(uint64_t)), 0), k(hashes), seed(mix64(seed)) {
+    if(hashes < 1) throw invalid_argument("BitstateStore needs at least one hash");
+    n_bits = (uint64_t)table.size() * 64;
+}
+
+bool BitstateStore::insert(const Marking& M) {
+    // Kirsch-Mitzenmacher double hashing: bit i = h1 + i*h2
+    uint64_t h1 = hash_marking(M, 0x9e3779b97f4a7c15ull ^ seed);
+    uint64_t h2 = hash_marking(M, 0xc2b2ae3d27d4eb4full ^ seed) | 1;
+    bool is_new = false;
+    for(int i = 0; i < k; ++i){
+        uint64_t bit = (h1 + (uint64_t)i * h2) % n_bits;
+        uint64_t mask = uint64_t(1) << (bit & 63);
+        if(!(table[bit >> 6] & mask)){ table[bit >> 6] |= mask; is_new = true; }
+    }
+    if(is_new){
+        // a new state is lost when all its k bits are already set:
+        // (1 - e^(-k n / m))^k with n states stored so far
+        expected_omissions += pow(-expm1(-(double)k * count / (double)n_bits), k);
+        count++;
+    }
+    return is_new;
+}
+
+double BitstateStore::omission_probability() const {
+    return -expm1(-expected_omissions);
+}
+
+// --- TreeStore ---
+
+static const uint64_t EMPTY_SLOT = ~0ull; // never a key: ids and token counts stay below 2^32 - 1
+
+TreeStore::TreeStore(int n_places, size_t memory_bytes) : n_places(n_places) {
+    // leaves hold 2 places; each level halves the node count
+    int width = max(1, (n_places + 1) / 2);
+    depth = 0;
+    while(width > 1){ width = (width + 1) / 2; depth++; }
+
+    // slots (8 bytes) + root bits (1/8 byte) per node, power-of-two count;
+    // at most 2^31 slots, so node ids stay below 2^31 and a key built from two
+    // ids is never EMPTY_SLOT
+    uint64_t cap = 64;
+    while(cap * 2 * 8 + cap * 2 / 8 <= memory_bytes && cap < (uint64_t(1) << 31)) cap *= 2;
+    mask = cap - 1;
+    slots.reset(new atomic<uint64_t>[cap]);
+    root_bits.reset(new atomic<uint64_t>[cap / 64]);
+    for(uint64_t i = 0; i < cap; ++i) slots[i].store(EMPTY_SLOT, memory_order_relaxed);
+    for(uint64_t i = 0; i < cap / 64; ++i) root_bits[i].store(0, memory_order_relaxed);
+}
+
+uint32_t TreeStore::intern(uint64_t key, bool& inserted) {
+    inserted = false;
+    uint64_t i = mix64(key) & mask;
+    for(uint64_t probe = 0; probe <= mask; ++probe, i = (i + 1) & mask){
+        uint64_t cur = slots[i].load(memory_order_acquire);
+        if(cur == EMPTY_SLOT){
+            if(slots[i].compare_exchange_strong(cur, key, memory_order_acq_rel)){
+                used.fetch_add(1, memory_order_relaxed);
+                inserted = true;
+                return (uint32_t)i;
+            }
+            // lost the race: cur now holds the winner's key
+        }
+        if(cur == key) return (uint32_t)i;
+    }
+    throw runtime_error("TreeStore: table full");
+}
+
+uint32_t TreeStore::insert_id(const Marking& M, bool& is_new) {
+    bool ins;
+    vector<uint32_t> level((n_places + 1) / 2 + 1);
+    size_t width = 0;
+    for(int i = 0; i < n_places || width == 0; i += 2){
+        uint64_t a = i < n_places ? (uint32_t)M[i] : 0;
+        uint64_t b = i + 1 < n_places ? (uint32_t)M[i + 1] : 0;
+        level[width++] = intern(a << 32 | b, ins);
+    }
+    for(int d = 0; d < depth; ++d){
+        size_t next = 0;
+        for(size_t k = 0; k < width; k += 2){
+            uint64_t a = level[k];
+            uint64_t b = k + 1 < width ? level[k + 1] : 0;
+            level[next++] = intern(a << 32 | b, ins);
+        }
+        width = next;
+    }
+
+    // the same pair may also be an inner node elsewhere: states are marked separately
+    uint32_t root = level[0];
+    uint64_t bit = uint64_t(1) << (root & 63);
+    is_new = !(root_bits[root >> 6].fetch_or(bit, memory_order_acq_rel) & bit);
+    if(is_new) roots.fetch_add(1, memory_order_relaxed);
+    return root;
+}
+
+bool TreeStore::insert(const Marking& M) {
+    bool is_new;
+    insert_id(M, is_new);
+    return is_new;
+}
+
+Marking TreeStore::get(uint32_t root) const {
+    // node count per level, leaves first (padding children are not unfolded)
+    vector<size_t> widths(1, max(1, (n_places + 1) / 2));
+    for(int d = 0; d < depth; ++d) widths.push_back((widths.back() + 1) / 2);
+
+    // unfold top-down: ids at each level, then the leaf values
+    vector<uint32_t> ids(1, root);
+    for(int d = depth; d > 0; --d){
+        vector<uint32_t> below;
+        for(uint32_t id : ids){
+            uint64_t key = slots[id].load(memory_order_acquire);
+            below.push_back((uint32_t)(key >> 32));
+            if(below.size() < widths[d - 1]) below.push_back((uint32_t)key);
+        }
+        ids.swap(below);
+    }
+    Marking M(n_places);
+    for(int i = 0; i < n_places; ++i){
+        uint64_t key = slots[ids[i / 2]].load(memory_order_acquire);
+        M[i] = (int)(i % 2 == 0 ? key >> 32 : key & 0xffffffffu);
+    }
+    return M;
+}
+
+size_t TreeStore::memory_bytes() const {
+    return (mask + 1) * sizeof(uint64_t) + (mask + 1) / 8;
+}
+
+double TreeStore::compression_ratio() const {
+    uint64_t n = nodes();
+    if(n == 0) return 1.0;
+    return (double)size() * n_places * sizeof(int) / ((double)n * sizeof(uint64_t));
+}
+
+// --- Factory ---
+
+unique_ptr<StateStore> make_state_store(StoreMode mode, size_t memory_bytes, int n_places) {
+    switch(mode){
+        case StoreMode::Exact:          return unique_ptr<StateStore>(new ExactStore());
+        case StoreMode::HashCompaction: return unique_ptr<StateStore>(new HashCompactionStore());
+        case StoreMode::Bitstate:       return unique_ptr<StateStore>(new BitstateStore(memory_bytes));
+        case StoreMode::Tree:           return unique_ptr<StateStore>(new TreeStore(n_places, memory_bytes));
+    }
+    throw invalid_argument("unknown store mode");
+}
@@ -0,0 +1,140 @@
+#ifndef STATE_STORE_H
+#define STATE_STORE_H
+
+#include "PetriNet.h"
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <vector>
+
+using MarkingSet = std::set<Marking>;
+
+// Visited-state storage for the explicit engines (bfs_reachable / dfs_reachable).
+// Lossy stores may answer "seen" for a new marking; that state and everything
+// only reachable through it is then omitted, never invented.
+class StateStore {
+public:
+    virtual ~StateStore() = default;
+
+    // true if M was not seen before, and remembers it
+    virtual bool insert(const Marking& M) = 0;
+    virtual uint64_t size() const = 0;        // successful inserts
+    virtual size_t memory_bytes() const = 0;  // approximate
+
+    // Estimated probability that at least one state was wrongly reported as seen
+    virtual double omission_probability() const = 0;
+};
+
+// Full markings, no loss
+class ExactStore : public StateStore {
+public:
+    bool insert(const Marking& M) override { return states.insert(M).second; }
+    uint64_t size() const override { return states.size(); }
+    size_t memory_bytes() const override;
+    double omission_probability() const override { return 0.0; }
+
+    const MarkingSet& markings() const { return states; }
+    MarkingSet take() { return std::move(states); }
+
+private:
+    MarkingSet states;
+};
+
+// Hash compaction: one 64-bit fingerprint per state. Two reachable states
+// with the same fingerprint make the second one look visited.
+// The fingerprints live in an open-addressing table (linear probing, 0 marks
+// an empty slot) kept 50-75% full, so a state costs 11 to 16 bytes.
+class HashCompactionStore : public StateStore {
+public:
+    bool insert(const Marking& M) override;
+    uint64_t size() const override { return count; }
+    size_t memory_bytes() const override { return table.size() * sizeof(uint64_t); }
+    double omission_probability() const override;
+
+private:
+    void grow();
+    size_t slot_of(uint64_t h) const { return (size_t)(((h >> 32) * table.size()) >> 32); }
+
+    std::vector<uint64_t> table = std::vector<uint64_t>(1024, 0);
+    uint64_t count = 0;
+};
+
+// Bitstate hashing (Bloom filter): k bit positions per state in a fixed
+// table of memory_bytes. A state is new if any of its bits was clear.
+// Stores with different seeds use independent hash functions, so they lose
+// different states.
+class BitstateStore : public StateStore {
+public:
+    explicit BitstateStore(size_t memory_bytes, int hashes = 3, uint64_t seed = 0);
+
+    bool insert(const Marking& M) override;
+    uint64_t size() const override { return count; }
+    size_t memory_bytes() const override { return table.size() * sizeof(uint64_t); }
+    double omission_probability() const override;
+
+private:
+    std::vector<uint64_t> table;
+    uint64_t n_bits;
+    int k;
+    uint64_t seed;
+    uint64_t count = 0;
+    double expected_omissions = 0.0; // sum of the false-positive rates seen by each insert
+};
+
+// Tree compression (recursive indexing, as in LTSmin): place values are
+// paired into 64-bit leaves, pairs of node ids are interned level by level,
+// and a state is the id of its root. Neighbouring states share all but a
+// few paths, so a state costs about one new node per changed place per level.
+// All nodes live in one fixed-size lock-free hash table; a node id is its
+// slot. insert() may be called from several threads at once.
+class TreeStore : public StateStore {
+public:
+    TreeStore(int n_places, size_t memory_bytes = size_t(64) << 20);
+
+    bool insert(const Marking& M) override;
+    uint64_t size() const override { return roots.load(std::memory_order_relaxed); }
+    size_t memory_bytes() const override;
+    double omission_probability() const override { return 0.0; }
+
+    // Root id of M; is_new tells whether the state was stored by this call.
+    // Throws runtime_error when the table is full.
+    uint32_t insert_id(const Marking& M, bool& is_new);
+    Marking get(uint32_t root) const;
+
+    uint64_t nodes() const { return used.load(std::memory_order_relaxed); }
+    // Bytes of the stored markings as plain int vectors / bytes of the used nodes
+    double compression_ratio() const;
+
+private:
+    uint32_t intern(uint64_t key, bool& inserted);
+
+    int n_places;
+    int depth; // levels of pairing above the leaves
+    uint64_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    std::unique_ptr<std::atomic<uint64_t>[]> root_bits; // 1 bit per slot: slot is a stored state
+    std::atomic<uint64_t> used{0};
+    std::atomic<uint64_t> roots{0};
+};
+
+// Hash of a marking used by the lossy stores (splitmix64 over the place counts)
+uint64_t hash_marking(const Marking& M, uint64_t seed);
+
+enum class StoreMode { Exact, HashCompaction, Bitstate, Tree };
+
+// memory_bytes is the bitstate / tree table size; the other modes grow as needed.
+// Tree mode needs n_places.
+std::unique_ptr<StateStore> make_state_store(StoreMode mode, size_t memory_bytes = size_t(64) << 20,
+                                             int n_places = 0);
+
+// Result of a driver run on any store
+struct ExplorationStats {
+    uint64_t states = 0;          // states stored (and expanded)
+    uint64_t edges = 0;           // transitions fired
+    uint64_t deadlocks = 0;       // expanded states without enabled transitions
+    double omission_probability = 0.0;
+};
+
+#endif // STATE_STORE_H
@@ -0,0 +1,96 @@
+#include "Swarm.h"
+#include "CompiledNet.h"
+#include "StateStore.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+using namespace std;
+
+// --- One worker: iterative DFS keeping the path for the trace ---
+
+struct SwarmFrame {
+    Marking M;
+    int next = 0;       // position in the worker's transition order
+    bool any = false;   // some transition was enabled
+    int via = -1;       // transition that led here
+};
+
+struct SwarmShared {
+    atomic<bool> stop{false};
+    mutex lock;
+    SwarmResult result;
+};
+
+static void swarm_worker(const CompiledNet& net, const Marking& M0, int id, uint64_t seed,
+                         size_t memory, uint64_t max_depth, SwarmShared& shared) {
+    vector<int> order(net.n_trans);
+    for(int j = 0; j < net.n_trans; ++j) order[j] = j;
+    if(id != 0){
+        mt19937_64 rng(seed);
+        shuffle(order.begin(), order.end(), rng);
+    }
+
+    BitstateStore store(memory, 3, seed);
+    bool safe_start = within_bound(net, M0); // nothing fires from an unsafe M0
+    vector<SwarmFrame> path;
+    store.insert(M0);
+    path.push_back({M0});
+
+    uint64_t steps = 0;
+    while(!path.empty()){
+        if((++steps & 1023) == 0 && shared.stop.load(memory_order_relaxed)) break;
+
+        SwarmFrame& top = path.back();
+        int t = -1;
+        while(safe_start && top.next < net.n_trans){
+            int j = order[top.next++];
+            if(!is_enabled(net, top.M, j)) continue;
+            top.any = true;
+            if(max_depth && path.size() > max_depth) continue;
+            Marking Mnew = fire(net, top.M, j);
+            if(store.insert(Mnew)){
+                t = j;
+                path.push_back({move(Mnew), 0, false, j});
+                break;
+            }
+        }
+        if(t >= 0) continue;
+
+        if(!path.back().any){
+            // deadlock: the first worker to claim it reports its path
+            if(!shared.stop.exchange(true)){
+                lock_guard<mutex> g(shared.lock);
+                shared.result.found = true;
+                shared.result.worker = id;
+                shared.result.worker_seed = seed;
+                for(size_t k = 1; k < path.size(); ++k) shared.result.trace.push_back(path[k].via);
+                shared.result.deadlock = path.back().M;
+            }
+            break;
+        }
+        path.pop_back();
+    }
+
+    lock_guard<mutex> g(shared.lock);
+    shared.result.states += store.size();
+    if(path.empty()){
+        shared.result.workers_finished++;
+        shared.result.omission_probability = max(shared.result.omission_probability, store.omission_probability());
+    }
+}
+
+SwarmResult swarm_deadlock_search(const PetriNet& pn, const SwarmOptions& opt) {
+    CompiledNet net = compile_net(pn);
+    int workers = opt.workers > 0 ? opt.workers : max(1u, thread::hardware_concurrency());
+    size_t slice = max<size_t>(64, opt.memory_bytes / workers);
+
+    SwarmShared shared;
+    vector<thread> pool;
+    for(int i = 0; i < workers; ++i){
+        pool.emplace_back(swarm_worker, cref(net), cref(pn.M0), i, opt.seed + i, slice, opt.max_depth, ref(shared));
+    }
+    for(auto& th : pool) th.join();
+    return move(shared.result);
+}
@@ -0,0 +1,38 @@
+#ifndef SWARM_H
+#define SWARM_H
+
+#include "PetriNet.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SwarmOptions {
+    int workers = 0;                              // 0 = one per hardware thread
+    size_t memory_bytes = size_t(256) << 20;      // bitstate memory, split evenly over the workers
+    uint64_t seed = 1;                            // worker i uses seed + i
+    uint64_t max_depth = 0;                       // longest DFS path, 0 = no limit
+};
+
+struct SwarmResult {
+    bool found = false;           // a deadlock was reached
+    int worker = -1;              // the worker that reached it first
+    uint64_t worker_seed = 0;     // its seed, to replay the same search
+    std::vector<int> trace;       // transitions fired from M0 to the deadlock
+    Marking deadlock;
+
+    uint64_t states = 0;          // summed over the workers (overlaps counted again)
+    uint64_t workers_finished = 0;// workers whose DFS ran to completion
+    double omission_probability = 0.0; // largest estimate of a finished worker
+};
+
+// Swarm verification: many independent depth-first searches of the same
+// net, each with its own transition order, bitstate hash functions and a
+// slice of the memory. Every worker covers a different part of a state
+// space too large for one exhaustive search; the first deadlock found
+// cancels the others. Worker 0 keeps the plain transition order of
+// dfs_reachable. Deadlocks are judged like dfs_reachable (1-safe firing).
+// Without a deadlock, found stays false; with lossy stores that is not a
+// proof unless omission_probability is negligible.
+SwarmResult swarm_deadlock_search(const PetriNet& pn, const SwarmOptions& opt = SwarmOptions());
+
+#endif // SWARM_H
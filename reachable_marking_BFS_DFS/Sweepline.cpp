@@ -0,0 +1,121 @@
+#include "Sweepline.h"
+#include "CompiledNet.h"
+#include "Liveness.h"
+#include <algorithm>
+#include <map>
+#include <set>
+using namespace std;
+
+long long ProgressMeasure::operator()(const Marking& M) const {
+    long long psi = 0;
+    for(size_t p = 0; p < M.size() && p < weight.size(); ++p) psi += weight[p] * M[p];
+    return psi;
+}
+
+ProgressMeasure derive_progress_measure(const PetriNet& pn) {
+    CompiledNet net = compile_net(pn);
+    int n = net.n_places;
+
+    // --- STEP 1: Place graph in CSR form ---
+    vector<vector<uint32_t>> succ(n);
+    for(int t = 0; t < net.n_trans; ++t){
+        vector<int> post;
+        for(const auto& d : net.delta[t]) if(d.second > 0) post.push_back(d.first);
+        for(const auto& a : net.input[t]){
+            for(int q : post) if(q != a.first) succ[a.first].push_back(q);
+        }
+    }
+    vector<uint64_t> offsets(n + 1, 0);
+    vector<uint32_t> targets, labels;
+    for(int p = 0; p < n; ++p){
+        targets.insert(targets.end(), succ[p].begin(), succ[p].end());
+        offsets[p + 1] = targets.size();
+    }
+    labels.assign(targets.size(), 0);
+    CsrView g{(uint64_t)n, targets.size(), offsets.data(), targets.data(), labels.data()};
+
+    // --- STEP 2: Longest-path depth of the components ---
+    // Tarjan numbers components sinks first, so decreasing ids are a topological order.
+    LivenessResult scc = analyze_liveness(g, 1);
+    vector<int> order(n);
+    for(int p = 0; p < n; ++p) order[p] = p;
+    sort(order.begin(), order.end(), [&](int a, int b){ return scc.scc_of[a] > scc.scc_of[b]; });
+
+    vector<long long> depth(scc.n_sccs, 0);
+    for(int p : order){
+        for(uint32_t q : succ[p]){
+            if(scc.scc_of[q] != scc.scc_of[p]){
+                depth[scc.scc_of[q]] = max(depth[scc.scc_of[q]], depth[scc.scc_of[p]] + 1);
+            }
+        }
+    }
+
+    ProgressMeasure pm;
+    pm.weight.resize(n);
+    for(int p = 0; p < n; ++p) pm.weight[p] = depth[scc.scc_of[p]];
+    return pm;
+}
+
+SweepStats sweep_line(const PetriNet& pn, const ProgressMeasure& pm,
+                      const function<void(const Marking&)>& on_state) {
+    CompiledNet net = compile_net(pn);
+    SweepStats stats;
+
+    set<Marking> persistent = {pn.M0};
+    vector<Marking> roots = {pn.M0};
+    bool safe_start = within_bound(net, pn.M0); // nothing fires from an unsafe M0
+
+    while(!roots.empty()){
+        stats.sweeps++;
+
+        // visited states at or ahead of the sweep, by progress value; the
+        // unprocessed ones are also queued (copies) by progress value
+        map<long long, set<Marking>> layers;
+        map<long long, vector<Marking>> queue;
+        uint64_t stored = 0, queued = 0;
+        for(const auto& M : roots){
+            if(layers[pm(M)].insert(M).second){ queue[pm(M)].push_back(M); stored++; queued++; }
+        }
+        roots.clear();
+
+        while(!queue.empty()){
+            long long psi = queue.begin()->first;
+            Marking M = queue.begin()->second.back();
+            queue.begin()->second.pop_back();
+            if(queue.begin()->second.empty()) queue.erase(queue.begin());
+            queued--;
+
+            // garbage-collect layers the sweep has passed
+            while(!layers.empty() && layers.begin()->first < psi){
+                stored -= layers.begin()->second.size();
+                layers.erase(layers.begin());
+            }
+
+            stats.states_explored++;
+            if(on_state) on_state(M);
+            bool any = false;
+            for(int j = 0; safe_start && j < net.n_trans; ++j){
+                if(!is_enabled(net, M, j)) continue;
+                any = true;
+                Marking Mnew = fire(net, M, j);
+                long long next = pm(Mnew);
+                if(next < psi){
+                    stats.regress_edges++;
+                    if(persistent.insert(Mnew).second) roots.push_back(Mnew);
+                }
+                else if(layers[next].insert(Mnew).second){
+                    queue[next].push_back(Mnew);
+                    stored++;
+                    queued++;
+                }
+            }
+            // counted as explored: the layers already explore M once per sweep,
+            // and remembering every dead marking would defeat the sweep-line
+            if(!any) stats.deadlocks++;
+            stats.peak_stored = max(stats.peak_stored, stored + queued + persistent.size());
+        }
+    }
+    stats.persistent = persistent.size() - 1; // M0 is kept but reached by no edge
+    stats.exact = stats.regress_edges == 0;
+    return stats;
+}
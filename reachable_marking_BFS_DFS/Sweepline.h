@@ -0,0 +1,45 @@
+#ifndef SWEEPLINE_H
+#define SWEEPLINE_H
+
+#include "PetriNet.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Linear progress measure psi(M) = sum weight[p] * M(p)
+struct ProgressMeasure {
+    std::vector<long long> weight; // [place]
+
+    long long operator()(const Marking& M) const;
+};
+
+// Weights from the net structure: places are grouped into the strongly
+// connected components of the place graph (p -> q when some t has p in its
+// pre-set and q in its post-set), and each place gets the longest-path depth
+// of its component. This is a heuristic, not a monotone measure: a
+// transition moving one token forward keeps or raises psi, but a join that
+// consumes several tokens can lower it. sweep_line handles those regress
+// edges by re-exploring from persistent markings.
+ProgressMeasure derive_progress_measure(const PetriNet& pn);
+
+struct SweepStats {
+    uint64_t states_explored = 0; // with regress edges a state may be explored in several sweeps
+    uint64_t peak_stored = 0;     // most markings held at once: layers, their queued copies
+                                  // and persistent markings
+    uint64_t regress_edges = 0;   // edges that decrease psi
+    uint64_t persistent = 0;      // targets of regress edges, kept for the whole run
+    uint64_t sweeps = 0;
+    uint64_t deadlocks = 0;       // dead markings explored; exact when 'exact', otherwise a
+                                  // dead marking counts once per sweep that reaches it
+    bool exact = true;            // no regress edge: every state explored exactly once
+};
+
+// Generalized sweep-line (1-safe, like bfs_reachable): states are processed
+// in increasing progress order and layers behind the sweep are deleted.
+// Targets of regress edges are stored persistently and start the next sweep,
+// so every reachable marking is explored at least once. on_state sees each
+// explored marking.
+SweepStats sweep_line(const PetriNet& pn, const ProgressMeasure& pm,
+                      const std::function<void(const Marking&)>& on_state = nullptr);
+
+#endif // SWEEPLINE_H
@@ -0,0 +1,354 @@
+#include "Symmetry.h"
+#include "CompiledNet.h"
+#include <algorithm>
+#include <numeric>
+#include <set>
+using namespace std;
+
+// --- Colored digraph of the net ---
+// Vertices 0..P-1 are places, P..P+T-1 transitions; arcs carry their weight.
+struct NetGraph {
+    int n = 0;
+    vector<vector<pair<int,int>>> out, in; // (neighbour, weight)
+    vector<int> initial;                  // 0 = place, 1 = transition
+};
+
+static NetGraph build_graph(const CompiledNet& net) {
+    NetGraph g;
+    g.n = net.n_places + net.n_trans;
+    g.out.assign(g.n, {});
+    g.in.assign(g.n, {});
+    g.initial.assign(g.n, 0);
+    for(int t = 0; t < net.n_trans; ++t){
+        int v = net.n_places + t;
+        g.initial[v] = 1;
+        // output weight = input weight + change (self-loops have no delta entry)
+        vector<pair<int,int>> outputs;
+        for(const auto& a : net.input[t]){
+            g.out[a.first].push_back({v, a.second});
+            g.in[v].push_back({a.first, a.second});
+            outputs.push_back(a);
+        }
+        for(const auto& d : net.delta[t]){
+            auto it = find_if(outputs.begin(), outputs.end(), [&](const pair<int,int>& o){ return o.first == d.first; });
+            if(it == outputs.end()) outputs.push_back(d);
+            else it->second += d.second;
+        }
+        for(const auto& o : outputs){
+            if(o.second <= 0) continue;
+            g.out[v].push_back(o);
+            g.in[o.first].push_back({v, o.second});
+        }
+    }
+    for(int v = 0; v < g.n; ++v){
+        sort(g.out[v].begin(), g.out[v].end());
+        sort(g.in[v].begin(), g.in[v].end());
+    }
+    return g;
+}
+
+// --- Partitions ---
+// Ordered partition of the vertices: cells are ranges of 'elems', and a
+// cell is named by its first position. Splits are deterministic in the
+// keys only, so refinement commutes with relabeling of the vertices.
+struct Partition {
+    vector<int> elems;  // vertices, cell by cell
+    vector<int> pos;    // [v] -> position in elems
+    vector<int> start;  // [v] -> first position of v's cell
+    vector<int> end;    // [first position] -> one past the cell's last position
+    int cells = 0;
+
+    int size_at(int s) const { return end[s] - s; }
+    bool discrete() const { return cells == (int)elems.size(); }
+};
+
+static Partition initial_partition(const NetGraph& g) {
+    Partition P;
+    P.elems.resize(g.n);
+    P.pos.resize(g.n);
+    P.start.resize(g.n);
+    P.end.assign(g.n + 1, 0);
+    int k = 0;
+    for(int kind = 0; kind < 2; ++kind){
+        int s = k;
+        for(int v = 0; v < g.n; ++v){
+            if(g.initial[v] != kind) continue;
+            P.elems[k] = v;
+            P.pos[v] = k++;
+            P.start[v] = s;
+        }
+        if(k > s){ P.end[s] = k; P.cells++; }
+    }
+    return P;
+}
+
+// Equitable refinement with a splitter queue (Hopcroft-style): every vertex
+// is keyed by its (direction, weight) arcs into the splitter, and cells
+// whose vertices get different keys are split in key order.
+static void refine(const NetGraph& g, Partition& P, vector<int> queue) {
+    vector<char> queued(g.n + 1, 0);
+    for(int s : queue) queued[s] = 1;
+    vector<int> slot(g.n, -1);
+    vector<int> touched;
+    vector<vector<pair<int,int>>> keys;
+
+    for(size_t head = 0; head < queue.size() && !P.discrete(); ++head){
+        int S = queue[head];
+        queued[S] = 0;
+
+        // --- keys of the vertices with arcs into the splitter ---
+        touched.clear();
+        for(int k = S; k < P.end[S]; ++k){
+            int u = P.elems[k];
+            for(int d = 0; d < 2; ++d){
+                for(const auto& a : (d == 0 ? g.in[u] : g.out[u])){
+                    int v = a.first;
+                    if(slot[v] < 0){
+                        slot[v] = (int)touched.size();
+                        touched.push_back(v);
+                        if(keys.size() < touched.size()) keys.emplace_back();
+                        keys[slot[v]].clear();
+                    }
+                    keys[slot[v]].push_back({d, a.second});
+                }
+            }
+        }
+        for(int v : touched) sort(keys[slot[v]].begin(), keys[slot[v]].end());
+        sort(touched.begin(), touched.end(), [&](int a, int b){
+            if(P.start[a] != P.start[b]) return P.start[a] < P.start[b];
+            return keys[slot[a]] < keys[slot[b]];
+        });
+
+        // --- split each touched cell ---
+        for(size_t i = 0; i < touched.size(); ){
+            int s = P.start[touched[i]], e = P.end[s];
+            size_t j = i;
+            while(j < touched.size() && P.start[touched[j]] == s) j++;
+            int n_touched = (int)(j - i);
+            int untouched = (e - s) - n_touched;
+            bool uniform = untouched == 0 && keys[slot[touched[i]]] == keys[slot[touched[j - 1]]];
+            if(!uniform){
+                // touched vertices to the back of the cell, in key order
+                for(size_t k = i; k < j; ++k){
+                    int b = e - 1 - (int)(k - i);
+                    int v = touched[k], w = P.elems[b];
+                    swap(P.elems[P.pos[v]], P.elems[b]);
+                    swap(P.pos[v], P.pos[w]);
+                }
+                for(size_t k = i; k < j; ++k){
+                    int p = s + untouched + (int)(k - i);
+                    P.elems[p] = touched[k];
+                    P.pos[touched[k]] = p;
+                }
+                // fragments: untouched (key "none" sorts first), then one per key
+                vector<int> frags;
+                if(untouched > 0) frags.push_back(s);
+                for(size_t k = i; k < j; ++k){
+                    if(k == i || keys[slot[touched[k]]] != keys[slot[touched[k - 1]]]){
+                        frags.push_back(P.pos[touched[k]]);
+                    }
+                }
+                frags.push_back(e);
+                int largest = 0;
+                for(size_t f = 0; f + 1 < frags.size(); ++f){
+                    P.end[frags[f]] = frags[f + 1];
+                    for(int p = frags[f]; f > 0 && p < frags[f + 1]; ++p) P.start[P.elems[p]] = frags[f];
+                    if(frags[f + 1] - frags[f] > frags[largest + 1] - frags[largest]) largest = (int)f;
+                }
+                P.cells += (int)frags.size() - 2;
+                for(size_t f = 0; f + 1 < frags.size(); ++f){
+                    if(queued[frags[f]]) continue;
+                    if(!queued[s] && (int)f == largest) continue;
+                    queued[frags[f]] = 1;
+                    queue.push_back(frags[f]);
+                }
+            }
+            i = j;
+        }
+        for(int v : touched) slot[v] = -1;
+    }
+}
+
+// w split off to the front of its cell, then refined
+static Partition individualize(const NetGraph& g, const Partition& P0, int w) {
+    Partition P = P0;
+    int s = P.start[w], e = P.end[s];
+    int first = P.elems[s];
+    swap(P.elems[s], P.elems[P.pos[w]]);
+    swap(P.pos[w], P.pos[first]);
+    P.end[s] = s + 1;
+    P.end[s + 1] = e;
+    for(int p = s + 1; p < e; ++p) P.start[P.elems[p]] = s + 1;
+    P.cells++;
+    refine(g, P, {s});
+    return P;
+}
+
+// First non-singleton cell (its first position), -1 if discrete
+static int target_cell(const Partition& P) {
+    for(int s = 0; s < (int)P.elems.size(); s = P.end[s]) if(P.size_at(s) > 1) return s;
+    return -1;
+}
+
+static vector<int> cell_sizes(const Partition& P) {
+    vector<int> size;
+    for(int s = 0; s < (int)P.elems.size(); s = P.end[s]) size.push_back(P.size_at(s));
+    return size;
+}
+
+// --- Search ---
+
+struct UnionFind {
+    vector<int> parent;
+    explicit UnionFind(int n) : parent(n) { iota(parent.begin(), parent.end(), 0); }
+    int find(int v) { while(parent[v] != v) v = parent[v] = parent[parent[v]]; return v; }
+    void unite(int a, int b) { parent[find(a)] = find(b); }
+};
+
+struct Searcher {
+    const NetGraph& g;
+    size_t budget;
+    vector<int> leaf_vertex;            // first leaf: position -> vertex
+    vector<vector<int>> path_sizes;     // cell sizes along the first path
+
+    bool is_automorphism(const vector<int>& gamma) const {
+        for(int v = 0; v < g.n; ++v){
+            vector<pair<int,int>> mapped;
+            for(const auto& a : g.out[v]) mapped.push_back({gamma[a.first], a.second});
+            sort(mapped.begin(), mapped.end());
+            if(mapped != g.out[gamma[v]]) return false;
+        }
+        return true;
+    }
+
+    // Depth-first search below 'color' (at path depth 'depth') for a leaf
+    // equivalent to the first leaf. Fills gamma on success.
+    bool find_leaf(const Partition& P, size_t depth, vector<int>& gamma) {
+        if(depth >= path_sizes.size() || cell_sizes(P) != path_sizes[depth]) return false;
+        int cell = target_cell(P);
+        if(cell < 0){
+            gamma.assign(g.n, 0);
+            for(int p = 0; p < g.n; ++p) gamma[leaf_vertex[p]] = P.elems[p];
+            return is_automorphism(gamma);
+        }
+        vector<int> members(P.elems.begin() + cell, P.elems.begin() + P.end[cell]);
+        for(int u : members){
+            if(budget == 0) return false;
+            budget--;
+            if(find_leaf(individualize(g, P, u), depth + 1, gamma)) return true;
+        }
+        return false;
+    }
+};
+
+SymmetryGroup find_symmetries(const PetriNet& pn, size_t max_elements, size_t search_budget) {
+    CompiledNet net = compile_net(pn);
+    NetGraph g = build_graph(net);
+    SymmetryGroup res;
+    res.n_places = net.n_places;
+
+    Searcher s{g, search_budget, {}, {}};
+
+    // --- STEP 1: First path (individualize the first vertex of the target cell) ---
+    vector<Partition> path;
+    vector<int> chosen;
+    Partition P = initial_partition(g);
+    vector<int> all_cells;
+    for(int st = 0; st < g.n; st = P.end[st]) all_cells.push_back(st);
+    refine(g, P, all_cells);
+    while(true){
+        path.push_back(P);
+        s.path_sizes.push_back(cell_sizes(P));
+        int cell = target_cell(P);
+        if(cell < 0) break;
+        chosen.push_back(P.elems[cell]);
+        P = individualize(g, P, chosen.back());
+    }
+    s.leaf_vertex = P.elems;
+
+    // --- STEP 2: Generators, deepest level first ---
+    // Generators found so far fix chosen[0..k-1], so at level k a vertex in
+    // the orbit of chosen[k] needs no search; the orbit size of chosen[k] is
+    // the index of the next stabilizer in the chain.
+    vector<vector<int>> full_generators;
+    UnionFind orbits(g.n);
+    for(int k = (int)chosen.size() - 1; k >= 0; --k){
+        int v = chosen[k];
+        const Partition& Pk = path[k];
+        int cell = Pk.start[v];
+        vector<int> members(Pk.elems.begin() + cell, Pk.elems.begin() + Pk.end[cell]);
+        for(int w : members){
+            if(orbits.find(w) == orbits.find(v)) continue;
+            if(s.budget == 0){ res.complete = false; break; }
+            s.budget--;
+            vector<int> gamma;
+            if(s.find_leaf(individualize(g, Pk, w), k + 1, gamma)){
+                full_generators.push_back(gamma);
+                for(int x = 0; x < g.n; ++x) orbits.unite(x, gamma[x]);
+            }
+            else if(s.budget == 0) res.complete = false;
+        }
+        int orbit = 0;
+        for(int w : members) if(orbits.find(w) == orbits.find(v)) orbit++;
+        res.order *= orbit;
+    }
+
+    // --- STEP 3: Place action ---
+    set<vector<int>> seen;
+    for(const auto& gamma : full_generators){
+        vector<int> p(gamma.begin(), gamma.begin() + net.n_places);
+        bool identity = true;
+        for(int i = 0; i < net.n_places; ++i) if(p[i] != i) identity = false;
+        if(!identity && seen.insert(p).second) res.generators.push_back(p);
+    }
+
+    // Enumerate the place permutations if the group is small enough
+    if(res.complete && res.order <= (double)max_elements){
+        vector<int> id(net.n_places);
+        iota(id.begin(), id.end(), 0);
+        set<vector<int>> all = {id};
+        vector<vector<int>> frontier = {id};
+        while(!frontier.empty()){
+            vector<vector<int>> next;
+            for(const auto& e : frontier){
+                for(const auto& gen : res.generators){
+                    vector<int> prod(net.n_places);
+                    for(int i = 0; i < net.n_places; ++i) prod[i] = gen[e[i]];
+                    if(all.insert(prod).second) next.push_back(prod);
+                }
+            }
+            frontier.swap(next);
+        }
+        res.elements.assign(all.begin(), all.end());
+    }
+    return res;
+}
+
+static Marking apply_perm(const vector<int>& perm, const Marking& M) {
+    Marking out(M.size());
+    for(size_t p = 0; p < M.size(); ++p) out[perm[p]] = M[p];
+    return out;
+}
+
+Marking canonicalize(const SymmetryGroup& g, const Marking& M) {
+    if(g.generators.empty()) return M;
+    if(!g.elements.empty()){
+        Marking best = M;
+        for(const auto& e : g.elements){
+            Marking img = apply_perm(e, M);
+            if(img < best) best = img;
+        }
+        return best;
+    }
+    // greedy descent: follow any generator that makes the marking smaller
+    Marking best = M;
+    bool improved = true;
+    while(improved){
+        improved = false;
+        for(const auto& gen : g.generators){
+            Marking img = apply_perm(gen, best);
+            if(img < best){ best = img; improved = true; }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,48 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "PetriNet.h"
+#include "StateStore.h"
+#include <cstddef>
+#include <vector>
+
+// Automorphisms of the place/transition graph (arcs and weights preserved).
+// A permutation g acts on markings by (gM)[g[p]] = M[p]; M and gM have
+// isomorphic futures, so the explorers only need one marking per orbit.
+struct SymmetryGroup {
+    int n_places = 0;
+    std::vector<std::vector<int>> generators; // place permutations
+    double order = 1;                         // group order (a lower bound if !complete)
+    bool complete = true;                     // false if the search budget ran out
+
+    // Every group element, when order <= max_elements; canonical forms are
+    // then exact orbit minima. Otherwise canonicalize() descends greedily
+    // through the generators: still sound, but may keep several markings per orbit.
+    std::vector<std::vector<int>> elements;
+};
+
+// Partition refinement plus individualization search (nauty-style, first-path
+// leaf with orbit pruning). search_budget caps the number of refinements.
+SymmetryGroup find_symmetries(const PetriNet& pn, size_t max_elements = 10000,
+                              size_t search_budget = 100000);
+
+// Representative of M's orbit (lexicographically smallest found)
+Marking canonicalize(const SymmetryGroup& g, const Marking& M);
+
+// Canonicalizes every marking before it reaches the wrapped store, so
+// bfs_reachable / dfs_reachable store one marking per orbit
+class SymmetricStore : public StateStore {
+public:
+    SymmetricStore(const SymmetryGroup& g, StateStore& inner) : group(g), inner(inner) {}
+
+    bool insert(const Marking& M) override { return inner.insert(canonicalize(group, M)); }
+    uint64_t size() const override { return inner.size(); }
+    size_t memory_bytes() const override { return inner.memory_bytes(); }
+    double omission_probability() const override { return inner.omission_probability(); }
+
+private:
+    const SymmetryGroup& group;
+    StateStore& inner;
+};
+
+#endif // SYMMETRY_H
@@ -0,0 +1,300 @@
+#include "Unfolding.h"
+#include "CompiledNet.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <stdexcept>
+using namespace std;
+
+// --- Growable bitsets ---
+
+using Bits = vector<uint64_t>;
+
+static inline void bits_set(Bits& b, size_t i) {
+    if((i >> 6) >= b.size()) b.resize((i >> 6) + 1, 0);
+    b[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+static inline void bits_and(Bits& a, const Bits& b) {
+    if(a.size() > b.size()) a.resize(b.size());
+    for(size_t w = 0; w < a.size(); ++w) a[w] &= b[w];
+}
+
+static inline void bits_or(Bits& a, const Bits& b) {
+    if(a.size() < b.size()) a.resize(b.size(), 0);
+    for(size_t w = 0; w < b.size(); ++w) a[w] |= b[w];
+}
+
+template<class F>
+static inline void bits_for_each(const Bits& b, F f) {
+    for(size_t w = 0; w < b.size(); ++w){
+        for(uint64_t x = b[w]; x; x &= x - 1) f((int)(w * 64 + __builtin_ctzll(x)));
+    }
+}
+
+// --- ERV order ---
+
+// Parikh vectors as sorted transition lists: the first transition whose
+// count differs decides, fewer occurrences first
+static int compare_parikh(const vector<int>& a, const vector<int>& b) {
+    size_t i = 0, j = 0;
+    while(i < a.size() || j < b.size()){
+        int t = (j >= b.size() || (i < a.size() && a[i] < b[j])) ? a[i] : b[j];
+        size_t ca = 0, cb = 0;
+        while(i < a.size() && a[i] == t){ ++i; ++ca; }
+        while(j < b.size() && b[j] == t){ ++j; ++cb; }
+        if(ca != cb) return ca < cb ? -1 : 1;
+    }
+    return 0;
+}
+
+// A possible extension with its local configuration summarised for the order
+struct Extension {
+    int trans;
+    vector<int> preset;
+    Bits config;                   // events of the local configuration, itself excluded
+    int depth;                     // Foata level of the event itself
+    size_t size;                   // |[e]|
+    vector<int> parikh;            // sorted transitions of [e]
+    vector<vector<int>> foata;     // [level] sorted transitions
+};
+
+static int compare_erv(const Extension& a, const Extension& b) {
+    if(a.size != b.size) return a.size < b.size ? -1 : 1;
+    int c = compare_parikh(a.parikh, b.parikh);
+    if(c) return c;
+    for(size_t l = 0; l < min(a.foata.size(), b.foata.size()); ++l){
+        c = compare_parikh(a.foata[l], b.foata[l]);
+        if(c) return c;
+    }
+    if(a.foata.size() != b.foata.size()) return a.foata.size() < b.foata.size() ? -1 : 1;
+    // isomorphic configurations of different events: keep the order total
+    if(a.trans != b.trans) return a.trans < b.trans ? -1 : 1;
+    return a.preset < b.preset ? -1 : (a.preset == b.preset ? 0 : 1);
+}
+
+// --- Construction ---
+
+UnfoldingPrefix unfold(const PetriNet& pn, uint64_t max_events) {
+    CompiledNet net = compile_net(pn);
+
+    // pre- and post-sets; unit weights only
+    vector<vector<int>> pre(net.n_trans), post(net.n_trans);
+    vector<vector<int>> consumers(net.n_places);
+    for(int t = 0; t < net.n_trans; ++t){
+        Marking out(net.n_places, 0);
+        for(const auto& a : net.input[t]){
+            if(a.second != 1) throw invalid_argument("unfold: arc weights must be 1");
+            pre[t].push_back(a.first);
+            consumers[a.first].push_back(t);
+            out[a.first] += 1;
+        }
+        if(pre[t].empty()) throw UnsupportedNet("source transition");
+        for(const auto& d : net.delta[t]) out[d.first] += d.second;
+        for(int p = 0; p < net.n_places; ++p){
+            if(out[p] > 1) throw invalid_argument("unfold: arc weights must be 1");
+            if(out[p] == 1) post[t].push_back(p);
+        }
+    }
+    for(int v : pn.M0) if(v > 1) throw invalid_argument("unfold: the initial marking must be 1-safe");
+
+    UnfoldingPrefix pf;
+    vector<Bits> co;               // [condition] concurrent conditions
+    vector<Bits> at_place(net.n_places); // [place] its conditions
+    Bits usable;                   // conditions not produced by a cut-off event
+    vector<Bits> event_config;     // [event] local configuration, itself included
+    vector<int> event_depth;
+    map<Marking, int> reached;     // marking of a local configuration -> its event
+    reached[pn.M0] = -1;
+
+    vector<Extension> pool;
+    auto greater_erv = [&](int a, int b){ return compare_erv(pool[a], pool[b]) > 0; };
+    priority_queue<int, vector<int>, decltype(greater_erv)> queue(greater_erv);
+
+    auto add_condition = [&](int place, int pre_event){
+        pf.conditions.push_back({place, pre_event});
+        co.emplace_back();
+        return (int)pf.conditions.size() - 1;
+    };
+
+    // Extensions whose preset contains q and no condition of 'fresh' below q
+    auto extensions_through = [&](int q, const vector<int>& fresh){
+        for(int t : consumers[pf.conditions[q].place]){
+            vector<int> chosen = {q};
+            vector<int> places;
+            for(int p : pre[t]) if(p != pf.conditions[q].place) places.push_back(p);
+
+            function<void(size_t, Bits)> choose = [&](size_t k, Bits allowed){
+                if(k == places.size()){
+                    // q must be the smallest fresh condition used, or another q finds it too
+                    for(int c : chosen) if(c < q && find(fresh.begin(), fresh.end(), c) != fresh.end()) return;
+                    Extension x;
+                    x.trans = t;
+                    x.preset = chosen;
+                    sort(x.preset.begin(), x.preset.end());
+                    x.depth = 1;
+                    for(int c : x.preset){
+                        int e = pf.conditions[c].pre_event;
+                        if(e < 0) continue;
+                        bits_or(x.config, event_config[e]);
+                        x.depth = max(x.depth, event_depth[e] + 1);
+                    }
+                    x.foata.assign(x.depth, {});
+                    x.size = 1;
+                    bits_for_each(x.config, [&](int e){
+                        x.size++;
+                        x.parikh.push_back(pf.events[e].trans);
+                        x.foata[event_depth[e] - 1].push_back(pf.events[e].trans);
+                    });
+                    x.parikh.push_back(t);
+                    x.foata[x.depth - 1].push_back(t);
+                    sort(x.parikh.begin(), x.parikh.end());
+                    for(auto& level : x.foata) sort(level.begin(), level.end());
+                    pool.push_back(move(x));
+                    queue.push((int)pool.size() - 1);
+                    pf.extensions++;
+                    return;
+                }
+                Bits cand = at_place[places[k]];
+                bits_and(cand, allowed);
+                bits_for_each(cand, [&](int c){
+                    Bits next = allowed;
+                    bits_and(next, co[c]);
+                    chosen.push_back(c);
+                    choose(k + 1, move(next));
+                    chosen.pop_back();
+                });
+            };
+            Bits allowed = co[q];
+            bits_and(allowed, usable);
+            choose(0, move(allowed));
+        }
+    };
+
+    // --- STEP 1: Initial conditions (pairwise concurrent) ---
+    for(int p = 0; p < net.n_places; ++p){
+        if(pn.M0[p] == 0) continue;
+        int c = add_condition(p, -1);
+        pf.initial.push_back(c);
+        bits_set(at_place[p], c);
+        bits_set(usable, c);
+    }
+    for(int a : pf.initial) for(int b : pf.initial) if(a != b) bits_set(co[a], b);
+    for(int c : pf.initial) extensions_through(c, pf.initial);
+
+    // --- STEP 2: Add extensions in ERV order ---
+    while(!queue.empty()){
+        if(max_events && pf.events.size() >= max_events){ pf.complete = false; break; }
+        int xi = queue.top(); queue.pop();
+        Extension x = move(pool[xi]);
+        pool[xi] = Extension();
+
+        int e = (int)pf.events.size();
+        pf.events.push_back(UnfEvent());
+        pf.events[e].trans = x.trans;
+        pf.events[e].preset = x.preset;
+        bits_set(x.config, e);
+        event_config.push_back(x.config);
+        event_depth.push_back(x.depth);
+
+        // marking of [e]: M0 minus the consumed places plus the produced ones
+        Marking M = pn.M0;
+        bits_for_each(x.config, [&](int f){
+            for(int p : pre[pf.events[f].trans]) M[p]--;
+            for(int p : post[pf.events[f].trans]) M[p]++;
+        });
+        bool cutoff = !reached.emplace(M, e).second;
+        pf.events[e].cutoff = cutoff;
+        if(cutoff) pf.cutoffs++;
+
+        // concurrency of the new conditions: concurrent to what all inputs
+        // were concurrent to, and to each other
+        Bits base = co[x.preset[0]];
+        for(size_t k = 1; k < x.preset.size(); ++k) bits_and(base, co[x.preset[k]]);
+
+        vector<int> fresh;
+        for(int p : post[x.trans]){
+            Bits clash = at_place[p];
+            bits_and(clash, base);
+            for(uint64_t w : clash) if(w) throw runtime_error("unfold: the net is not 1-safe");
+            int c = add_condition(p, e);
+            fresh.push_back(c);
+            bits_set(at_place[p], c);
+            if(!cutoff) bits_set(usable, c);
+        }
+        pf.events[e].postset = fresh;
+        for(int c : fresh){
+            co[c] = base;
+            for(int d : fresh) if(d != c) bits_set(co[c], d);
+        }
+        bits_for_each(base, [&](int b){ for(int c : fresh) bits_set(co[b], c); });
+
+        if(!cutoff) for(int c : fresh) extensions_through(c, fresh);
+    }
+    return pf;
+}
+
+// --- Deadlock search ---
+
+UnfoldingDeadlock find_deadlock(const PetriNet& pn, const UnfoldingPrefix& pf) {
+    size_t n_cond = pf.conditions.size(), n_ev = pf.events.size();
+    vector<vector<int>> consumers(n_cond);
+    for(size_t e = 0; e < n_ev; ++e) for(int c : pf.events[e].preset) consumers[c].push_back((int)e);
+
+    vector<char> in_cut(n_cond, 0), excluded(n_ev, 0), in_config(n_ev, 0);
+    for(int c : pf.initial) in_cut[c] = 1;
+
+    auto enabled = [&](int e){
+        for(int c : pf.events[e].preset) if(!in_cut[c]) return false;
+        return true;
+    };
+    // some event that may still be added consumes an input of e
+    auto can_disable = [&](int e){
+        for(int c : pf.events[e].preset){
+            for(int f : consumers[c]) if(f != e && !excluded[f] && !pf.events[f].cutoff) return true;
+        }
+        return false;
+    };
+
+    UnfoldingDeadlock result;
+    function<bool()> search = [&]() -> bool {
+        int pick = -1;
+        for(size_t e = 0; e < n_ev; ++e){
+            if(!enabled((int)e)) continue;
+            if(excluded[e]){
+                if(!can_disable((int)e)) return false;
+                continue;
+            }
+            if(pick < 0) pick = (int)e;
+        }
+        if(pick < 0){
+            for(size_t e = 0; e < n_ev; ++e) if(excluded[e] && enabled((int)e)) return false;
+            return true;
+        }
+
+        const UnfEvent& ev = pf.events[pick];
+        if(!ev.cutoff){
+            for(int c : ev.preset) in_cut[c] = 0;
+            for(int c : ev.postset) in_cut[c] = 1;
+            in_config[pick] = 1;
+            if(search()) return true;
+            in_config[pick] = 0;
+            for(int c : ev.postset) in_cut[c] = 0;
+            for(int c : ev.preset) in_cut[c] = 1;
+        }
+        excluded[pick] = 1;
+        if(can_disable(pick) && search()) return true;
+        excluded[pick] = 0;
+        return false;
+    };
+
+    if(!search()) return result;
+
+    // events were created after their causes, so id order is a firing order
+    result.found = true;
+    result.marking.assign(pn.M0.size(), 0);
+    for(size_t e = 0; e < n_ev; ++e) if(in_config[e]) result.trace.push_back(pf.events[e].trans);
+    for(size_t c = 0; c < n_cond; ++c) if(in_cut[c]) result.marking[pf.conditions[c].place] = 1;
+    return result;
+}
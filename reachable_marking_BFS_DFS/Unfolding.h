@@ -0,0 +1,62 @@
+#ifndef UNFOLDING_H
+#define UNFOLDING_H
+
+#include "PetriNet.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Branching process of a 1-safe net: conditions are place instances,
+// events are transition occurrences.
+struct UnfCondition {
+    int place;
+    int pre_event = -1;             // -1 for the initial conditions
+};
+
+struct UnfEvent {
+    int trans;
+    std::vector<int> preset;        // conditions consumed
+    std::vector<int> postset;       // conditions produced
+    bool cutoff = false;            // its marking was already reached by a smaller configuration
+};
+
+struct UnfoldingPrefix {
+    std::vector<UnfCondition> conditions;
+    std::vector<UnfEvent> events;   // in increasing adequate order, so causes come first
+    std::vector<int> initial;       // conditions of M0
+    uint64_t cutoffs = 0;
+    uint64_t extensions = 0;        // possible extensions generated
+    bool complete = true;           // false if max_events stopped the construction
+};
+
+// Complete finite prefix (Esparza-Roemer-Vogler): possible extensions are
+// taken in the ERV total adequate order (size of the local configuration,
+// then Parikh vector, then Foata normal form), and an event is a cut-off when
+// a smaller local configuration already reached its marking. The
+// concurrency relation between conditions is kept as bitsets; new extensions
+// only search co-sets through the newest conditions.
+// The net must be 1-safe with unit arc weights: invalid_argument for
+// weights or an initial marking above 1, runtime_error when two concurrent
+// conditions share a place. Source transitions (empty preset) are not
+// supported either: such an event would have no cause in the prefix.
+UnfoldingPrefix unfold(const PetriNet& pn, uint64_t max_events = 0);
+
+// Thrown by unfold for a valid net outside the supported class; what() names
+// the reason ("source transition")
+struct UnsupportedNet : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+struct UnfoldingDeadlock {
+    bool found = false;
+    std::vector<int> trace;         // firing sequence from M0
+    Marking marking;
+};
+
+// Deadlock check on a complete prefix: a configuration without cut-off
+// events that no event of the prefix extends. Branch and bound over the
+// enabled events (each is either added or excluded; an excluded event must
+// lose one of its input conditions before the search may stop).
+UnfoldingDeadlock find_deadlock(const PetriNet& pn, const UnfoldingPrefix& prefix);
+
+#endif // UNFOLDING_H
@@ -3,7 +3,28 @@
 #include <set>
 #include "PetriNet.h"
 #include "BFS.h"
+#include "CompiledNet.h"
 #include "DFS.h"
+#include "ReachabilityGraph.h"
+#include "Liveness.h"
+#include "ExternalBFS.h"
+#include "StateStore.h"
+#include "Symmetry.h"
+#include "Sweepline.h"
+#include "Checkpoint.h"
+#include "Distributed.h"
+#include "Swarm.h"
+#include "Simulation.h"
+#include "Bounded.h"
+#include "Coverability.h"
+#include "Unfolding.h"
+#include "KernelBench.h"
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 using namespace std;
 void printMarking(const Marking& m) {
     cout << "(";
@@ -129,6 +150,698 @@ void test_DFS_3() {
     assertEqual(dfs_reachable(pn), expected, "DFS Test 3");
 }
 
+// ===============================
+// REACHABILITY GRAPH TESTS
+// ===============================
+
+void assertTrue(bool ok, const string& testName) {
+    cout << (ok ? "[PASS] " : "[FAIL] ") << testName << "\n";
+}
+
+// Cycle p0 -> p1 -> p2 -> p0: 3 states, one edge each
+void test_Graph_1() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1}},
+        {{0,1,0},{0,0,1},{1,0,0}}
+    );
+
+    ReachabilityGraph g = build_reachability_graph(pn);
+    MarkingSet states(g.states.begin(), g.states.end());
+
+    bool ok = g.states.size() == 3 && g.targets.size() == 3 && states == bfs_reachable(pn);
+    for (size_t s = 0; ok && s < g.states.size(); ++s) {
+        ok = g.offsets[s + 1] - g.offsets[s] == 1;
+    }
+    ok = ok && g.states[0] == pn.M0 && deadlock_states(g.view()).empty();
+    assertTrue(ok, "Graph Test 1");
+}
+
+// Write + mmap back: same CSR arrays and markings
+void test_Graph_2() {
+    // t0: p0 -> p2, t1: p1 -> (nothing), t2: p2 -> p0
+    PetriNet pn(
+        {1,1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1},{0,0,0}},
+        {{0,0,1},{0,0,0},{1,0,0},{0,0,0}}
+    );
+
+    ReachabilityGraph g = build_reachability_graph(pn);
+    const string path = "graph_test.rgcsr";
+    bool ok = write_reachability_graph(g, path);
+
+    MappedGraph mg;
+    ok = ok && mg.open(path);
+    if (ok) {
+        CsrView a = g.view(), b = mg.view();
+        ok = a.n_states == b.n_states && a.n_edges == b.n_edges;
+        for (uint64_t s = 0; ok && s <= a.n_states; ++s) ok = a.offsets[s] == b.offsets[s];
+        for (uint64_t e = 0; ok && e < a.n_edges; ++e) ok = a.targets[e] == b.targets[e] && a.labels[e] == b.labels[e];
+        for (uint64_t s = 0; ok && s < a.n_states; ++s) ok = mg.marking(s) == g.states[s];
+        ok = ok && deadlock_states(a) == deadlock_states(b);
+    }
+    mg.close();
+    remove(path.c_str());
+    assertTrue(ok && g.states.size() == 4, "Graph Test 2");
+}
+
+// Damaged graph files are rejected instead of mapped
+void test_Graph_3() {
+    PetriNet pn(
+        {1,0},
+        {{1,0},{0,1}},
+        {{0,1},{1,0}}
+    );
+    ReachabilityGraph g = build_reachability_graph(pn);
+    const string path = "graph_test.rgcsr";
+    write_reachability_graph(g, path);
+    vector<char> bytes;
+    {
+        ifstream in(path, ios::binary);
+        bytes.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    auto opens = [&](const vector<char>& content) {
+        ofstream(path, ios::binary | ios::trunc).write(content.data(), content.size());
+        MappedGraph mg;
+        return mg.open(path);
+    };
+    auto with_u64 = [&](size_t pos, uint64_t v) {
+        vector<char> b = bytes;
+        memcpy(b.data() + pos, &v, sizeof(v));
+        return b;
+    };
+
+    bool ok = opens(bytes);
+    ok = ok && !opens(vector<char>(bytes.begin(), bytes.begin() + 20));   // shorter than the header
+    ok = ok && !opens(vector<char>(bytes.begin(), bytes.end() - 8));      // markings cut off
+    vector<char> zero_bits = bytes;
+    memset(zero_bits.data() + 32, 0, 4);                                  // bits_per_place = 0
+    ok = ok && !opens(zero_bits);
+    ok = ok && !opens(with_u64(8, UINT64_MAX / 4));                       // n_states overflows the sizes
+    ok = ok && !opens(with_u64(16, uint64_t(1) << 61));                   // n_edges past the end
+    ok = ok && !opens(with_u64(40, UINT64_MAX - 7));                      // markings_pos overflows
+    // body: offsets (2 states + 1) at 48, then targets and labels (2 edges each)
+    ok = ok && !opens(with_u64(48 + 8, 3));                               // offsets fall back to 2
+    auto with_u32 = [&](size_t pos, uint32_t v) {
+        vector<char> b = bytes;
+        memcpy(b.data() + pos, &v, sizeof(v));
+        return b;
+    };
+    ok = ok && !opens(with_u32(48 + 24, 2));                              // target past the last state
+    ok = ok && !opens(with_u32(48 + 24 + 8 + 4, 7));                      // label of an unknown transition
+    remove(path.c_str());
+    assertTrue(ok, "Graph Test 3");
+}
+
+// ===============================
+// LIVENESS TESTS
+// ===============================
+
+// Cycle p0 -> p1 -> p2 -> p0: one terminal SCC, every transition live, reversible
+void test_Liveness_1() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1}},
+        {{0,1,0},{0,0,1},{1,0,0}}
+    );
+
+    ReachabilityGraph g = build_reachability_graph(pn);
+    LivenessResult r = analyze_liveness(g.view(), 3);
+
+    bool ok = r.n_sccs == 1 && r.terminal_sccs.size() == 1 && r.deadlocks == 0;
+    ok = ok && r.live == vector<bool>({true, true, true});
+    ok = ok && r.home_states.size() == 3 && r.reversible;
+    assertTrue(ok, "Liveness Test 1");
+}
+
+// t0: p0 -> p1, t1: p0 -> p2 (two deadlocks), and a 1M-state line graph
+// to make sure deep graphs do not exhaust the call stack
+void test_Liveness_2() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,1},{0,0},{0,0}},
+        {{0,0},{1,0},{0,1}}
+    );
+
+    ReachabilityGraph g = build_reachability_graph(pn);
+    LivenessResult r = analyze_liveness(g.view(), 2);
+
+    bool ok = r.n_sccs == 3 && r.terminal_sccs.size() == 2 && r.deadlocks == 2;
+    ok = ok && r.live == vector<bool>({false, false});
+    ok = ok && r.home_states.empty() && !r.reversible;
+
+    // 0 -> 1 -> ... -> n-1 -> 0
+    const uint32_t n = 1000000;
+    vector<uint64_t> offsets(n + 1);
+    vector<uint32_t> targets(n), labels(n, 0);
+    for (uint32_t s = 0; s <= n; ++s) offsets[s] = s;
+    for (uint32_t s = 0; s < n; ++s) targets[s] = (s + 1) % n;
+    CsrView line{n, n, offsets.data(), targets.data(), labels.data()};
+
+    LivenessResult big = analyze_liveness(line, 1);
+    ok = ok && big.n_sccs == 1 && big.live[0] && big.home_states.size() == n;
+
+    targets[n - 1] = n - 1; // drop the back edge: only the last state is home
+    big = analyze_liveness(line, 1);
+    ok = ok && big.n_sccs == n && big.home_states == vector<uint64_t>({n - 1}) && big.live[0];
+    assertTrue(ok, "Liveness Test 2");
+}
+
+// ===============================
+// EXTERNAL BFS TESTS
+// ===============================
+
+// k independent toggles p_i <-> q_i: 2^k states
+PetriNet toggles_net(int k) {
+    vector<vector<int>> I(2 * k, vector<int>(2 * k, 0)), O = I;
+    Marking M0(2 * k, 0);
+    for (int i = 0; i < k; ++i) {
+        M0[2 * i] = 1;
+        I[2 * i][2 * i] = 1;     O[2 * i + 1][2 * i] = 1;
+        I[2 * i + 1][2 * i + 1] = 1; O[2 * i][2 * i + 1] = 1;
+    }
+    return PetriNet(M0, I, O);
+}
+
+// Same net as BFS Test 1, with the default options
+void test_ExternalBFS_1() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1}},
+        {{0,1,0},{0,0,1},{1,0,0}}
+    );
+
+    MarkingSet out;
+    ExternalBfsStats st = external_bfs(pn, ExternalBfsOptions(), [&](const Marking& M){ out.insert(M); });
+    assertTrue(out == bfs_reachable(pn) && st.states == 3 && st.levels == 3, "External BFS Test 1");
+}
+
+// 8 independent toggles (256 states) with a tiny buffer and fan-in, so that
+// every level is split into many runs and merged in several passes
+void test_ExternalBFS_2() {
+    const int k = 8;
+    PetriNet pn = toggles_net(k);
+
+    ExternalBfsOptions opt;
+    opt.file_prefix = "ebfs_test";
+    opt.memory_bytes = 10 * 12;
+    opt.merge_fan_in = 3;
+    opt.output_path = "ebfs_test.states";
+
+    MarkingSet out;
+    uint64_t calls = 0;
+    ExternalBfsStats st = external_bfs(pn, opt, [&](const Marking& M){ out.insert(M); calls++; });
+
+    FILE* f = fopen(opt.output_path.c_str(), "rb");
+    long size = -1;
+    if (f) { fseek(f, 0, SEEK_END); size = ftell(f); fclose(f); }
+    remove(opt.output_path.c_str());
+
+    bool ok = out == bfs_reachable(pn) && calls == 256 && st.states == 256;
+    ok = ok && st.levels == k + 1 && st.runs_written > 2 * (uint64_t)k && size == 256 * 8;
+    assertTrue(ok, "External BFS Test 2");
+}
+
+// An exception in the middle of a level leaves no temporary file behind
+void test_ExternalBFS_3() {
+    PetriNet pn = toggles_net(6);
+
+    ExternalBfsOptions opt;
+    opt.file_prefix = "ebfs_abort";
+    opt.memory_bytes = 10 * 12;
+    opt.merge_fan_in = 3;
+
+    int calls = 0;
+    bool thrown = false;
+    try {
+        external_bfs(pn, opt, [&](const Marking&){ if (++calls == 20) throw runtime_error("stop"); });
+    } catch (const runtime_error&) {
+        thrown = true;
+    }
+
+    bool left = false;
+    for (int i = 0; i < 1000 && !left; ++i) {
+        FILE* f = fopen(("./ebfs_abort_" + to_string(i) + ".tmp").c_str(), "rb");
+        if (f) { left = true; fclose(f); }
+    }
+    assertTrue(thrown && !left, "External BFS Test 3");
+}
+
+// ===============================
+// STATE STORE TESTS
+// ===============================
+
+// Hash compaction and a roomy bitstate table find every state
+void test_Store_1() {
+    PetriNet pn = toggles_net(10);
+
+    HashCompactionStore hc;
+    ExplorationStats a = bfs_reachable(pn, hc);
+    auto bits = make_state_store(StoreMode::Bitstate, 1 << 16);
+    ExplorationStats b = dfs_reachable(pn, *bits);
+    ExactStore exact;
+    ExplorationStats c = bfs_reachable(pn, exact);
+
+    bool ok = a.states == 1024 && a.edges == 1024 * 10 && a.omission_probability < 1e-12;
+    ok = ok && hc.memory_bytes() <= 16 * a.states; // 8-byte slots, at least half full
+    ok = ok && b.states == 1024 && b.omission_probability < 1e-3 && b.omission_probability > 0;
+    ok = ok && c.states == 1024 && c.omission_probability == 0 && exact.markings() == dfs_reachable(pn);
+    assertTrue(ok, "Store Test 1");
+}
+
+// A 64-bit bitstate table cannot hold 1024 states: some are omitted,
+// and the estimate says so
+void test_Store_2() {
+    PetriNet pn = toggles_net(10);
+    BitstateStore tiny(8, 2);
+    ExplorationStats s = bfs_reachable(pn, tiny);
+    assertTrue(s.states < 1024 && s.omission_probability > 0.99, "Store Test 2");
+}
+
+// Tree compression: exact, decodable, smaller than plain markings, and
+// safe to fill from several threads at once
+void test_Store_3() {
+    PetriNet pn = toggles_net(10);
+    TreeStore tree(20, 1 << 20);
+    ExplorationStats s = bfs_reachable(pn, tree);
+    bool ok = s.states == 1024 && tree.compression_ratio() > 2;
+
+    MarkingSet all = bfs_reachable(pn);
+    vector<Marking> states(all.begin(), all.end());
+    TreeStore shared(20, 1 << 20);
+    atomic<int> fresh(0), decoded(0);
+    vector<thread> workers;
+    for (int w = 0; w < 4; ++w) {
+        workers.emplace_back([&, w]() {
+            for (size_t i = 0; i < states.size(); ++i) {
+                const Marking& M = states[(i + w * 256) % states.size()];
+                bool is_new;
+                uint32_t root = shared.insert_id(M, is_new);
+                if (is_new) fresh++;
+                if (shared.get(root) == M) decoded++;
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    ok = ok && fresh == 1024 && decoded == 4 * 1024 && shared.size() == 1024;
+    assertTrue(ok, "Store Test 3");
+}
+
+// ===============================
+// SYMMETRY TESTS
+// ===============================
+
+// 4 toggles: any pair can be swapped and each toggle flipped (order 4! * 2^4),
+// so all 16 markings are one orbit
+void test_Symmetry_1() {
+    PetriNet pn = toggles_net(4);
+    SymmetryGroup g = find_symmetries(pn);
+
+    ExactStore orbits;
+    SymmetricStore store(g, orbits);
+    ExplorationStats s = bfs_reachable(pn, store);
+
+    bool ok = g.complete && g.order == 384 && g.elements.size() == 384;
+    ok = ok && s.states == 1 && canonicalize(g, {0,1,1,0,0,1,1,0}) == canonicalize(g, pn.M0);
+    assertTrue(ok, "Symmetry Test 1");
+}
+
+// Rotations of a 3-cycle: one orbit. A chain p0 -> p1 -> p2 has no symmetry.
+void test_Symmetry_2() {
+    PetriNet ring(
+        {1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1}},
+        {{0,1,0},{0,0,1},{1,0,0}}
+    );
+    SymmetryGroup g = find_symmetries(ring);
+    ExactStore orbits;
+    SymmetricStore store(g, orbits);
+    bool ok = g.order == 3 && bfs_reachable(ring, store).states == 1;
+
+    PetriNet chain(
+        {1,0,0},
+        {{1,0},{0,1},{0,0}},
+        {{0,0},{1,0},{0,1}}
+    );
+    SymmetryGroup h = find_symmetries(chain);
+    ExactStore all;
+    SymmetricStore plain(h, all);
+    ok = ok && h.order == 1 && h.generators.empty() && dfs_reachable(chain, plain).states == 3;
+
+    // Greedy canonicalization (no element list): the 16 markings form one
+    // orbit of the order-384 group, but descending along the generators
+    // stops in two local minima, 01010101 and 01010110
+    SymmetryGroup big = find_symmetries(toggles_net(4), 10);
+    ExactStore some;
+    SymmetricStore greedy(big, some);
+    ExplorationStats s = bfs_reachable(toggles_net(4), greedy);
+    set<Marking> forms;
+    for (const Marking& M : bfs_reachable(toggles_net(4))) forms.insert(canonicalize(big, M));
+    ok = ok && big.elements.empty() && big.order == 384;
+    ok = ok && forms == set<Marking>({{0,1,0,1,0,1,0,1}, {0,1,0,1,0,1,1,0}}) && s.states == 2;
+    assertTrue(ok, "Symmetry Test 2");
+}
+
+// ===============================
+// SWEEP-LINE TESTS
+// ===============================
+
+// Chain p0 -> p1 -> ... -> p49 with one token: the derived measure is
+// monotone, so each state is explored once and almost nothing is kept
+void test_Sweep_1() {
+    const int n = 50;
+    vector<vector<int>> I(n, vector<int>(n - 1, 0)), O = I;
+    for (int t = 0; t + 1 < n; ++t) { I[t][t] = 1; O[t + 1][t] = 1; }
+    Marking M0(n, 0);
+    M0[0] = 1;
+    PetriNet pn(M0, I, O);
+
+    ProgressMeasure pm = derive_progress_measure(pn);
+    MarkingSet seen;
+    SweepStats s = sweep_line(pn, pm, [&](const Marking& M){ seen.insert(M); });
+
+    bool ok = s.exact && s.sweeps == 1 && s.states_explored == n && s.deadlocks == 1;
+    // the current layer, the next one and its queued copy, and M0
+    ok = ok && s.peak_stored <= 4 && seen == bfs_reachable(pn);
+    assertTrue(ok, "Sweep Test 1");
+}
+
+// 3-cycle with a user weighting: the closing transition regresses, its
+// target becomes persistent, and every state is still found
+void test_Sweep_2() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1}},
+        {{0,1,0},{0,0,1},{1,0,0}}
+    );
+
+    ProgressMeasure pm{{0, 1, 2}};
+    MarkingSet seen;
+    SweepStats s = sweep_line(pn, pm, [&](const Marking& M){ seen.insert(M); });
+
+    bool ok = !s.exact && s.regress_edges >= 1 && seen == bfs_reachable(pn);
+    ok = ok && derive_progress_measure(pn).weight == vector<long long>({0, 0, 0});
+    assertTrue(ok, "Sweep Test 2");
+}
+
+// The regress edge c -> e restarts the sweep at e, which reaches the dead
+// place d a second time: d is explored, and counted, in both sweeps
+void test_Sweep_3() {
+    // places a b c d e; t0: a->b, t1: b->d, t2: b->c, t3: c->e, t4: e->b
+    PetriNet pn(
+        {1,0,0,0,0},
+        {{1,0,0,0,0},{0,1,1,0,0},{0,0,0,1,0},{0,0,0,0,0},{0,0,0,0,1}},
+        {{0,0,0,0,0},{1,0,0,0,1},{0,0,1,0,0},{0,1,0,0,0},{0,0,0,1,0}}
+    );
+
+    ProgressMeasure pm{{0, 1, 3, 2, 0}};
+    MarkingSet seen;
+    SweepStats s = sweep_line(pn, pm, [&](const Marking& M){ seen.insert(M); });
+
+    bool ok = s.sweeps == 2 && s.regress_edges == 2 && s.persistent == 1;
+    ok = ok && s.states_explored == 5 + 3 && s.deadlocks == 2 && seen == bfs_reachable(pn);
+    assertTrue(ok, "Sweep Test 3");
+}
+
+// ===============================
+// CHECKPOINT TESTS
+// ===============================
+
+// Stop after 100 expansions, resume from the checkpoint, and end with the
+// same result as an uninterrupted run
+void test_Checkpoint_1() {
+    PetriNet pn = toggles_net(10);
+    CheckpointOptions opt;
+    opt.path = "checkpoint_test";
+    opt.interval_seconds = 0;
+    opt.max_expansions = 100;
+
+    CheckpointedStats first = bfs_checkpointed(pn, opt);
+    opt.resume = true;
+    opt.max_expansions = 0;
+    CheckpointedStats second = bfs_checkpointed(pn, opt);
+    CheckpointedStats again = bfs_checkpointed(pn, opt); // already complete: nothing to do
+
+    bool ok = !first.complete && first.expanded == 100 && first.checkpoints >= 100;
+    ok = ok && second.resumed && second.complete && second.states == 1024 && second.expanded == 1024;
+    ok = ok && second.edges == 1024 * 10 && second.deadlocks == 0;
+    ok = ok && again.complete && again.states == 1024 && again.checkpoints == 1;
+
+    // a checkpoint of another net is refused
+    bool refused = false;
+    try { bfs_checkpointed(toggles_net(9), opt); } catch (const exception&) { refused = true; }
+
+    remove("checkpoint_test.states");
+    remove("checkpoint_test.ckpt");
+    assertTrue(ok && refused, "Checkpoint Test 1");
+}
+
+// ===============================
+// DISTRIBUTED TESTS
+// ===============================
+
+// 4 worker processes over localhost, small batches: same states as BFS,
+// spread over every worker
+void test_Distributed_1() {
+    PetriNet pn = toggles_net(10);
+    DistributedOptions opt;
+    opt.workers = 4;
+    opt.batch_states = 16;
+    DistributedStats s = distributed_reachable(pn, opt);
+
+    bool ok = s.states == 1024 && s.edges == 1024 * 10 && s.deadlocks == 0 && s.batches_sent > 0;
+    ok = ok && s.states_per_worker.size() == 4;
+    for (uint64_t c : s.states_per_worker) ok = ok && c > 0;
+
+    opt.workers = 1;
+    DistributedStats single = distributed_reachable(pn, opt);
+    ok = ok && single.states == 1024 && single.batches_sent == 0;
+    assertTrue(ok, "Distributed Test 1");
+}
+
+// ===============================
+// SWARM TESTS
+// ===============================
+
+// 10 toggles plus a trap transition that empties the net once every toggle
+// is off: one deadlock, 11 firings deep. The trace must replay to it.
+void test_Swarm_1() {
+    const int k = 10;
+    vector<vector<int>> I(2 * k, vector<int>(2 * k + 1, 0)), O = I;
+    Marking M0(2 * k, 0);
+    for (int i = 0; i < k; ++i) {
+        M0[2 * i] = 1;
+        I[2 * i][2 * i] = 1;     O[2 * i + 1][2 * i] = 1;
+        I[2 * i + 1][2 * i + 1] = 1; O[2 * i][2 * i + 1] = 1;
+        I[2 * i + 1][2 * k] = 1;
+    }
+    PetriNet pn(M0, I, O);
+
+    SwarmOptions opt;
+    opt.workers = 4;
+    opt.memory_bytes = 1 << 20;
+    SwarmResult r = swarm_deadlock_search(pn, opt);
+
+    CompiledNet net = compile_net(pn);
+    Marking M = pn.M0;
+    bool ok = r.found && r.worker >= 0 && r.worker < 4;
+    for (int t : r.trace) {
+        ok = ok && is_enabled(net, M, t);
+        if (ok) M = fire(net, M, t);
+    }
+    ok = ok && M == r.deadlock && M == Marking(2 * k, 0);
+    assertTrue(ok, "Swarm Test 1");
+}
+
+// No deadlock: every worker runs to completion and covers all 1024 states
+void test_Swarm_2() {
+    SwarmOptions opt;
+    opt.workers = 3;
+    opt.memory_bytes = 3 << 20;
+    SwarmResult r = swarm_deadlock_search(toggles_net(10), opt);
+    bool ok = !r.found && r.trace.empty() && r.workers_finished == 3;
+    ok = ok && r.states == 3 * 1024 && r.omission_probability < 1e-6;
+    assertTrue(ok, "Swarm Test 2");
+}
+
+// ===============================
+// SIMULATION TESTS
+// ===============================
+
+// t0: p0 -> p1, t1: p0 -> p2: every run deadlocks after one firing
+void test_Simulation_1() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,1},{0,0},{0,0}},
+        {{0,0},{1,0},{0,1}}
+    );
+    SimulationOptions opt;
+    opt.runs = 20000;
+    opt.threads = 4;
+    SimulationStats s = simulate(pn, opt);
+
+    bool ok = s.runs == 20000 && s.deadlocked_runs == 20000 && s.deadlock_probability == 1.0;
+    ok = ok && s.mean_deadlock_depth == 1.0 && s.steps == 20000;
+    ok = ok && s.fire_count[0] + s.fire_count[1] == 20000;
+    ok = ok && s.fire_count[0] > 9000 && s.fire_count[1] > 9000;
+    ok = ok && s.mean_tokens[0] == 0.5 && s.mean_tokens[1] + s.mean_tokens[2] == 0.5;
+    assertTrue(ok, "Simulation Test 1");
+}
+
+// 3-cycle: no deadlock, 300 markings per run, one token spread evenly;
+// the same seed and thread count repeat the same runs
+void test_Simulation_2() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,0,0},{0,1,0},{0,0,1}},
+        {{0,1,0},{0,0,1},{1,0,0}}
+    );
+    SimulationOptions opt;
+    opt.runs = 1000;
+    opt.max_steps = 299;
+    opt.threads = 3;
+    SimulationStats a = simulate(pn, opt);
+    SimulationStats b = simulate(pn, opt);
+
+    bool ok = a.deadlocked_runs == 0 && a.steps == 1000 * 299;
+    for (double m : a.mean_tokens) ok = ok && m > 0.3333 && m < 0.3334;
+    ok = ok && a.fire_count == b.fire_count;
+    assertTrue(ok, "Simulation Test 2");
+}
+
+// ===============================
+// K-BOUNDED TESTS
+// ===============================
+
+// k = 1 on a safe net: 2-bit counters, same states as bfs_reachable
+void test_Bounded_1() {
+    PetriNet pn = toggles_net(8);
+    MarkingSet seen;
+    BoundedStats s = bounded_reachable(pn, 1, [&](const Marking& M){ seen.insert(M); });
+    bool ok = s.states == 256 && s.edges == 256 * 8 && s.bits_per_place == 2;
+    ok = ok && s.within_bound() && s.deadlocks == 0 && seen == bfs_reachable(pn);
+    assertTrue(ok, "Bounded Test 1");
+}
+
+// t0: p0 -> p0 + p1 (unbounded producer), t1: 2 p1 -> nothing.
+// The firing above k is reported on p1 for a 2-bit counter at its maximum
+// (carry) and for a 4-bit counter below its maximum (compare against k).
+void test_Bounded_2() {
+    PetriNet pn(
+        {1,0},
+        {{1,0},{0,2}},
+        {{1,0},{1,0}}
+    );
+    MarkingSet seen;
+    BoundedStats a = bounded_reachable(pn, 3, [&](const Marking& M){ seen.insert(M); });
+    bool ok = a.bits_per_place == 2 && a.states == 4 && a.edges == 3 + 2;
+    ok = ok && a.overflow_firings == 1 && a.overflow_places == vector<int>{1};
+    ok = ok && seen == MarkingSet{{1,0},{1,1},{1,2},{1,3}};
+
+    BoundedStats b = bounded_reachable(pn, 5);
+    ok = ok && b.bits_per_place == 4 && b.states == 6 && b.edges == 5 + 4;
+    ok = ok && b.overflow_firings == 1 && b.overflow_places == vector<int>{1} && !b.within_bound();
+    assertTrue(ok, "Bounded Test 2");
+}
+
+// ===============================
+// COVERABILITY TESTS
+// ===============================
+
+// t0: p0 -> p1, t1: p1 -> p0 + p2: p2 grows on every round trip
+void test_Coverability_1() {
+    PetriNet pn(
+        {1,0,0},
+        {{1,0},{0,1},{0,0}},
+        {{0,1},{1,0},{0,1}}
+    );
+    CoverabilityResult r = minimal_coverability_set(pn);
+    vector<Marking> expected = {{0,1,OMEGA},{1,0,OMEGA}};
+    bool ok = !r.bounded && r.unbounded_places == vector<int>{2} && r.basis == expected;
+    ok = ok && r.accelerations > 0 && r.place_bounds == vector<int>({1, 1, OMEGA});
+    ok = ok && is_coverable(r, {0,1,1000}) && !is_coverable(r, {1,1,0});
+    assertTrue(ok, "Coverability Test 1");
+}
+
+// Bounded net: the basis is the set of maximal reachable markings
+void test_Coverability_2() {
+    PetriNet pn = toggles_net(4);
+    CoverabilityResult r = minimal_coverability_set(pn);
+    MarkingSet reach = bfs_reachable(pn);
+    bool ok = r.bounded && r.unbounded_places.empty() && r.accelerations == 0;
+    ok = ok && MarkingSet(r.basis.begin(), r.basis.end()) == reach;
+    assertTrue(ok, "Coverability Test 2");
+}
+
+// ===============================
+// UNFOLDING TESTS
+// ===============================
+
+// 20 independent toggles: 2^20 markings, but the prefix is one p -> q -> p
+// chain per toggle, the second event of each being a cut-off
+void test_Unfolding_1() {
+    const int k = 20;
+    UnfoldingPrefix pf = unfold(toggles_net(k));
+    UnfoldingDeadlock d = find_deadlock(toggles_net(k), pf);
+    bool ok = pf.complete && pf.events.size() == 2 * k && pf.cutoffs == k;
+    ok = ok && pf.conditions.size() == 3 * k && !d.found;
+    assertTrue(ok, "Unfolding Test 1");
+}
+
+// The trap net of Swarm Test 1: the deadlock is found on the prefix and its
+// trace replays to the empty marking
+void test_Unfolding_2() {
+    const int k = 6;
+    vector<vector<int>> I(2 * k, vector<int>(2 * k + 1, 0)), O = I;
+    Marking M0(2 * k, 0);
+    for (int i = 0; i < k; ++i) {
+        M0[2 * i] = 1;
+        I[2 * i][2 * i] = 1;     O[2 * i + 1][2 * i] = 1;
+        I[2 * i + 1][2 * i + 1] = 1; O[2 * i][2 * i + 1] = 1;
+        I[2 * i + 1][2 * k] = 1;
+    }
+    PetriNet pn(M0, I, O);
+    UnfoldingDeadlock d = find_deadlock(pn, unfold(pn));
+
+    CompiledNet net = compile_net(pn);
+    Marking M = pn.M0;
+    bool ok = d.found && d.trace.size() == k + 1;
+    for (int t : d.trace) {
+        ok = ok && is_enabled(net, M, t);
+        if (ok) M = fire(net, M, t);
+    }
+    ok = ok && M == d.marking && M == Marking(2 * k, 0);
+    assertTrue(ok, "Unfolding Test 2");
+}
+
+// A source transition (no input place) is reported as unsupported
+void test_Unfolding_3() {
+    vector<vector<int>> I = {{1, 0}, {0, 0}}, O = {{0, 1}, {1, 0}};
+    PetriNet pn({1, 0}, I, O);
+    bool ok = false;
+    try { unfold(pn); }
+    catch (const UnsupportedNet& e) { ok = string(e.what()) == "source transition"; }
+    assertTrue(ok, "Unfolding Test 3");
+}
+
+// ===============================
+// KERNEL BENCHMARK TESTS
+// ===============================
+
+// 6 toggles: all 64 states sampled, half of the (state, transition) pairs
+// enabled, every kernel timed
+void test_KernelBench_1() {
+    KernelBenchOptions opt;
+    opt.min_seconds = 0.001;
+    KernelBenchResult r = benchmark_kernels(toggles_net(6), opt);
+    bool ok = r.places == 12 && r.transitions == 12 && r.sample == 64 && r.enabled_pairs == 64 * 6;
+    ok = ok && r.kernels.size() == 9;
+    for (const auto& k : r.kernels) ok = ok && k.ops > 0 && k.ns_per_op > 0;
+    ok = ok && r.marking_bytes == sizeof(Marking) + 12 * sizeof(int);
+    ok = ok && r.exact_bytes_per_state > r.marking_bytes && r.hashcompact_bytes_per_state > 0 && r.tree_bytes_per_state > 0;
+    assertTrue(ok, "Kernel Benchmark Test 1");
+}
+
 /* ===============================
             MAIN
    =============================== */
@@ -144,6 +857,64 @@ int main() {
     test_DFS_2();
     test_DFS_3();
 
+    cout << "\n====== Running Graph Tests ======\n";
+    test_Graph_1();
+    test_Graph_2();
+    test_Graph_3();
+
+    cout << "\n====== Running Liveness Tests ======\n";
+    test_Liveness_1();
+    test_Liveness_2();
+
+    cout << "\n====== Running External BFS Tests ======\n";
+    test_ExternalBFS_1();
+    test_ExternalBFS_2();
+    test_ExternalBFS_3();
+
+    cout << "\n====== Running State Store Tests ======\n";
+    test_Store_1();
+    test_Store_2();
+    test_Store_3();
+
+    cout << "\n====== Running Symmetry Tests ======\n";
+    test_Symmetry_1();
+    test_Symmetry_2();
+
+    cout << "\n====== Running Sweep-Line Tests ======\n";
+    test_Sweep_1();
+    test_Sweep_2();
+    test_Sweep_3();
+
+    cout << "\n====== Running Checkpoint Tests ======\n";
+    test_Checkpoint_1();
+
+    cout << "\n====== Running Distributed Tests ======\n";
+    test_Distributed_1();
+
+    cout << "\n====== Running Swarm Tests ======\n";
+    test_Swarm_1();
+    test_Swarm_2();
+
+    cout << "\n====== Running Simulation Tests ======\n";
+    test_Simulation_1();
+    test_Simulation_2();
+
+    cout << "\n====== Running K-Bounded Tests ======\n";
+    test_Bounded_1();
+    test_Bounded_2();
+
+    cout << "\n====== Running Coverability Tests ======\n";
+    test_Coverability_1();
+    test_Coverability_2();
+
+    cout << "\n====== Running Unfolding Tests ======\n";
+    test_Unfolding_1();
+    test_Unfolding_2();
+    test_Unfolding_3();
+
+    cout << "\n====== Running Kernel Benchmark Tests ======\n";
+    test_KernelBench_1();
+
     cout << "\nAll tests completed.\n";
     return 0;
 }